@@ -0,0 +1,151 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* Batches the project saves of the backend. Every change made through
+ * the backend is recorded with e_cal_backend_planner_save_changed(), and
+ * the project file is written once the changes have been quiet for
+ * @delay ms, or right away when @max_changes have piled up, so that a
+ * sync of many objects writes the file once instead of once per object.
+ *
+ * This doesn't depend on evolution-data-server so that it can be tested
+ * on its own.
+ */
+
+#include <config.h>
+#include "e-cal-backend-planner-save.h"
+
+struct _ECalBackendPlannerSave {
+	MrpProject *project;
+
+	guint       delay;
+	guint       max_changes;
+
+	guint       pending;
+	guint       timeout_id;
+
+	guint       n_saves;
+};
+
+ECalBackendPlannerSave *
+e_cal_backend_planner_save_new (MrpProject *project,
+				guint       delay,
+				guint       max_changes)
+{
+	ECalBackendPlannerSave *save;
+
+	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
+
+	save = g_new0 (ECalBackendPlannerSave, 1);
+
+	save->project = g_object_ref (project);
+	save->delay = delay;
+	save->max_changes = MAX (1, max_changes);
+
+	return save;
+}
+
+/* Writes out anything still pending before freeing. */
+void
+e_cal_backend_planner_save_free (ECalBackendPlannerSave *save)
+{
+	g_return_if_fail (save != NULL);
+
+	e_cal_backend_planner_save_flush (save);
+
+	g_object_unref (save->project);
+	g_free (save);
+}
+
+static gboolean
+save_timeout_cb (ECalBackendPlannerSave *save)
+{
+	save->timeout_id = 0;
+
+	e_cal_backend_planner_save_flush (save);
+
+	return FALSE;
+}
+
+/* Records a change. The timeout is restarted on each change, so the file
+ * is written when no change has come in for the delay. The max_changes
+ * limit keeps a steady stream of changes from postponing it forever.
+ */
+void
+e_cal_backend_planner_save_changed (ECalBackendPlannerSave *save)
+{
+	g_return_if_fail (save != NULL);
+
+	save->pending++;
+
+	if (save->timeout_id) {
+		g_source_remove (save->timeout_id);
+		save->timeout_id = 0;
+	}
+
+	if (save->pending >= save->max_changes) {
+		e_cal_backend_planner_save_flush (save);
+	} else {
+		save->timeout_id = g_timeout_add (save->delay,
+						  (GSourceFunc) save_timeout_cb,
+						  save);
+	}
+}
+
+/* Writes out the project if there are unsaved changes. */
+void
+e_cal_backend_planner_save_flush (ECalBackendPlannerSave *save)
+{
+	GError *error = NULL;
+
+	g_return_if_fail (save != NULL);
+
+	if (save->timeout_id) {
+		g_source_remove (save->timeout_id);
+		save->timeout_id = 0;
+	}
+
+	if (save->pending == 0) {
+		return;
+	}
+
+	g_message ("Saving %d changes to the planner project", save->pending);
+	save->pending = 0;
+	save->n_saves++;
+
+	if (!mrp_project_save (save->project, TRUE, &error)) {
+		g_warning ("Problem saving planner project: %s", error->message);
+		g_error_free (error);
+	}
+}
+
+guint
+e_cal_backend_planner_save_get_pending (ECalBackendPlannerSave *save)
+{
+	g_return_val_if_fail (save != NULL, 0);
+
+	return save->pending;
+}
+
+/* The number of times the project has been written, for testing. */
+guint
+e_cal_backend_planner_save_get_n_saves (ECalBackendPlannerSave *save)
+{
+	g_return_val_if_fail (save != NULL, 0);
+
+	return save->n_saves;
+}
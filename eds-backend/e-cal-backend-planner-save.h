@@ -0,0 +1,39 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __E_CAL_BACKEND_PLANNER_SAVE_H__
+#define __E_CAL_BACKEND_PLANNER_SAVE_H__
+
+#include <libplanner/mrp-project.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ECalBackendPlannerSave ECalBackendPlannerSave;
+
+ECalBackendPlannerSave *e_cal_backend_planner_save_new         (MrpProject             *project,
+								guint                   delay,
+								guint                   max_changes);
+void                    e_cal_backend_planner_save_free        (ECalBackendPlannerSave *save);
+void                    e_cal_backend_planner_save_changed     (ECalBackendPlannerSave *save);
+void                    e_cal_backend_planner_save_flush       (ECalBackendPlannerSave *save);
+guint                   e_cal_backend_planner_save_get_pending (ECalBackendPlannerSave *save);
+guint                   e_cal_backend_planner_save_get_n_saves (ECalBackendPlannerSave *save);
+
+G_END_DECLS
+
+#endif /* __E_CAL_BACKEND_PLANNER_SAVE_H__ */
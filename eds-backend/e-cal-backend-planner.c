@@ -26,6 +26,7 @@
 #include <string.h>
 #include <libedataserver/e-uid.h>
 #include "e-cal-backend-planner.h"
+#include "e-cal-backend-planner-save.h"
 #include <libplanner/mrp-application.h>
 #include <libplanner/mrp-project.h>
 #include <libplanner/mrp-task.h>
@@ -44,16 +45,30 @@ struct _ECalBackendPlannerPrivate {
 	   floating DATE-TIME values. */
 	icaltimezone *default_zone;
 
-	/* All the tasks in the calendar, hashed by UID.  The
+	/* Components for the tasks, hashed by UID. They are created from
+	 * the tasks when first asked for, see lookup_component(). The
 	 * hash key *is* the uid returned by cal_component_get_uid(); it is not
 	 * copied, so don't free it when you remove an object from the hash
 	 * table. Each item in the hash table is a ECalComponent.
 	 */
 	GHashTable *tasks_comp;
 
+	/* The Planner tasks, hashed by their "eds-uid" property. The keys
+	 * are owned by the hash table, the tasks are not referenced.
+	 */
+	GHashTable *tasks_uid;
+
 	gboolean project_loaded;
+
+	/* Changes are written out together once there have been none for
+	 * SAVE_DELAY ms, or after SAVE_MAX_CHANGES changes.
+	 */
+	ECalBackendPlannerSave *save;
 };
 
+#define SAVE_DELAY       2000
+#define SAVE_MAX_CHANGES 100
+
 /* Backend implementation */
 static void                  cbp_dispose                 (GObject          *object);
 static void                  cbp_finalize                (GObject          *object);
@@ -161,9 +176,6 @@ static gchar *        comp_desc_as_char                  (ECalComponent    *comp
 static MrpTask *      comp_to_task                       (MrpProject       *project,
 							  ECalComponent    *comp);
 static gboolean       get_planner_tasks_cb               (ECalBackendPlanner *cbplanner);
-static void           add_comp_to_list                   (gpointer          key,
-							  gpointer          value,
-							  GList           **comps);
 static void            dump_print                        (gpointer          key,
 							  gpointer          value,
 							  gpointer          user_data);
@@ -176,6 +188,7 @@ static void            task_replace                      (MrpProject       *proj
 							  MrpTask          *task,
 							  MrpTask          *task_new);
 static void            task_add_properties               (MrpProject       *project);
+static GList *         get_all_components                (ECalBackendPlanner *backend);
 static char *          form_uri                          (ESource          *source);
 
 
@@ -205,49 +218,85 @@ dump_cache (ECalBackendPlanner *backend)
 	g_hash_table_foreach (priv->tasks_comp, dump_print, NULL);
 }
 
-/* Looks up a component by its UID on the backend's component hash table */
+/* Looks up a component by its UID on the backend's component hash table,
+ * creating it from the Planner task the first time it is needed.
+ */
 static ECalComponent *
 lookup_component (ECalBackendPlanner *backend,
 		  const char         *uid)
 {
 	ECalBackendPlannerPrivate *priv;
 	ECalComponent             *comp;
+	MrpTask                   *task;
+	const gchar               *comp_uid;
 
 	g_return_val_if_fail (uid != NULL, NULL);
 
 	priv = backend->priv;
 
 	/* dump_cache (backend); */
-	g_message ("Searching the uid: %s", uid);
 	comp = g_hash_table_lookup (priv->tasks_comp, uid);
-	if (comp == NULL) {
-		g_warning ("Key not found: %s (%p)\n", uid, uid);
+	if (comp) {
+		return comp;
+	}
+
+	task = g_hash_table_lookup (priv->tasks_uid, uid);
+	if (task == NULL) {
+		g_message ("Key not found: %s (%p)", uid, uid);
+		return NULL;
 	}
+
+	comp = task_to_comp (task);
+	e_cal_component_get_uid (comp, &comp_uid);
+	g_hash_table_insert (priv->tasks_comp, (gpointer) comp_uid, comp);
+
 	return comp;
 }
 
+typedef struct {
+	ECalBackendPlanner *backend;
+	GList              *comps;
+} ComponentsData;
+
+static void
+add_comp_to_list (const gchar    *uid,
+		  MrpTask        *task,
+		  ComponentsData *data)
+{
+	data->comps = g_list_prepend (data->comps,
+				      lookup_component (data->backend, uid));
+}
+
+/* Returns all the components, the list should be freed but not its data */
+static GList *
+get_all_components (ECalBackendPlanner *backend)
+{
+	ComponentsData data;
+
+	data.backend = backend;
+	data.comps = NULL;
+
+	g_hash_table_foreach (backend->priv->tasks_uid,
+			      (GHFunc) add_comp_to_list,
+			      &data);
+
+	return data.comps;
+}
+
 /* Looks up a component by its UID on the backend's component hash table */
 static MrpTask *
 lookup_task (ECalBackendPlanner *backend,
 	     const char         *uid)
 {
 	ECalBackendPlannerPrivate *priv;
-	GList                     *tasks, *l;
+	MrpTask                   *task;
 
 	priv = backend->priv;
-	tasks = mrp_project_get_all_tasks (priv->project);
-	for (l = tasks; l; l = l->next) {
-		gchar *task_uid;
-
-		mrp_object_get (l->data, "eds-uid", &task_uid, NULL);
-		if (!strcmp (uid, task_uid)) {
-			g_free (task_uid);
-			return l->data;
-		}
-		g_free (task_uid);
+	task = g_hash_table_lookup (priv->tasks_uid, uid);
+	if (!task) {
+		g_message ("Task not found: %s", uid);
 	}
-	g_message ("Task not found: %s", uid);
-	return NULL;
+	return task;
 }
 
 /* Replace a MrpTask in a MrpProject */
@@ -334,6 +383,12 @@ cbp_dispose (GObject *object)
 	cbplanner = E_CAL_BACKEND_PLANNER (object);
 	priv = cbplanner->priv;
 
+	/* Don't lose changes still waiting for the timeout */
+	if (priv->save) {
+		e_cal_backend_planner_save_free (priv->save);
+		priv->save = NULL;
+	}
+
 	if (G_OBJECT_CLASS (parent_class)->dispose)
 		(* G_OBJECT_CLASS (parent_class)->dispose) (object);
 }
@@ -362,6 +417,10 @@ cbp_finalize (GObject *object)
 		g_hash_table_destroy (priv->tasks_comp);
 	}
 
+	if (priv->tasks_uid) {
+		g_hash_table_destroy (priv->tasks_uid);
+	}
+
 	g_free (priv);
 	cbplanner->priv = NULL;
 
@@ -692,7 +751,6 @@ comp_to_task (MrpProject    *project,
 	/* Time to save the resources */
 	if (e_cal_component_has_attendees (comp)) {
 		GSList *attendee_list, *al;
-		GError *error = NULL;
 		GList  *resources = NULL, *l = NULL;
 
 		/* We remove all the old resources: we are loosing here the data
@@ -738,7 +796,6 @@ comp_to_task (MrpProject    *project,
 			mrp_project_add_resource (project, resource);
 			mrp_resource_assign (resource, task, 100);
 		}
-		mrp_project_save (project, TRUE, &error);
 	}
 	return task;
 }
@@ -760,14 +817,20 @@ get_planner_tasks_cb (ECalBackendPlanner *cbplanner)
 
 	kind = e_cal_backend_get_kind (E_CAL_BACKEND (cbplanner));
 
+	/* Only index the tasks here, the components are created when
+	 * they are first asked for.
+	 */
 	for (l = tasks; l; l = l->next) {
-		ECalComponent *comp;
-		const gchar   *uid;
+		gchar *uid;
 
-		comp = task_to_comp (l->data);
-		e_cal_component_get_uid (comp, &uid);
-		g_hash_table_insert (priv->tasks_comp, (gpointer) uid, comp);
+		mrp_object_get (l->data, "eds-uid", &uid, NULL);
+		if (!uid) {
+			uid = e_uid_new ();
+			mrp_object_set (l->data, "eds-uid", uid, NULL);
+		}
+		g_hash_table_insert (priv->tasks_uid, uid, l->data);
 	}
+	g_list_free (tasks);
 
 	d(g_message ("Planner task retrieval done.\n"));
 
@@ -971,7 +1034,7 @@ cbp_get_object (ECalBackendSync *backend,
 
 	g_return_val_if_fail (uid != NULL, GNOME_Evolution_Calendar_ObjectNotFound);
 
-	comp = g_hash_table_lookup (priv->tasks_comp, uid);
+	comp = lookup_component (cbplanner, uid);
 	/* comp = e_cal_backend_cache_get_component (priv->cache, uid, rid); */
 	/* We take the comp directly from libplanner */
 	if (!comp)
@@ -1048,14 +1111,6 @@ cbp_set_default_timezone (ECalBackendSync *backend,
 	return GNOME_Evolution_Calendar_Success;
 }
 
-static void
-add_comp_to_list (gpointer   key,
-		  gpointer   value,
-		  GList    **comps)
-{
-	g_message ("Adding component to list ...");
-	*comps = g_list_append (*comps, value);
-}
 
 
 
@@ -1079,7 +1134,7 @@ cbp_get_object_list (ECalBackendSync *backend,
 	cbsexp = e_cal_backend_sexp_new (sexp);
 
 	*objects = NULL;
-	g_hash_table_foreach (priv->tasks_comp, (GHFunc) add_comp_to_list, &comps);
+	comps = get_all_components (cbplanner);
 	for (l = comps; l; l = l->next) {
 		if (e_cal_backend_sexp_match_comp (cbsexp,
 						   E_CAL_COMPONENT (l->data),
@@ -1114,8 +1169,7 @@ cbp_start_query (ECalBackend  *backend,
 	cbsexp = e_cal_backend_sexp_new (e_data_cal_view_get_text (query));
 
 	objects = NULL;
-	/* FIXME: get components from Planner */
-	g_hash_table_foreach (priv->tasks_comp, (GHFunc) add_comp_to_list, &comps);
+	comps = get_all_components (cbplanner);
 	for (l = comps; l; l = l->next) {
 		if (e_cal_backend_sexp_match_comp (cbsexp,
 						   E_CAL_COMPONENT (l->data),
@@ -1209,7 +1263,6 @@ cbp_create_object (ECalBackendSync *backend,
 	const gchar               *comp_uid;
 	struct icaltimetype        current;
 	MrpTask                   *task;
-	GError                    *error = NULL;
 
 	cbplanner = E_CAL_BACKEND_PLANNER (backend);
 	priv = cbplanner->priv;
@@ -1267,9 +1320,10 @@ cbp_create_object (ECalBackendSync *backend,
 
 	/* Add the object to Planner project */
 	task = comp_to_task (priv->project, comp);
+	g_hash_table_insert (priv->tasks_uid, g_strdup (comp_uid), task);
 
 	/* Save the planner project */
-	mrp_project_save (priv->project, TRUE, &error);
+	e_cal_backend_planner_save_changed (priv->save);
 
 	return GNOME_Evolution_Calendar_Success;
 	/* return GNOME_Evolution_Calendar_PermissionDenied; */
@@ -1293,7 +1347,6 @@ cbp_modify_object (ECalBackendSync *backend,
 	ECalComponent             *cache_comp;
 	const gchar               *comp_uid;
 	MrpTask                   *task, *task_new;
-	GError                    *error = NULL;
 
 	*old_object = NULL;
 	cbplanner = E_CAL_BACKEND_PLANNER (backend);
@@ -1339,7 +1392,8 @@ cbp_modify_object (ECalBackendSync *backend,
 	}
 	g_hash_table_replace (priv->tasks_comp, (gpointer) comp_uid, comp);
 	task_replace (priv->project, task, task_new);
-	mrp_project_save (priv->project, TRUE, &error);
+	g_hash_table_replace (priv->tasks_uid, g_strdup (comp_uid), task_new);
+	e_cal_backend_planner_save_changed (priv->save);
 
 	/* Inform evolution about the object removed */
 	if (!E_IS_CAL_COMPONENT (cache_comp)) {
@@ -1366,7 +1420,6 @@ cbp_remove_object (ECalBackendSync *backend,
 	ECalBackendPlannerPrivate *priv;
 	MrpTask                   *task;
 	ECalComponent             *comp;
-	GError                    *error = NULL;
 
 	cbplanner = E_CAL_BACKEND_PLANNER (backend);
 	priv = cbplanner->priv;
@@ -1374,13 +1427,21 @@ cbp_remove_object (ECalBackendSync *backend,
 	g_return_val_if_fail (uid != NULL, GNOME_Evolution_Calendar_ObjectNotFound);
 
 	g_message ("Removing object %s ...", uid);
-	comp = lookup_component (cbplanner, uid);
-	g_hash_table_remove (priv->tasks_comp, (gpointer) uid);
-	g_object_unref (comp);
 	task = lookup_task (cbplanner, uid);
+	if (!task) {
+		return GNOME_Evolution_Calendar_ObjectNotFound;
+	}
+
+	/* The component only exists if somebody asked for it */
+	comp = g_hash_table_lookup (priv->tasks_comp, uid);
+	if (comp) {
+		g_hash_table_remove (priv->tasks_comp, (gpointer) uid);
+		g_object_unref (comp);
+	}
+	g_hash_table_remove (priv->tasks_uid, uid);
 	mrp_project_remove_task (priv->project, task);
 	g_object_unref (task);
-	mrp_project_save (priv->project, TRUE, &error);
+	e_cal_backend_planner_save_changed (priv->save);
 
 	return GNOME_Evolution_Calendar_Success;;
 }
@@ -1474,8 +1535,13 @@ cbp_init (ECalBackendPlanner      *cbplanner,
 	priv = g_new0 (ECalBackendPlannerPrivate, 1);
 	cbplanner->priv = priv;
 	priv->tasks_comp = g_hash_table_new (g_str_hash, g_str_equal);
+	priv->tasks_uid = g_hash_table_new_full (g_str_hash, g_str_equal,
+						 g_free, NULL);
 
 	priv->project = mrp_project_new (class->mrp_app);
+	priv->save = e_cal_backend_planner_save_new (priv->project,
+						     SAVE_DELAY,
+						     SAVE_MAX_CHANGES);
 
 	priv->uri = NULL;
 	priv->project_loaded = FALSE;
@@ -160,7 +160,7 @@ application_finalize_file_modules (MrpApplication *app)
 	g_list_free (app->priv->file_writers);
 	app->priv->file_writers = NULL;
 
-	g_list_foreach (app->priv->modules, (GFunc) g_free, NULL);
+	g_list_foreach (app->priv->modules, (GFunc) mrp_file_module_free, NULL);
 	g_list_free (app->priv->modules);
 	app->priv->modules = NULL;
 }
@@ -175,6 +175,10 @@ imrp_application_register_reader (MrpApplication *app, MrpFileReader *reader)
 
 	priv = app->priv;
 
+	if (imrp_file_module_replace_reader (priv->file_readers, reader)) {
+		return;
+	}
+
 	priv->file_readers = g_list_prepend (priv->file_readers, reader);
 }
 
@@ -188,6 +192,10 @@ imrp_application_register_writer (MrpApplication *app, MrpFileWriter *writer)
 
 	priv = app->priv;
 
+	if (imrp_file_module_replace_writer (priv->file_writers, writer)) {
+		return;
+	}
+
 	priv->file_writers = g_list_prepend (priv->file_writers, writer);
 }
 
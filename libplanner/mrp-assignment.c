@@ -294,3 +294,35 @@ mrp_assignment_get_units (MrpAssignment *assignment)
 
 	return assignment->priv->units;
 }
+
+/**
+ * mrp_assignment_set_units:
+ * @assignment: an #MrpAssignment
+ * @units: the number of units, 100 means 100%
+ *
+ * Sets the number of units that the resource is assigned with to the task.
+ * This is the same as setting the "units" property, but doesn't go through
+ * the property machinery and only notifies if the value changes.
+ **/
+void
+mrp_assignment_set_units (MrpAssignment *assignment,
+			  gint           units)
+{
+	MrpAssignmentPriv *priv;
+
+	g_return_if_fail (MRP_IS_ASSIGNMENT (assignment));
+
+	priv = assignment->priv;
+
+	if (priv->units == units) {
+		return;
+	}
+
+	priv->units = units;
+
+	if (priv->resource) {
+		mrp_object_changed (MRP_OBJECT (priv->resource));
+	}
+
+	g_object_notify (G_OBJECT (assignment), "units");
+}
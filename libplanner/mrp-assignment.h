@@ -54,5 +54,7 @@ MrpAssignment     *mrp_assignment_new          (void);
 MrpTask           *mrp_assignment_get_task     (MrpAssignment *assignment);
 MrpResource       *mrp_assignment_get_resource (MrpAssignment *assignment);
 gint               mrp_assignment_get_units    (MrpAssignment *assignment);
+void               mrp_assignment_set_units    (MrpAssignment *assignment,
+						gint           units);
 
 #endif /* __MRP_ASSIGNMENT_H__ */
@@ -29,6 +29,7 @@
 #include "mrp-private.h"
 #include "mrp-time.h"
 #include "mrp-calendar.h"
+#include "mrp-trace.h"
 
 /* Properties */
 enum {
@@ -934,6 +935,10 @@ mrp_calendar_get_day (MrpCalendar *calendar,
 
 	g_return_val_if_fail (MRP_IS_CALENDAR (calendar), NULL);
 
+	if (mrp_trace_is_enabled ()) {
+		mrp_trace_count (MRP_TRACE_COUNTER_CALENDAR_LOOKUPS, 1);
+	}
+
 	aligned_date = mrp_time_align_day (date);
 	day          = calendar_get_day (calendar, aligned_date, check_ancestors);
 
@@ -26,6 +26,21 @@
 #include <glib/gi18n.h>
 #include "libplanner/mrp-paths.h"
 #include "mrp-file-module.h"
+#include "mrp-private.h"
+#include "mrp-error.h"
+
+#define MANIFEST_GROUP  "Planner File Module"
+#define MANIFEST_SUFFIX ".manifest"
+
+static gboolean     file_module_proxy_write       (MrpFileWriter  *proxy,
+						   MrpProject     *project,
+						   const gchar    *uri,
+						   gboolean        force,
+						   GError        **error);
+static gboolean     file_module_proxy_read_string (MrpFileReader  *proxy,
+						   const gchar    *str,
+						   MrpProject     *project,
+						   GError        **error);
 
 static MrpFileModule *
 file_module_load (const gchar *file)
@@ -40,6 +55,7 @@ file_module_load (const gchar *file)
 		g_warning ("Could not open file module '%s'\n",
 			   g_module_error ());
 
+		g_free (module);
 		return NULL;
 	}
 
@@ -48,6 +64,122 @@ file_module_load (const gchar *file)
 	return module;
 }
 
+/* Opens and initializes a module that was registered from its manifest.
+ * The module's init function registers the real readers and writers,
+ * which take the place of the proxies.
+ */
+static gboolean
+file_module_open (MrpFileModule *module)
+{
+	if (module->handle) {
+		return TRUE;
+	}
+
+	if (module->failed) {
+		return FALSE;
+	}
+
+	module->handle = g_module_open (module->filename, G_MODULE_BIND_LAZY);
+
+	if (module->handle == NULL) {
+		g_warning ("Could not open file module '%s'\n",
+			   g_module_error ());
+
+		module->failed = TRUE;
+		return FALSE;
+	}
+
+	g_module_symbol (module->handle, "init", (gpointer)&module->init);
+
+	mrp_file_module_init (module, module->app);
+
+	return TRUE;
+}
+
+static MrpFileModule *
+file_module_load_manifest (MrpApplication *app,
+			   const gchar    *dir,
+			   const gchar    *file,
+			   GHashTable     *claimed)
+{
+	MrpFileModule *module;
+	GKeyFile      *key_file;
+	gchar         *library;
+	gchar         *name;
+	gsize          n_writers, n_mime_types, i;
+
+	key_file = g_key_file_new ();
+
+	if (!g_key_file_load_from_file (key_file, file, 0, NULL)) {
+		g_warning ("Could not read file module manifest '%s'", file);
+		g_key_file_free (key_file);
+		return NULL;
+	}
+
+	library = g_key_file_get_string (key_file, MANIFEST_GROUP, "Library", NULL);
+	if (!library) {
+		g_warning ("File module manifest '%s' has no library", file);
+		g_key_file_free (key_file);
+		return NULL;
+	}
+
+	module = mrp_file_module_new ();
+	module->app = app;
+
+	name = g_strconcat (library, ".", G_MODULE_SUFFIX, NULL);
+	if (g_path_is_absolute (name)) {
+		module->filename = name;
+	} else {
+		module->filename = g_build_filename (dir, name, NULL);
+		g_free (name);
+	}
+	g_free (library);
+
+	g_hash_table_insert (claimed, g_path_get_basename (module->filename), module);
+
+	module->writer_ids = g_key_file_get_string_list (key_file,
+							 MANIFEST_GROUP,
+							 "Writers",
+							 &n_writers,
+							 NULL);
+	module->mime_types = g_key_file_get_string_list (key_file,
+							 MANIFEST_GROUP,
+							 "MimeTypes",
+							 &n_mime_types,
+							 NULL);
+
+	if (module->writer_ids && n_mime_types != n_writers) {
+		g_warning ("File module manifest '%s' needs one mime type per writer", file);
+		n_writers = 0;
+	}
+
+	for (i = 0; module->writer_ids && i < n_writers; i++) {
+		MrpFileWriter *writer;
+
+		writer = g_new0 (MrpFileWriter, 1);
+		writer->module = module;
+		writer->identifier = module->writer_ids[i];
+		writer->mime_type = module->mime_types[i];
+		writer->write = file_module_proxy_write;
+
+		imrp_application_register_writer (app, writer);
+	}
+
+	if (g_key_file_get_boolean (key_file, MANIFEST_GROUP, "Reader", NULL)) {
+		MrpFileReader *reader;
+
+		reader = g_new0 (MrpFileReader, 1);
+		reader->module = module;
+		reader->read_string = file_module_proxy_read_string;
+
+		imrp_application_register_reader (app, reader);
+	}
+
+	g_key_file_free (key_file);
+
+	return module;
+}
+
 GList *
 mrp_file_module_load_all (MrpApplication *app)
 {
@@ -56,6 +188,7 @@ mrp_file_module_load_all (MrpApplication *app)
 	MrpFileModule *module;
 	gchar         *path;
 	GList         *modules = NULL;
+	GHashTable    *claimed;
 
 	path = mrp_paths_get_file_modules_dir (NULL);
 
@@ -66,8 +199,35 @@ mrp_file_module_load_all (MrpApplication *app)
 		return NULL;
 	}
 
+	claimed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	/* Modules with a manifest are only opened when first used. */
 	while ((name = g_dir_read_name (dir)) != NULL) {
-		if (g_str_has_suffix (name, G_MODULE_SUFFIX)) {
+		if (g_str_has_suffix (name, MANIFEST_SUFFIX)) {
+			gchar *manifest;
+
+			manifest = g_build_filename (path,
+						     name,
+						     NULL);
+
+			module = file_module_load_manifest (app,
+							    path,
+							    manifest,
+							    claimed);
+			if (module) {
+				modules = g_list_prepend (modules, module);
+			}
+
+			g_free (manifest);
+		}
+	}
+
+	/* Any other module is loaded right away, as before. */
+	g_dir_rewind (dir);
+
+	while ((name = g_dir_read_name (dir)) != NULL) {
+		if (g_str_has_suffix (name, G_MODULE_SUFFIX) &&
+		    !g_hash_table_lookup (claimed, name)) {
 			gchar *plugin;
 
 			plugin = g_build_filename (path,
@@ -84,6 +244,7 @@ mrp_file_module_load_all (MrpApplication *app)
 		}
 	}
 
+	g_hash_table_destroy (claimed);
 	g_free (path);
 	g_dir_close (dir);
 
@@ -109,6 +270,140 @@ mrp_file_module_init (MrpFileModule *plugin, MrpApplication *app)
         }
 }
 
+void
+mrp_file_module_free (MrpFileModule *module)
+{
+	g_return_if_fail (module != NULL);
+
+	g_list_foreach (module->proxies, (GFunc) g_free, NULL);
+	g_list_free (module->proxies);
+
+	g_strfreev (module->writer_ids);
+	g_strfreev (module->mime_types);
+	g_free (module->filename);
+
+	g_free (module);
+}
+
+gboolean
+mrp_file_module_is_loaded (MrpFileModule *module)
+{
+	g_return_val_if_fail (module != NULL, FALSE);
+
+	return module->handle != NULL;
+}
+
+/* Puts @writer in the place of the proxy registered for the same module
+ * and identifier, the proxy is kept alive until the module is freed.
+ */
+gboolean
+imrp_file_module_replace_writer (GList *writers, MrpFileWriter *writer)
+{
+	GList         *l;
+	MrpFileWriter *proxy;
+
+	for (l = writers; l; l = l->next) {
+		proxy = l->data;
+
+		if (proxy->write == file_module_proxy_write &&
+		    proxy->module == writer->module &&
+		    writer->identifier &&
+		    strcmp (proxy->identifier, writer->identifier) == 0) {
+			l->data = writer;
+			proxy->module->proxies = g_list_prepend (proxy->module->proxies,
+								 proxy);
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+gboolean
+imrp_file_module_replace_reader (GList *readers, MrpFileReader *reader)
+{
+	GList         *l;
+	MrpFileReader *proxy;
+
+	for (l = readers; l; l = l->next) {
+		proxy = l->data;
+
+		if (proxy->read_string == file_module_proxy_read_string &&
+		    proxy->module == reader->module) {
+			l->data = reader;
+			proxy->module->proxies = g_list_prepend (proxy->module->proxies,
+								 proxy);
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static gboolean
+file_module_proxy_write (MrpFileWriter  *proxy,
+			 MrpProject     *project,
+			 const gchar    *uri,
+			 gboolean        force,
+			 GError        **error)
+{
+	MrpFileModule *module = proxy->module;
+	GList         *l;
+
+	if (file_module_open (module)) {
+		l = imrp_application_get_all_file_writers (module->app);
+		for (; l; l = l->next) {
+			MrpFileWriter *writer = l->data;
+
+			if (writer->write != file_module_proxy_write &&
+			    writer->module == module &&
+			    strcmp (writer->identifier, proxy->identifier) == 0) {
+				return mrp_file_writer_write (writer, project,
+							      uri, force, error);
+			}
+		}
+	}
+
+	g_set_error (error,
+		     MRP_ERROR,
+		     MRP_ERROR_EXPORT_UNSUPPORTED,
+		     _("Unable to find file writer identified by '%s'"),
+		     proxy->identifier);
+
+	return FALSE;
+}
+
+static gboolean
+file_module_proxy_read_string (MrpFileReader  *proxy,
+			       const gchar    *str,
+			       MrpProject     *project,
+			       GError        **error)
+{
+	MrpFileModule *module = proxy->module;
+	GList         *l;
+
+	if (!file_module_open (module)) {
+		g_set_error (error,
+			     MRP_ERROR,
+			     MRP_ERROR_FAILED,
+			     _("This format does not support reading"));
+		return FALSE;
+	}
+
+	l = imrp_application_get_all_file_readers (module->app);
+	for (; l; l = l->next) {
+		MrpFileReader *reader = l->data;
+
+		if (reader->read_string != file_module_proxy_read_string &&
+		    reader->module == module &&
+		    mrp_file_reader_read_string (reader, str, project, error)) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
 gboolean
 mrp_file_reader_read_string (MrpFileReader  *reader,
 			     const gchar    *str,
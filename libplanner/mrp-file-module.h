@@ -43,6 +43,13 @@ struct _MrpFileModule {
 			MrpApplication   *app);
 
 	/* This function calls mrp_application_register_output_writer (...) */
+
+	/* Set for modules registered from a manifest, opened on first use. */
+	gchar           *filename;
+	gchar          **writer_ids;
+	gchar          **mime_types;
+	GList           *proxies;
+	gboolean         failed;
 };
 
 struct _MrpFileReader {
@@ -80,6 +87,8 @@ MrpFileModule * mrp_file_module_new       (void);
 
 void            mrp_file_module_init      (MrpFileModule     *module,
 					   MrpApplication    *app);
+void            mrp_file_module_free      (MrpFileModule     *module);
+gboolean        mrp_file_module_is_loaded (MrpFileModule     *module);
 
 /* File Reader */
 gboolean        mrp_file_reader_read_string   (MrpFileReader     *reader,
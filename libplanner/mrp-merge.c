@@ -0,0 +1,667 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Applies the difference between two versions of a project to the one that
+ * is shown, so that views only see the tasks and resources that changed.
+ * Objects are matched by the uid that is saved with them, see
+ * mrp_object_get_uid(). Unlike the id, it survives other objects being
+ * added or removed.
+ */
+
+#include <config.h>
+#include <string.h>
+#include "mrp-private.h"
+#include "mrp-project.h"
+#include "mrp-task.h"
+#include "mrp-resource.h"
+#include "mrp-relation.h"
+#include "mrp-assignment.h"
+
+typedef struct {
+	MrpProject *project;
+	MrpProject *source;
+
+	/* Uid -> task in the source project. */
+	GHashTable *source_tasks;
+
+	/* Uid -> task in the project, after the removals. */
+	GHashTable *tasks;
+
+	/* Source task -> task in the project. */
+	GHashTable *task_map;
+
+	/* Uid -> resource in the source project. */
+	GHashTable *source_resources;
+
+	/* Source resource -> resource in the project. */
+	GHashTable *resource_map;
+} MergeData;
+
+#define UID(o) ((gpointer) mrp_object_get_uid (MRP_OBJECT (o)))
+
+/* Adds @objects to @hash by uid. Returns FALSE if one of them has no uid
+ * or shares it with another one.
+ */
+static gboolean
+merge_index_objects (GHashTable *hash, GList *objects)
+{
+	GList *l;
+
+	for (l = objects; l; l = l->next) {
+		if (!UID (l->data) || g_hash_table_lookup (hash, UID (l->data))) {
+			return FALSE;
+		}
+
+		g_hash_table_insert (hash, UID (l->data), l->data);
+	}
+
+	return TRUE;
+}
+
+static GHashTable *
+merge_index_tasks (MrpProject *project)
+{
+	GHashTable *hash;
+	GList      *tasks;
+
+	hash = g_hash_table_new (g_str_hash, g_str_equal);
+
+	/* The root is not in the file so it is not in the list. */
+	tasks = mrp_project_get_all_tasks (project);
+	if (!merge_index_objects (hash, tasks)) {
+		g_hash_table_destroy (hash);
+		hash = NULL;
+	}
+	g_list_free (tasks);
+
+	return hash;
+}
+
+static GHashTable *
+merge_index_resources (MrpProject *project)
+{
+	GHashTable *hash;
+
+	hash = g_hash_table_new (g_str_hash, g_str_equal);
+
+	if (!merge_index_objects (hash, mrp_project_get_resources (project))) {
+		g_hash_table_destroy (hash);
+		hash = NULL;
+	}
+
+	return hash;
+}
+
+/* Whether every task and resource of @project can be matched. That is not
+ * the case for files written before uids were saved, or by other programs.
+ */
+static gboolean
+merge_can_match (MrpProject *project)
+{
+	GHashTable *hash;
+
+	hash = merge_index_tasks (project);
+	if (!hash) {
+		return FALSE;
+	}
+	g_hash_table_destroy (hash);
+
+	hash = merge_index_resources (project);
+	if (!hash) {
+		return FALSE;
+	}
+	g_hash_table_destroy (hash);
+
+	return TRUE;
+}
+
+static gboolean
+merge_string_equal (const gchar *a, const gchar *b)
+{
+	return strcmp (a ? a : "", b ? b : "") == 0;
+}
+
+/* Removes the tasks that are gone from the source, with their subtrees. */
+static void
+merge_remove_tasks (MergeData *data, MrpTask *parent)
+{
+	MrpTask *task, *next;
+
+	for (task = mrp_task_get_first_child (parent); task; task = next) {
+		next = mrp_task_get_next_sibling (task);
+
+		if (!g_hash_table_lookup (data->source_tasks, UID (task))) {
+			mrp_project_remove_task (data->project, task);
+		} else {
+			merge_remove_tasks (data, task);
+		}
+	}
+}
+
+/* Removes the relations that the source doesn't have, before tasks are
+ * moved, so that they can't stop a move.
+ */
+static void
+merge_remove_relations (gpointer   uid,
+			MrpTask   *task,
+			MergeData *data)
+{
+	MrpTask *source;
+	GList   *relations, *l;
+
+	source = g_hash_table_lookup (data->source_tasks, uid);
+	if (!source) {
+		return;
+	}
+
+	relations = g_list_copy (mrp_task_get_predecessor_relations (task));
+	for (l = relations; l; l = l->next) {
+		MrpTask     *predecessor;
+		MrpTask     *source_predecessor;
+		MrpRelation *source_relation = NULL;
+
+		predecessor = mrp_relation_get_predecessor (l->data);
+		source_predecessor = g_hash_table_lookup (data->source_tasks,
+							  UID (predecessor));
+		if (source_predecessor) {
+			source_relation = mrp_task_get_predecessor_relation (source,
+									     source_predecessor);
+		}
+
+		if (!source_relation ||
+		    mrp_relation_get_relation_type (source_relation) !=
+		    mrp_relation_get_relation_type (l->data)) {
+			mrp_task_remove_predecessor (task, predecessor);
+		}
+	}
+	g_list_free (relations);
+}
+
+static void
+merge_task_properties (MrpTask *task, MrpTask *source)
+{
+	gchar         *name, *note;
+	gchar         *source_name, *source_note;
+	MrpTaskType    type, source_type;
+	MrpTaskSched   sched, source_sched;
+	gint           work, source_work;
+	gint           duration, source_duration;
+	gint           complete, source_complete;
+	gint           priority, source_priority;
+	MrpConstraint  constraint, source_constraint;
+
+	g_object_get (task,
+		      "name", &name,
+		      "note", &note,
+		      "type", &type,
+		      "sched", &sched,
+		      "work", &work,
+		      "duration", &duration,
+		      "percent_complete", &complete,
+		      "priority", &priority,
+		      NULL);
+	g_object_get (source,
+		      "name", &source_name,
+		      "note", &source_note,
+		      "type", &source_type,
+		      "sched", &source_sched,
+		      "work", &source_work,
+		      "duration", &source_duration,
+		      "percent_complete", &source_complete,
+		      "priority", &source_priority,
+		      NULL);
+
+	/* Only touch what changed so the views get as few signals as
+	 * possible.
+	 */
+	if (!merge_string_equal (name, source_name)) {
+		g_object_set (task, "name", source_name, NULL);
+	}
+	if (!merge_string_equal (note, source_note)) {
+		g_object_set (task, "note", source_note, NULL);
+	}
+	if (type != source_type) {
+		g_object_set (task, "type", source_type, NULL);
+	}
+	if (sched != source_sched) {
+		g_object_set (task, "sched", source_sched, NULL);
+	}
+	if (work != source_work) {
+		g_object_set (task, "work", source_work, NULL);
+	}
+	if (duration != source_duration) {
+		g_object_set (task, "duration", source_duration, NULL);
+	}
+	if (complete != source_complete) {
+		g_object_set (task, "percent_complete", source_complete, NULL);
+	}
+	if (priority != source_priority) {
+		g_object_set (task, "priority", source_priority, NULL);
+	}
+
+	constraint = mrp_task_get_constraint (task);
+	source_constraint = mrp_task_get_constraint (source);
+	if (constraint.type != source_constraint.type ||
+	    constraint.time != source_constraint.time) {
+		g_object_set (task, "constraint", &source_constraint, NULL);
+	}
+
+	g_free (name);
+	g_free (note);
+	g_free (source_name);
+	g_free (source_note);
+}
+
+/* Copies the values of the custom properties that both projects define. */
+static void
+merge_custom_properties (MergeData *data,
+			 MrpObject *object,
+			 MrpObject *source,
+			 GType      type)
+{
+	GList *properties, *l;
+
+	properties = mrp_project_get_properties_from_type (data->source, type);
+	for (l = properties; l; l = l->next) {
+		MrpProperty *source_property = l->data;
+		MrpProperty *property;
+		const gchar *name;
+		GValue       value = { 0 };
+		GValue       source_value = { 0 };
+
+		name = mrp_property_get_name (source_property);
+		if (!mrp_project_has_property (data->project, type, name)) {
+			continue;
+		}
+
+		property = mrp_project_get_property (data->project, name, type);
+		if (mrp_property_get_property_type (property) !=
+		    mrp_property_get_property_type (source_property)) {
+			continue;
+		}
+
+		g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (property));
+		g_value_init (&source_value, G_PARAM_SPEC_VALUE_TYPE (property));
+
+		mrp_object_get_property (object, property, &value);
+		mrp_object_get_property (source, source_property, &source_value);
+
+		if (g_param_values_cmp (G_PARAM_SPEC (property),
+					&value, &source_value) != 0) {
+			mrp_object_set_property (object, property, &source_value);
+		}
+
+		g_value_unset (&value);
+		g_value_unset (&source_value);
+	}
+	g_list_free (properties);
+}
+
+static MrpTask *
+merge_new_task (MrpTask *source)
+{
+	MrpTask       *task;
+	MrpConstraint  constraint;
+
+	task = g_object_new (MRP_TYPE_TASK,
+			     "name", mrp_task_get_name (source),
+			     "note", mrp_task_get_note (source),
+			     "type", mrp_task_get_task_type (source),
+			     "sched", mrp_task_get_sched (source),
+			     "work", mrp_task_get_work (source),
+			     "duration", mrp_task_get_duration (source),
+			     "percent_complete", (gint) mrp_task_get_percent_complete (source),
+			     "priority", mrp_task_get_priority (source),
+			     NULL);
+
+	constraint = mrp_task_get_constraint (source);
+	g_object_set (task, "constraint", &constraint, NULL);
+
+	imrp_object_set_uid (MRP_OBJECT (task), UID (source));
+
+	return task;
+}
+
+/* Walks the source tree and makes the children of @parent match the ones
+ * of @source_parent. Children before position i are already in place, so
+ * a task that is not where it should be goes right after child i - 1.
+ */
+static void
+merge_tasks (MergeData *data, MrpTask *parent, MrpTask *source_parent)
+{
+	MrpTask *source;
+	MrpTask *task;
+	MrpTask *sibling;
+	GError  *error = NULL;
+	gint     i;
+
+	i = 0;
+	for (source = mrp_task_get_first_child (source_parent); source;
+	     source = mrp_task_get_next_sibling (source), i++) {
+		task = g_hash_table_lookup (data->tasks, UID (source));
+
+		if (task) {
+			if (mrp_task_get_parent (task) != parent ||
+			    mrp_task_get_position (task) != i) {
+				sibling = NULL;
+				if (i > 0) {
+					sibling = mrp_task_get_nth_child (parent, i - 1);
+				}
+
+				if (!mrp_project_move_task (data->project,
+							    task,
+							    sibling,
+							    parent,
+							    sibling == NULL,
+							    &error)) {
+					g_warning ("Could not move task '%s': %s",
+						   mrp_task_get_name (task),
+						   error->message);
+					g_clear_error (&error);
+				}
+			}
+
+			merge_task_properties (task, source);
+		} else {
+			task = merge_new_task (source);
+			mrp_project_insert_task (data->project, parent, i, task);
+		}
+
+		merge_custom_properties (data,
+					 MRP_OBJECT (task),
+					 MRP_OBJECT (source),
+					 MRP_TYPE_TASK);
+
+		g_hash_table_insert (data->task_map, source, task);
+
+		merge_tasks (data, task, source);
+	}
+}
+
+static void
+merge_add_relations (MrpTask *source, MrpTask *task, MergeData *data)
+{
+	GList *l;
+
+	for (l = mrp_task_get_predecessor_relations (source); l; l = l->next) {
+		MrpRelation *source_relation = l->data;
+		MrpRelation *relation;
+		MrpTask     *predecessor;
+		gint         lag;
+
+		predecessor = g_hash_table_lookup (data->task_map,
+						   mrp_relation_get_predecessor (source_relation));
+		if (!predecessor) {
+			continue;
+		}
+
+		lag = mrp_relation_get_lag (source_relation);
+
+		relation = mrp_task_get_predecessor_relation (task, predecessor);
+		if (!relation) {
+			mrp_task_add_predecessor (task,
+						  predecessor,
+						  mrp_relation_get_relation_type (source_relation),
+						  lag,
+						  NULL);
+		}
+		else if (mrp_relation_get_lag (relation) != lag) {
+			g_object_set (relation, "lag", lag, NULL);
+		}
+	}
+}
+
+static void
+merge_resources (MergeData *data)
+{
+	GHashTable *resources;
+	GList      *list, *l;
+
+	data->source_resources = merge_index_resources (data->source);
+
+	/* Remove the ones that are gone, then index the rest. */
+	list = g_list_copy (mrp_project_get_resources (data->project));
+	for (l = list; l; l = l->next) {
+		if (!g_hash_table_lookup (data->source_resources, UID (l->data))) {
+			mrp_project_remove_resource (data->project, l->data);
+		}
+	}
+	g_list_free (list);
+
+	resources = merge_index_resources (data->project);
+
+	for (l = mrp_project_get_resources (data->source); l; l = l->next) {
+		MrpResource     *source = l->data;
+		MrpResource     *resource;
+		MrpResourceType  type;
+		gint             units;
+		gchar           *email, *note;
+		gchar           *source_email, *source_note;
+
+		g_object_get (source,
+			      "email", &source_email,
+			      "note", &source_note,
+			      NULL);
+
+		resource = g_hash_table_lookup (resources, UID (source));
+		if (!resource) {
+			resource = g_object_new (MRP_TYPE_RESOURCE,
+						 "name", mrp_resource_get_name (source),
+						 "short_name", mrp_resource_get_short_name (source),
+						 "type", mrp_resource_get_resource_type (source),
+						 "units", mrp_resource_get_units (source),
+						 "email", source_email,
+						 "note", source_note,
+						 NULL);
+			mrp_project_add_resource (data->project, resource);
+			imrp_object_set_uid (MRP_OBJECT (resource), UID (source));
+			mrp_resource_set_cost (resource, mrp_resource_get_cost (source));
+		} else {
+			g_object_get (resource,
+				      "type", &type,
+				      "units", &units,
+				      "email", &email,
+				      "note", &note,
+				      NULL);
+
+			if (!merge_string_equal (mrp_resource_get_name (resource),
+						 mrp_resource_get_name (source))) {
+				mrp_resource_set_name (resource,
+						       mrp_resource_get_name (source));
+			}
+			if (!merge_string_equal (mrp_resource_get_short_name (resource),
+						 mrp_resource_get_short_name (source))) {
+				mrp_resource_set_short_name (resource,
+							     mrp_resource_get_short_name (source));
+			}
+			if (type != mrp_resource_get_resource_type (source)) {
+				g_object_set (resource,
+					      "type", mrp_resource_get_resource_type (source),
+					      NULL);
+			}
+			if (units != mrp_resource_get_units (source)) {
+				g_object_set (resource,
+					      "units", mrp_resource_get_units (source),
+					      NULL);
+			}
+			if (!merge_string_equal (email, source_email)) {
+				g_object_set (resource, "email", source_email, NULL);
+			}
+			if (!merge_string_equal (note, source_note)) {
+				g_object_set (resource, "note", source_note, NULL);
+			}
+			if (mrp_resource_get_cost (resource) != mrp_resource_get_cost (source)) {
+				mrp_resource_set_cost (resource,
+						       mrp_resource_get_cost (source));
+			}
+
+			g_free (email);
+			g_free (note);
+		}
+
+		merge_custom_properties (data,
+					 MRP_OBJECT (resource),
+					 MRP_OBJECT (source),
+					 MRP_TYPE_RESOURCE);
+
+		g_hash_table_insert (data->resource_map, source, resource);
+
+		g_free (source_email);
+		g_free (source_note);
+	}
+
+	g_hash_table_destroy (resources);
+}
+
+static void
+merge_assignments (MrpTask *source, MrpTask *task, MergeData *data)
+{
+	GList *list, *l;
+
+	list = g_list_copy (mrp_task_get_assignments (task));
+	for (l = list; l; l = l->next) {
+		MrpResource *source_resource;
+
+		source_resource = g_hash_table_lookup (data->source_resources,
+						       UID (mrp_assignment_get_resource (l->data)));
+
+		if (!source_resource ||
+		    !mrp_task_get_assignment (source, source_resource)) {
+			mrp_object_removed (MRP_OBJECT (l->data));
+		}
+	}
+	g_list_free (list);
+
+	for (l = mrp_task_get_assignments (source); l; l = l->next) {
+		MrpAssignment *assignment;
+		MrpResource   *resource;
+		gint           units;
+
+		resource = g_hash_table_lookup (data->resource_map,
+						mrp_assignment_get_resource (l->data));
+		if (!resource) {
+			continue;
+		}
+
+		units = mrp_assignment_get_units (l->data);
+
+		assignment = mrp_task_get_assignment (task, resource);
+		if (!assignment) {
+			mrp_resource_assign (resource, task, units);
+		}
+		else if (mrp_assignment_get_units (assignment) != units) {
+			mrp_assignment_set_units (assignment, units);
+		}
+	}
+}
+
+static void
+merge_project_properties (MrpProject *project, MrpProject *source)
+{
+	const gchar *names[] = { "name", "organization", "manager" };
+	gchar       *value, *source_value;
+	mrptime      start, source_start;
+	guint        i;
+
+	for (i = 0; i < G_N_ELEMENTS (names); i++) {
+		g_object_get (project, names[i], &value, NULL);
+		g_object_get (source, names[i], &source_value, NULL);
+
+		if (!merge_string_equal (value, source_value)) {
+			g_object_set (project, names[i], source_value, NULL);
+		}
+
+		g_free (value);
+		g_free (source_value);
+	}
+
+	g_object_get (project, "project-start", &start, NULL);
+	g_object_get (source, "project-start", &source_start, NULL);
+	if (start != source_start) {
+		g_object_set (project, "project-start", source_start, NULL);
+	}
+}
+
+/**
+ * imrp_project_merge:
+ * @project: the project to update
+ * @source: a newer version of @project, as read from its file
+ *
+ * Changes @project to match @source with as few inserts, moves, updates
+ * and removals of tasks, resources, relations and assignments as
+ * possible. Values of the custom properties defined in both projects are
+ * copied. Calendars, groups, phases and the property definitions are not
+ * merged.
+ *
+ * Return value: %FALSE, without touching @project, if a task or resource
+ * in either project has no uid or shares it with another one, so that the
+ * objects can't be matched.
+ **/
+gboolean
+imrp_project_merge (MrpProject *project, MrpProject *source)
+{
+	MrpTaskManager *manager;
+	MergeData       data;
+
+	g_return_val_if_fail (MRP_IS_PROJECT (project), FALSE);
+	g_return_val_if_fail (MRP_IS_PROJECT (source), FALSE);
+
+	if (!merge_can_match (project) || !merge_can_match (source)) {
+		return FALSE;
+	}
+
+	data.project = project;
+	data.source = source;
+	data.task_map = g_hash_table_new (NULL, NULL);
+	data.resource_map = g_hash_table_new (NULL, NULL);
+
+	manager = imrp_project_get_task_manager (project);
+	mrp_task_manager_set_block_scheduling (manager, TRUE);
+
+	merge_project_properties (project, source);
+
+	merge_resources (&data);
+
+	data.source_tasks = merge_index_tasks (source);
+	merge_remove_tasks (&data, mrp_project_get_root_task (project));
+
+	data.tasks = merge_index_tasks (project);
+	g_hash_table_foreach (data.tasks, (GHFunc) merge_remove_relations, &data);
+
+	merge_tasks (&data,
+		     mrp_project_get_root_task (project),
+		     mrp_project_get_root_task (source));
+
+	g_hash_table_foreach (data.task_map, (GHFunc) merge_add_relations, &data);
+	g_hash_table_foreach (data.task_map, (GHFunc) merge_assignments, &data);
+
+	g_hash_table_destroy (data.source_tasks);
+	g_hash_table_destroy (data.tasks);
+	g_hash_table_destroy (data.task_map);
+	g_hash_table_destroy (data.source_resources);
+	g_hash_table_destroy (data.resource_map);
+
+	mrp_task_manager_set_block_scheduling (manager, FALSE);
+
+	imrp_project_set_needs_saving (project, FALSE);
+
+	return TRUE;
+}
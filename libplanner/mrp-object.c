@@ -36,6 +36,12 @@ struct _MrpObjectPriv {
 	MrpProject *project;
 	guint       id;
 	GHashTable *property_hash;
+
+	/* Identifies the object in the file it is saved to, across saves
+	 * and edits. NULL until it is read or written. Used to match
+	 * objects on reload.
+	 */
+	gchar      *uid;
 };
 
 /* Signals */
@@ -160,6 +166,10 @@ object_init (MrpObject *object)
 static void
 object_finalize (GObject *g_object)
 {
+	MrpObject *object = MRP_OBJECT (g_object);
+
+	g_free (object->priv->uid);
+
         if (G_OBJECT_CLASS (parent_class)->finalize) {
                 (* G_OBJECT_CLASS (parent_class)->finalize) (g_object);
         }
@@ -673,3 +683,65 @@ mrp_object_get_project (MrpObject *object)
 
 	return priv->project;
 }
+
+void
+imrp_object_set_uid (MrpObject *object, const gchar *uid)
+{
+	MrpObjectPriv *priv;
+	gchar         *old_uid;
+
+	g_return_if_fail (MRP_IS_OBJECT (object));
+
+	priv = object->priv;
+
+	old_uid = priv->uid;
+	priv->uid = g_strdup (uid);
+
+	if (priv->project) {
+		imrp_project_object_uid_changed (priv->project, object, old_uid);
+	}
+
+	g_free (old_uid);
+}
+
+/**
+ * mrp_object_get_uid:
+ * @object: an #MrpObject
+ *
+ * Retrieves the uid of a task or resource. Unlike the id, it is saved with
+ * the project and stays the same across saves and loads. Objects get one
+ * the first time they are saved.
+ *
+ * Return value: the uid, or %NULL if @object has none yet.
+ **/
+const gchar *
+mrp_object_get_uid (MrpObject *object)
+{
+	g_return_val_if_fail (MRP_IS_OBJECT (object), NULL);
+
+	return object->priv->uid;
+}
+
+/* Returns the uid of @object, making up a random one if it has none. */
+const gchar *
+imrp_object_ensure_uid (MrpObject *object)
+{
+	MrpObjectPriv *priv;
+	gchar         *uid;
+
+	g_return_val_if_fail (MRP_IS_OBJECT (object), NULL);
+
+	priv = object->priv;
+
+	if (!priv->uid) {
+		uid = g_strdup_printf ("%08x%08x%08x%08x",
+				       g_random_int (),
+				       g_random_int (),
+				       g_random_int (),
+				       g_random_int ());
+		imrp_object_set_uid (object, uid);
+		g_free (uid);
+	}
+
+	return priv->uid;
+}
@@ -79,6 +79,7 @@ GList    *  mrp_object_get_properties (MrpObject   *object);
 guint       mrp_object_get_id         (MrpObject   *object);
 gboolean    mrp_object_set_id         (MrpObject   *object,
 				       guint        id);
+const gchar *mrp_object_get_uid       (MrpObject   *object);
 
 /* FIXME: Sucks but we have a circular dependency. Could fix properly later. */
 gpointer    mrp_object_get_project    (MrpObject   *object);
@@ -209,6 +209,7 @@ old_xml_read_task (MrpParser *parser, xmlNodePtr tree, MrpTask *parent)
 	xmlNodePtr     child;
 	gchar          *name;
 	gint           id;
+	gchar         *uid;
 	mrptime        start = 0, end = 0;
 	MrpTask       *task;
 	MrpConstraint  constraint;
@@ -228,6 +229,7 @@ old_xml_read_task (MrpParser *parser, xmlNodePtr tree, MrpTask *parent)
 	name = old_xml_get_string (tree, "name");
 	note = old_xml_get_string (tree, "note");
 	id = old_xml_get_int (tree, "id");
+	uid = old_xml_get_string (tree, "uid");
 	percent_complete = old_xml_get_int (tree, "percent-complete");
 	priority = old_xml_get_int (tree, "priority");
 	type = old_xml_get_task_type (tree, "type");
@@ -317,6 +319,8 @@ old_xml_read_task (MrpParser *parser, xmlNodePtr tree, MrpTask *parent)
 	}
 
 	g_hash_table_insert (parser->task_hash, GINT_TO_POINTER (id), task);
+	imrp_object_set_uid (MRP_OBJECT (task), uid);
+	g_free (uid);
 
 	for (child = tree->children; child; child = child->next) {
 			if (!strcmp (child->name, "properties")) {
@@ -358,6 +362,7 @@ old_xml_read_resource (MrpParser *parser, xmlNodePtr tree)
 {
 	xmlNodePtr   child;
 	gint         id;
+	gchar       *uid;
 	gint         type;
 	gchar       *name, *short_name, *email;
 	gchar       *note;
@@ -375,6 +380,7 @@ old_xml_read_resource (MrpParser *parser, xmlNodePtr tree)
 	}
 
 	id          = old_xml_get_int (tree, "id");
+	uid         = old_xml_get_string (tree, "uid");
 	name        = old_xml_get_string (tree, "name");
 	short_name  = old_xml_get_string (tree, "short-name");
 	gid         = old_xml_get_int (tree, "group");
@@ -429,9 +435,11 @@ old_xml_read_resource (MrpParser *parser, xmlNodePtr tree)
 
 	g_hash_table_insert (parser->resource_hash,
 			     GINT_TO_POINTER (id), resource);
+	imrp_object_set_uid (MRP_OBJECT (resource), uid);
 
 	parser->resources = g_list_prepend (parser->resources, resource);
 
+	g_free (uid);
 	g_free (name);
 	g_free (email);
 	g_free (short_name);
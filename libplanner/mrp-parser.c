@@ -526,6 +526,7 @@ mpp_write_task_cb (MrpTask *task, MrpParser *parser)
 	}
 
 	mpp_xml_set_int (node, "id", entry->id);
+	xmlSetProp (node, "uid", imrp_object_ensure_uid (MRP_OBJECT (task)));
 	xmlSetProp (node, "name", name);
 	xmlSetProp (node, "note", note);
 	mpp_xml_set_int (node, "work", work);
@@ -665,6 +666,7 @@ mpp_write_resource (MrpParser   *parser,
 
 	resource_entry = g_hash_table_lookup (parser->resource_hash, resource);
 	mpp_xml_set_int (node, "id", resource_entry->id);
+	xmlSetProp (node, "uid", imrp_object_ensure_uid (MRP_OBJECT (resource)));
 
 	xmlSetProp (node, "name", name);
 	xmlSetProp (node, "short-name", short_name);
@@ -1178,11 +1180,10 @@ mrp_parser_from_xml (MrpStorageMrproject  *module,
 static void
 mpp_xml_set_date (xmlNodePtr node, const gchar *prop, mrptime time)
 {
-	gchar *str;
+	gchar str[MRP_TIME_STRING_LEN];
 
-	str = mrp_time_to_string (time);
+	mrp_time_to_string_buf (time, str);
 	xmlSetProp (node, prop, str);
-	g_free (str);
 }
 
 static void
@@ -49,6 +49,11 @@ void            imrp_resource_add_assignment       (MrpResource       *resource,
 						    MrpAssignment     *assignment);
 
 guint           imrp_task_get_unique_id            (MrpProject        *project);
+gboolean        imrp_project_merge                 (MrpProject        *project,
+						    MrpProject        *source);
+void            imrp_object_set_uid                (MrpObject         *object,
+						    const gchar       *uid);
+const gchar *   imrp_object_ensure_uid             (MrpObject         *object);
 
 /* Task functions. */
 gboolean          mrp_task_manager_check_predecessor (MrpTaskManager  *manager,
@@ -84,10 +89,15 @@ void              imrp_task_set_latest_start         (MrpTask         *task,
 						      mrptime          time);
 void              imrp_task_set_latest_finish        (MrpTask         *task,
 						      mrptime          time);
+void              imrp_task_set_slack                (MrpTask         *task,
+						      gint             total_slack,
+						      gint             free_slack);
 void              imrp_task_set_duration             (MrpTask         *task,
 						      gint             duration);
 void              imrp_task_set_work                 (MrpTask         *task,
 						      gint             work);
+void              imrp_task_set_critical             (MrpTask         *task,
+						      gboolean         critical);
 MrpTaskGraphNode *imrp_task_get_graph_node           (MrpTask         *task);
 MrpConstraint     imrp_task_get_constraint           (MrpTask         *task);
 void              imrp_task_set_constraint           (MrpTask         *task,
@@ -98,6 +108,7 @@ GList *           imrp_task_peek_predecessors        (MrpTask         *task);
 GList *           imrp_task_peek_successors          (MrpTask         *task);
 MrpTaskType       imrp_task_get_type                 (MrpTask         *task);
 MrpTaskSched      imrp_task_get_sched                (MrpTask         *task);
+gsize             imrp_task_get_size                 (MrpTask         *task);
 
 
 /* MrpTime funcitons. */
@@ -124,11 +135,16 @@ void imrp_calendar_replace_day                 (MrpCalendar *calendar,
 /* Signals. */
 void imrp_project_set_needs_saving (MrpProject *project,
 				    gboolean    needs_saving);
+void imrp_project_object_uid_changed (MrpProject  *project,
+				      MrpObject   *object,
+				      const gchar *old_uid);
 void imrp_object_removed           (MrpObject  *object);
 void imrp_project_task_inserted    (MrpProject *project,
 				    MrpTask    *task);
 void imrp_project_task_moved       (MrpProject *project,
 				    MrpTask    *task);
+void imrp_project_cost_changed     (MrpProject *project,
+				    MrpTask    *root);
 
 
 /* Property related stuff */
@@ -149,6 +165,12 @@ gboolean imrp_application_id_set_data          (gpointer        data,
 						guint           data_id);
 gboolean imrp_application_id_remove_data       (guint           object_id);
 
+/* MrpFileModule functions. */
+gboolean imrp_file_module_replace_reader (GList         *readers,
+					  MrpFileReader *reader);
+gboolean imrp_file_module_replace_writer (GList         *writers,
+					  MrpFileWriter *writer);
+
 
 
 
@@ -36,6 +36,38 @@
 #include "mrp-resource.h"
 #include "mrp-project.h"
 
+/* Tasks, resources or groups by name, by id and by uid, built when first
+ * needed and kept up to date after that. Groups have no uid.
+ */
+typedef struct {
+	GHashTable *by_name;	/* name -> NameEntry */
+	GHashTable *names;	/* object -> the name it's indexed by */
+	GHashTable *by_id;	/* id -> object */
+	GHashTable *by_uid;	/* uid -> object */
+	guint       stamp;	/* bumped when the objects change order */
+	gboolean    valid;
+} ProjectIndex;
+
+/* The objects sharing a name. Lookups return the first one in project
+ * order, which is remembered until the objects are reordered or it goes
+ * away. Only then is it searched for again, so that duplicates (like all
+ * the unnamed tasks) don't make every lookup walk the project.
+ */
+typedef struct {
+	guint      n_objects;
+	MrpObject *first;	/* NULL if not known */
+	guint      stamp;	/* the index stamp first was found at */
+} NameEntry;
+
+/* Where a newly indexed object is in project order, compared to the ones
+ * already indexed under the same name.
+ */
+typedef enum {
+	INDEX_POS_UNKNOWN,
+	INDEX_POS_FIRST,
+	INDEX_POS_LAST
+} IndexPos;
+
 struct _MrpProjectPriv {
 	MrpApplication   *app;
 	gchar            *uri;
@@ -70,6 +102,11 @@ struct _MrpProjectPriv {
 	/* Project phases */
 	GList            *phases;
 	gchar            *phase;
+
+	/* Lookup indexes */
+	ProjectIndex      task_index;
+	ProjectIndex      resource_index;
+	ProjectIndex      group_index;
 };
 
 /* Properties */
@@ -104,6 +141,7 @@ enum {
 	DAY_ADDED,
 	DAY_REMOVED,
 	DAY_CHANGED,
+	COST_CHANGED,
 	LAST_SIGNAL
 };
 
@@ -131,6 +169,18 @@ static gboolean project_load_from_sql             (MrpProject       *project,
 						   GError          **error);
 static gboolean project_set_storage               (MrpProject       *project,
 						   const gchar      *storage_name);
+static void     project_index_init                (ProjectIndex     *index);
+static void     project_index_destroy             (ProjectIndex     *index);
+static void     project_index_invalidate          (MrpProject       *project,
+						   ProjectIndex     *index);
+static void     project_index_add                 (MrpProject       *project,
+						   ProjectIndex     *index,
+						   MrpObject        *object,
+						   IndexPos          pos);
+static void     project_index_remove              (MrpProject       *project,
+						   ProjectIndex     *index,
+						   MrpObject        *object);
+static void     project_invalidate_indexes        (MrpProject       *project);
 #if 0
 static void     project_dump_task_tree            (MrpProject       *project);
 #endif
@@ -344,6 +394,15 @@ project_class_init (MrpProjectClass *klass)
 		 G_TYPE_NONE,
 		 1, G_TYPE_POINTER);
 
+	signals[COST_CHANGED] = g_signal_new
+		("cost_changed",
+		 G_TYPE_FROM_CLASS (klass),
+		 G_SIGNAL_RUN_LAST,
+		 0,
+		 NULL, NULL,
+		 mrp_marshal_VOID__VOID,
+		 G_TYPE_NONE, 0);
+
 	/* Properties. */
 	g_object_class_install_property (object_class,
 					 PROP_PROJECT_START,
@@ -429,6 +488,10 @@ project_init (MrpProject *project)
 	priv->property_pool = g_param_spec_pool_new (TRUE);
 	priv->task_manager  = mrp_task_manager_new (project);
 
+	project_index_init (&priv->task_index);
+	project_index_init (&priv->resource_index);
+	project_index_init (&priv->group_index);
+
 	priv->root_calendar = g_object_new (MRP_TYPE_CALENDAR,
 					    "name", "-",
 					    "project", project,
@@ -480,6 +543,10 @@ project_finalize (GObject *object)
 	g_object_unref (project->priv->primary_storage);
 	g_object_unref (project->priv->task_manager);
 
+	project_index_destroy (&project->priv->task_index);
+	project_index_destroy (&project->priv->resource_index);
+	project_index_destroy (&project->priv->group_index);
+
 	g_free (project->priv->uri);
 	g_free (project->priv);
 
@@ -665,6 +732,46 @@ mrp_project_new (MrpApplication *app)
 	return project;
 }
 
+/**
+ * mrp_project_make_uri:
+ * @path_or_uri: a URI, or an absolute or relative file name
+ *
+ * Turns a project location as given on a command line into a URI that can
+ * be passed to mrp_project_load(). URIs are returned as they are, file
+ * names are taken relative to the current directory.
+ *
+ * Return value: a newly allocated URI, or %NULL if @path_or_uri can't be
+ * turned into one.
+ **/
+gchar *
+mrp_project_make_uri (const gchar *path_or_uri)
+{
+	gchar *scheme;
+	gchar *uri;
+
+	g_return_val_if_fail (path_or_uri != NULL, NULL);
+
+	scheme = g_uri_parse_scheme (path_or_uri);
+	if (scheme != NULL) {
+		g_free (scheme);
+		return g_strdup (path_or_uri);
+	}
+
+	if (!g_path_is_absolute (path_or_uri)) {
+		gchar *cwd, *tmp;
+
+		cwd = g_get_current_dir ();
+		tmp = g_build_filename (cwd, path_or_uri, NULL);
+		uri = g_filename_to_uri (tmp, NULL, NULL);
+		g_free (tmp);
+		g_free (cwd);
+	} else {
+		uri = g_filename_to_uri (path_or_uri, NULL, NULL);
+	}
+
+	return uri;
+}
+
 /**
  * mrp_project_load:
  * @project: an #MrpProject
@@ -730,6 +837,7 @@ mrp_project_load (MrpProject *project, const gchar *uri, GError **error)
 		MrpFileReader *reader = l->data;
 
 		if (mrp_file_reader_read_string (reader, file_str, project, error)) {
+			project_invalidate_indexes (project);
 			g_signal_emit (project, signals[LOADED], 0, NULL);
 			imrp_project_set_needs_saving (project, FALSE);
 
@@ -761,6 +869,63 @@ mrp_project_load (MrpProject *project, const gchar *uri, GError **error)
 	return FALSE;
 }
 
+/**
+ * mrp_project_reload:
+ * @project: an #MrpProject
+ * @error: location to store error, or %NULL
+ *
+ * Reads the file of @project again, after it was changed by another
+ * program, and applies the differences to @project. Tasks and resources
+ * are matched on the uid saved with them, and the ones that didn't change
+ * are kept, so views only see the actual changes.
+ *
+ * If the objects can't be matched, because the file or @project has tasks
+ * or resources without a uid, @project is left alone and the error is
+ * #MRP_ERROR_RELOAD_NEEDS_LOAD. The caller should then load the file into
+ * a new project instead.
+ *
+ * Return value: Returns %TRUE on success, otherwise %FALSE.
+ **/
+gboolean
+mrp_project_reload (MrpProject *project, GError **error)
+{
+	MrpProjectPriv *priv;
+	MrpProject     *source;
+
+	g_return_val_if_fail (MRP_IS_PROJECT (project), FALSE);
+
+	priv = project->priv;
+
+	if (!priv->uri || strncmp (priv->uri, "sql://", 6) == 0) {
+		g_set_error (error,
+			     MRP_ERROR,
+			     MRP_ERROR_INVALID_URI,
+			     _("Only projects stored in a file can be reloaded"));
+		return FALSE;
+	}
+
+	source = mrp_project_new (priv->app);
+
+	if (!mrp_project_load (source, priv->uri, error)) {
+		g_object_unref (source);
+		return FALSE;
+	}
+
+	if (!imrp_project_merge (project, source)) {
+		g_set_error (error,
+			     MRP_ERROR,
+			     MRP_ERROR_RELOAD_NEEDS_LOAD,
+			     _("The changes to '%s' can't be applied, it needs to be opened again"),
+			     priv->uri);
+		g_object_unref (source);
+		return FALSE;
+	}
+
+	g_object_unref (source);
+
+	return TRUE;
+}
+
 static gboolean
 project_do_save (MrpProject   *project,
 		 const gchar  *uri,
@@ -994,6 +1159,7 @@ mrp_project_load_from_xml (MrpProject *project, const gchar *str, GError **error
 		MrpFileReader *reader = l->data;
 
 		if (mrp_file_reader_read_string (reader, str, project, error)) {
+			project_invalidate_indexes (project);
 			g_signal_emit (project, signals[LOADED], 0, NULL);
 			imrp_project_set_needs_saving (project, FALSE);
 
@@ -1069,6 +1235,7 @@ project_load_from_sql (MrpProject   *project,
 	if (mrp_storage_module_load (priv->primary_storage, uri, error)) {
 		old_default_calendar = priv->calendar;
 
+		project_invalidate_indexes (project);
 		g_signal_emit (project, signals[LOADED], 0, NULL);
 		imrp_project_set_needs_saving (project, FALSE);
 
@@ -1144,6 +1311,373 @@ imrp_project_get_task_manager (MrpProject *project)
 	return project->priv->task_manager;
 }
 
+/* Name and id indexes. */
+
+static ProjectIndex *
+project_get_index (MrpProject *project, MrpObject *object)
+{
+	if (MRP_IS_TASK (object)) {
+		return &project->priv->task_index;
+	}
+	else if (MRP_IS_RESOURCE (object)) {
+		return &project->priv->resource_index;
+	}
+	else if (MRP_IS_GROUP (object)) {
+		return &project->priv->group_index;
+	}
+
+	return NULL;
+}
+
+static void
+project_index_link_name (ProjectIndex *index,
+			 MrpObject    *object,
+			 IndexPos      pos)
+{
+	gchar     *name;
+	NameEntry *entry;
+
+	g_object_get (object, "name", &name, NULL);
+	if (!name) {
+		name = g_strdup ("");
+	}
+
+	entry = g_hash_table_lookup (index->by_name, name);
+	if (!entry) {
+		entry = g_new0 (NameEntry, 1);
+		g_hash_table_insert (index->by_name, g_strdup (name), entry);
+	}
+
+	entry->n_objects++;
+
+	if (entry->n_objects == 1 || pos == INDEX_POS_FIRST) {
+		entry->first = object;
+		entry->stamp = index->stamp;
+	}
+	else if (pos == INDEX_POS_UNKNOWN) {
+		entry->first = NULL;
+	}
+
+	g_hash_table_insert (index->names, object, name);
+}
+
+static void
+project_index_unlink_name (ProjectIndex *index, MrpObject *object)
+{
+	const gchar *name;
+	NameEntry   *entry;
+
+	name = g_hash_table_lookup (index->names, object);
+	if (!name) {
+		return;
+	}
+
+	entry = g_hash_table_lookup (index->by_name, name);
+	if (--entry->n_objects == 0) {
+		g_hash_table_remove (index->by_name, name);
+	}
+	else if (entry->first == object) {
+		entry->first = NULL;
+	}
+
+	/* Frees the name. */
+	g_hash_table_remove (index->names, object);
+}
+
+/* Returns the entry for @name, or NULL. If the entry doesn't know its first
+ * object any more, the caller finds it with project_index_has_name() and
+ * sets it with project_index_set_first().
+ */
+static NameEntry *
+project_index_lookup_name (ProjectIndex *index, const gchar *name)
+{
+	return g_hash_table_lookup (index->by_name, name);
+}
+
+static gboolean
+project_index_first_is_known (ProjectIndex *index, NameEntry *entry)
+{
+	return entry->first != NULL && entry->stamp == index->stamp;
+}
+
+static void
+project_index_set_first (ProjectIndex *index,
+			 NameEntry    *entry,
+			 MrpObject    *object)
+{
+	entry->first = object;
+	entry->stamp = index->stamp;
+}
+
+static gboolean
+project_index_has_name (ProjectIndex *index,
+			MrpObject    *object,
+			const gchar  *name)
+{
+	const gchar *indexed_name;
+
+	indexed_name = g_hash_table_lookup (index->names, object);
+
+	return indexed_name && strcmp (indexed_name, name) == 0;
+}
+
+static void
+project_object_name_notify_cb (MrpObject  *object,
+			       GParamSpec *pspec,
+			       MrpProject *project)
+{
+	ProjectIndex *index;
+
+	index = project_get_index (project, object);
+	if (!index || !index->valid) {
+		return;
+	}
+
+	project_index_unlink_name (index, object);
+	project_index_link_name (index, object, INDEX_POS_UNKNOWN);
+}
+
+/* A uid should only be used once. If a file has it twice anyway, the first
+ * object keeps it.
+ */
+static void
+project_index_link_uid (ProjectIndex *index, MrpObject *object)
+{
+	const gchar *uid;
+
+	uid = mrp_object_get_uid (object);
+	if (uid && !g_hash_table_lookup (index->by_uid, uid)) {
+		g_hash_table_insert (index->by_uid, g_strdup (uid), object);
+	}
+}
+
+static void
+project_index_unlink_uid (ProjectIndex *index,
+			  MrpObject    *object,
+			  const gchar  *uid)
+{
+	if (uid && g_hash_table_lookup (index->by_uid, uid) == object) {
+		g_hash_table_remove (index->by_uid, uid);
+	}
+}
+
+/* Called by the object when its uid is set. */
+void
+imrp_project_object_uid_changed (MrpProject  *project,
+				 MrpObject   *object,
+				 const gchar *old_uid)
+{
+	ProjectIndex *index;
+
+	g_return_if_fail (MRP_IS_PROJECT (project));
+
+	index = project_get_index (project, object);
+	if (!index || !index->valid || !g_hash_table_lookup (index->names, object)) {
+		return;
+	}
+
+	project_index_unlink_uid (index, object, old_uid);
+	project_index_link_uid (index, object);
+}
+
+static void
+project_index_init (ProjectIndex *index)
+{
+	index->by_name = g_hash_table_new_full (g_str_hash, g_str_equal,
+						g_free, g_free);
+	index->names = g_hash_table_new_full (NULL, NULL,
+					      NULL, g_free);
+	index->by_id = g_hash_table_new (NULL, NULL);
+	index->by_uid = g_hash_table_new_full (g_str_hash, g_str_equal,
+					       g_free, NULL);
+	index->stamp = 0;
+	index->valid = FALSE;
+}
+
+static gboolean
+project_index_remove_func (gpointer key,
+			   gpointer value,
+			   gpointer user_data)
+{
+	return TRUE;
+}
+
+static void
+project_index_clear (ProjectIndex *index)
+{
+	g_hash_table_foreach_remove (index->by_name, project_index_remove_func, NULL);
+	g_hash_table_foreach_remove (index->names, project_index_remove_func, NULL);
+	g_hash_table_foreach_remove (index->by_id, project_index_remove_func, NULL);
+	g_hash_table_foreach_remove (index->by_uid, project_index_remove_func, NULL);
+
+	index->valid = FALSE;
+}
+
+static void
+project_index_destroy (ProjectIndex *index)
+{
+	project_index_clear (index);
+
+	g_hash_table_destroy (index->by_name);
+	g_hash_table_destroy (index->names);
+	g_hash_table_destroy (index->by_id);
+	g_hash_table_destroy (index->by_uid);
+}
+
+static void
+project_index_disconnect_func (gpointer key,
+			       gpointer value,
+			       gpointer user_data)
+{
+	g_signal_handlers_disconnect_by_func (key,
+					      project_object_name_notify_cb,
+					      user_data);
+}
+
+/* Drops the index, it's rebuilt on the next lookup. Used when the objects
+ * are replaced wholesale, like when loading.
+ */
+static void
+project_index_invalidate (MrpProject *project, ProjectIndex *index)
+{
+	if (!index->valid) {
+		return;
+	}
+
+	g_hash_table_foreach (index->names, project_index_disconnect_func, project);
+
+	project_index_clear (index);
+}
+
+static void
+project_invalidate_indexes (MrpProject *project)
+{
+	project_index_invalidate (project, &project->priv->task_index);
+	project_index_invalidate (project, &project->priv->resource_index);
+	project_index_invalidate (project, &project->priv->group_index);
+}
+
+static void
+project_index_add (MrpProject   *project,
+		   ProjectIndex *index,
+		   MrpObject    *object,
+		   IndexPos      pos)
+{
+	if (!index->valid || g_hash_table_lookup (index->names, object)) {
+		return;
+	}
+
+	project_index_link_name (index, object, pos);
+
+	g_hash_table_insert (index->by_id,
+			     GUINT_TO_POINTER (mrp_object_get_id (object)),
+			     object);
+
+	project_index_link_uid (index, object);
+
+	g_signal_connect_object (object,
+				 "notify::name",
+				 G_CALLBACK (project_object_name_notify_cb),
+				 project,
+				 0);
+}
+
+static void
+project_index_remove (MrpProject   *project,
+		      ProjectIndex *index,
+		      MrpObject    *object)
+{
+	if (!index->valid || !g_hash_table_lookup (index->names, object)) {
+		return;
+	}
+
+	g_signal_handlers_disconnect_by_func (object,
+					      project_object_name_notify_cb,
+					      project);
+
+	project_index_unlink_name (index, object);
+
+	g_hash_table_remove (index->by_id,
+			     GUINT_TO_POINTER (mrp_object_get_id (object)));
+
+	project_index_unlink_uid (index, object, mrp_object_get_uid (object));
+}
+
+/* Used when building the index, the traversal goes in project order. */
+static gboolean
+project_index_task_func (MrpTask *task, MrpProject *project)
+{
+	project_index_add (project, &project->priv->task_index,
+			   MRP_OBJECT (task), INDEX_POS_LAST);
+
+	return FALSE;
+}
+
+static gboolean
+project_unindex_task_func (MrpTask *task, MrpProject *project)
+{
+	project_index_remove (project, &project->priv->task_index, MRP_OBJECT (task));
+
+	return FALSE;
+}
+
+static ProjectIndex *
+project_get_task_index (MrpProject *project)
+{
+	ProjectIndex *index;
+
+	index = &project->priv->task_index;
+
+	if (!index->valid) {
+		index->valid = TRUE;
+
+		mrp_project_task_traverse (project,
+					   mrp_project_get_root_task (project),
+					   (MrpTaskTraverseFunc) project_index_task_func,
+					   project);
+	}
+
+	return index;
+}
+
+static ProjectIndex *
+project_get_resource_index (MrpProject *project)
+{
+	ProjectIndex *index;
+	GList        *l;
+
+	index = &project->priv->resource_index;
+
+	if (!index->valid) {
+		index->valid = TRUE;
+
+		for (l = project->priv->resources; l; l = l->next) {
+			project_index_add (project, index, l->data, INDEX_POS_LAST);
+		}
+	}
+
+	return index;
+}
+
+static ProjectIndex *
+project_get_group_index (MrpProject *project)
+{
+	ProjectIndex *index;
+	GList        *l;
+
+	index = &project->priv->group_index;
+
+	if (!index->valid) {
+		index->valid = TRUE;
+
+		for (l = project->priv->groups; l; l = l->next) {
+			project_index_add (project, index, l->data, INDEX_POS_LAST);
+		}
+	}
+
+	return index;
+}
+
 /**
  * mrp_project_get_resource_by_name:
  * @project: an #MrpProject
@@ -1156,24 +1690,69 @@ imrp_project_get_task_manager (MrpProject *project)
 MrpResource *
 mrp_project_get_resource_by_name (MrpProject *project, const gchar *name)
 {
-	GList *resources, *l;
+	ProjectIndex *index;
+	NameEntry    *entry;
+	GList        *l;
 
 	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
 	g_return_val_if_fail (name != NULL, NULL);
 
-	/* Should we use a hash table to store these in as well? */
-	resources = mrp_project_get_resources (project);
+	index = project_get_resource_index (project);
 
-	for (l = resources; l; l = l->next) {
-		const gchar *rname;
+	entry = project_index_lookup_name (index, name);
+	if (!entry) {
+		return NULL;
+	}
 
-		rname = mrp_resource_get_name (MRP_RESOURCE (l->data));
-		if (strcmp (name, rname) == 0) {
-			return MRP_RESOURCE (l->data);
+	if (!project_index_first_is_known (index, entry)) {
+		for (l = project->priv->resources; l; l = l->next) {
+			if (project_index_has_name (index, l->data, name)) {
+				project_index_set_first (index, entry, l->data);
+				break;
+			}
 		}
 	}
 
-	return NULL;
+	return MRP_RESOURCE (entry->first);
+}
+
+/**
+ * mrp_project_get_resource_by_id:
+ * @project: an #MrpProject
+ * @id: the object id to look for
+ *
+ * Retrieves the resource in @project with the id @id, see
+ * mrp_object_get_id().
+ *
+ * Return value: an #MrpResource or %NULL if not found
+ **/
+MrpResource *
+mrp_project_get_resource_by_id (MrpProject *project, guint id)
+{
+	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
+
+	return g_hash_table_lookup (project_get_resource_index (project)->by_id,
+				    GUINT_TO_POINTER (id));
+}
+
+/**
+ * mrp_project_get_resource_by_uid:
+ * @project: an #MrpProject
+ * @uid: the uid to look for
+ *
+ * Retrieves the resource in @project with the uid @uid, see
+ * mrp_object_get_uid().
+ *
+ * Return value: an #MrpResource or %NULL if not found
+ **/
+MrpResource *
+mrp_project_get_resource_by_uid (MrpProject *project, const gchar *uid)
+{
+	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
+	g_return_val_if_fail (uid != NULL, NULL);
+
+	return g_hash_table_lookup (project_get_resource_index (project)->by_uid,
+				    uid);
 }
 
 /**
@@ -1201,6 +1780,8 @@ imrp_project_set_resources (MrpProject *project,
 
 	project->priv->resources = resources;
 
+	project_index_invalidate (project, &project->priv->resource_index);
+
 	g_list_foreach (project->priv->resources,
 			(GFunc) project_connect_object,
 			project);
@@ -1242,6 +1823,9 @@ mrp_project_add_resource (MrpProject *project, MrpResource *resource)
 
 	project_connect_object (MRP_OBJECT (resource), project);
 
+	/* Resources are appended. */
+	project_index_add (project, &priv->resource_index,
+			   MRP_OBJECT (resource), INDEX_POS_LAST);
 
 	g_signal_emit (project, signals[RESOURCE_ADDED], 0, resource);
 
@@ -1269,6 +1853,8 @@ mrp_project_remove_resource (MrpProject *project, MrpResource *resource)
 
 	priv->resources = g_list_remove (priv->resources, resource);
 
+	project_index_remove (project, &priv->resource_index, MRP_OBJECT (resource));
+
 	g_signal_emit (project, signals[RESOURCE_REMOVED], 0, resource);
 
 	imrp_project_set_needs_saving (project, TRUE);
@@ -1286,22 +1872,48 @@ mrp_project_remove_resource (MrpProject *project, MrpResource *resource)
 MrpGroup *
 mrp_project_get_group_by_name (MrpProject *project, const gchar *name)
 {
-	GList *groups, *l;
+	ProjectIndex *index;
+	NameEntry    *entry;
+	GList        *l;
 
 	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
 	g_return_val_if_fail (name != NULL, NULL);
 
-	groups = mrp_project_get_groups (project);
-	for (l = groups; l; l = l->next) {
-		const gchar *gname;
+	index = project_get_group_index (project);
+
+	entry = project_index_lookup_name (index, name);
+	if (!entry) {
+		return NULL;
+	}
 
-		gname = mrp_group_get_name (MRP_GROUP (l->data));
-		if (strcmp (gname, name) == 0) {
-			return MRP_GROUP (l->data);
+	if (!project_index_first_is_known (index, entry)) {
+		for (l = project->priv->groups; l; l = l->next) {
+			if (project_index_has_name (index, l->data, name)) {
+				project_index_set_first (index, entry, l->data);
+				break;
+			}
 		}
 	}
 
-	return NULL;
+	return MRP_GROUP (entry->first);
+}
+
+/**
+ * mrp_project_get_group_by_id:
+ * @project: an #MrpProject
+ * @id: the object id to look for
+ *
+ * Retrieves the group in @project with the id @id, see mrp_object_get_id().
+ *
+ * Return value: an #MrpGroup or %NULL if not found
+ **/
+MrpGroup *
+mrp_project_get_group_by_id (MrpProject *project, guint id)
+{
+	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
+
+	return g_hash_table_lookup (project_get_group_index (project)->by_id,
+				    GUINT_TO_POINTER (id));
 }
 
 /**
@@ -1329,6 +1941,8 @@ imrp_project_set_groups (MrpProject *project,
 
 	project->priv->groups = groups;
 
+	project_index_invalidate (project, &project->priv->group_index);
+
 	g_list_foreach (project->priv->groups,
 			(GFunc) project_connect_object,
 			project);
@@ -1358,6 +1972,10 @@ mrp_project_add_group (MrpProject *project, MrpGroup *group)
 
 	project_connect_object (MRP_OBJECT (group), project);
 
+	/* Groups are prepended. */
+	project_index_add (project, &priv->group_index,
+			   MRP_OBJECT (group), INDEX_POS_FIRST);
+
 	g_signal_emit (project, signals[GROUP_ADDED], 0, group);
 
 	imrp_project_set_needs_saving (project, TRUE);
@@ -1386,6 +2004,8 @@ mrp_project_remove_group (MrpProject *project, MrpGroup *group)
 
 	priv->groups = g_list_remove (priv->groups, group);
 
+	project_index_remove (project, &priv->group_index, MRP_OBJECT (group));
+
 	g_signal_emit (project, signals[GROUP_REMOVED], 0, group);
 
 	mrp_object_removed (MRP_OBJECT (group));
@@ -1695,17 +2315,15 @@ imrp_project_set_needs_saving (MrpProject *project, gboolean needs_saving)
  */
 
 typedef struct {
-	const gchar *name;
-	MrpTask     *task;
+	ProjectIndex *index;
+	const gchar  *name;
+	MrpTask      *task;
 } FindTaskByNameData;
 
 static gboolean
 find_task_by_name_traverse_func (MrpTask *task, FindTaskByNameData *data)
 {
-	const gchar *name;
-
-	name = mrp_task_get_name (task);
-	if (strcmp (name, data->name) == 0) {
+	if (project_index_has_name (data->index, MRP_OBJECT (task), data->name)) {
 		data->task = task;
 		return TRUE;
 	}
@@ -1718,29 +2336,79 @@ find_task_by_name_traverse_func (MrpTask *task, FindTaskByNameData *data)
  * @project: an #MrpProject
  * @name: the name to look for
  *
- * Retrieves the first task with name matching @name. Uses task_traverse to traverse all tasks.
+ * Retrieves the first task with name matching @name, in the order of
+ * mrp_project_task_traverse().
  *
  * Return value: an #MrpTask or %NULL if not found.
  **/
 MrpTask *
 mrp_project_get_task_by_name (MrpProject *project, const gchar *name)
 {
-	FindTaskByNameData *data;
-	MrpTask            *ret_val;
+	FindTaskByNameData  data;
+	ProjectIndex       *index;
+	NameEntry          *entry;
 
-	data = g_new0 (FindTaskByNameData, 1);
-	data->name = name;
-	data->task = NULL;
+	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
+	g_return_val_if_fail (name != NULL, NULL);
 
-	mrp_project_task_traverse (project,
-				   mrp_project_get_root_task (project),
-				   (MrpTaskTraverseFunc) find_task_by_name_traverse_func,
-				   data);
+	index = project_get_task_index (project);
 
-	ret_val = data->task;
-	g_free (data);
+	entry = project_index_lookup_name (index, name);
+	if (!entry) {
+		return NULL;
+	}
 
-	return ret_val;
+	if (!project_index_first_is_known (index, entry)) {
+		data.index = index;
+		data.name = name;
+		data.task = NULL;
+
+		mrp_project_task_traverse (project,
+					   mrp_project_get_root_task (project),
+					   (MrpTaskTraverseFunc) find_task_by_name_traverse_func,
+					   &data);
+
+		project_index_set_first (index, entry, MRP_OBJECT (data.task));
+	}
+
+	return MRP_TASK (entry->first);
+}
+
+/**
+ * mrp_project_get_task_by_id:
+ * @project: an #MrpProject
+ * @id: the object id to look for
+ *
+ * Retrieves the task in @project with the id @id, see mrp_object_get_id().
+ *
+ * Return value: an #MrpTask or %NULL if not found.
+ **/
+MrpTask *
+mrp_project_get_task_by_id (MrpProject *project, guint id)
+{
+	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
+
+	return g_hash_table_lookup (project_get_task_index (project)->by_id,
+				    GUINT_TO_POINTER (id));
+}
+
+/**
+ * mrp_project_get_task_by_uid:
+ * @project: an #MrpProject
+ * @uid: the uid to look for
+ *
+ * Retrieves the task in @project with the uid @uid, see mrp_object_get_uid().
+ *
+ * Return value: an #MrpTask or %NULL if not found.
+ **/
+MrpTask *
+mrp_project_get_task_by_uid (MrpProject *project, const gchar *uid)
+{
+	g_return_val_if_fail (MRP_IS_PROJECT (project), NULL);
+	g_return_val_if_fail (uid != NULL, NULL);
+
+	return g_hash_table_lookup (project_get_task_index (project)->by_uid,
+				    uid);
 }
 
 /**
@@ -1799,6 +2467,14 @@ mrp_project_remove_task (MrpProject *project,
 {
 	g_return_if_fail (MRP_IS_PROJECT (project));
 
+	/* The subtree goes with the task. */
+	if (project->priv->task_index.valid) {
+		mrp_project_task_traverse (project,
+					   task,
+					   (MrpTaskTraverseFunc) project_unindex_task_func,
+					   project);
+	}
+
 	mrp_object_removed (MRP_OBJECT (task));
 
 	mrp_task_manager_remove_task (project->priv->task_manager,
@@ -1857,11 +2533,59 @@ void
 imrp_project_task_moved (MrpProject *project,
 			 MrpTask    *task)
 {
+	/* The first task with a given name may have changed. */
+	project->priv->task_index.stamp++;
+
 	g_signal_emit (project, signals[TASK_MOVED], 0, task);
 
 	imrp_project_set_needs_saving (project, TRUE);
 }
 
+/**
+ * imrp_project_cost_changed:
+ * @project: an #MrpProject
+ * @root: the top task of the tree whose cost changed
+ *
+ * Signals "cost-changed" if @root is the root task of @project.
+ **/
+void
+imrp_project_cost_changed (MrpProject *project,
+			   MrpTask    *root)
+{
+	MrpTaskManager *manager;
+
+	manager = project->priv->task_manager;
+	if (!manager || mrp_task_manager_get_root (manager) != root) {
+		return;
+	}
+
+	g_signal_emit (project, signals[COST_CHANGED], 0);
+}
+
+/**
+ * mrp_project_get_cost:
+ * @project: an #MrpProject
+ *
+ * Retrieves the total cost of @project. The "cost-changed" signal is emitted
+ * when it changes.
+ *
+ * Return value: the cost of all the tasks in @project
+ **/
+gfloat
+mrp_project_get_cost (MrpProject *project)
+{
+	MrpTask *root;
+
+	g_return_val_if_fail (MRP_IS_PROJECT (project), 0);
+
+	root = mrp_project_get_root_task (project);
+	if (!root) {
+		return 0;
+	}
+
+	return mrp_task_get_cost (root);
+}
+
 /**
  * mrp_project_get_root_task:
  * @project: an #MrpProject
@@ -1985,6 +2709,9 @@ imrp_project_task_inserted (MrpProject *project, MrpTask *task)
 {
 	g_return_if_fail (MRP_IS_PROJECT (project));
 
+	project_index_add (project, &project->priv->task_index,
+			   MRP_OBJECT (task), INDEX_POS_UNKNOWN);
+
 	g_signal_emit (project, signals[TASK_INSERTED], 0, task);
 
 	imrp_project_set_needs_saving (project, TRUE);
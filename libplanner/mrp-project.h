@@ -61,9 +61,12 @@ gboolean         mrp_project_needs_saving             (MrpProject           *pro
 mrptime          mrp_project_get_project_start        (MrpProject           *project);
 void             mrp_project_set_project_start        (MrpProject           *project,
 						       mrptime               start);
+gchar           *mrp_project_make_uri                 (const gchar          *path_or_uri);
 gboolean         mrp_project_load                     (MrpProject           *project,
 						       const gchar          *uri,
 						       GError              **error);
+gboolean         mrp_project_reload                   (MrpProject           *project,
+						       GError              **error);
 gboolean         mrp_project_save                     (MrpProject           *project,
 						       gboolean              force,
 						       GError              **error);
@@ -88,6 +91,10 @@ void             mrp_project_set_uri                  (MrpProject           *pro
 						       const gchar          *uri);
 MrpResource *    mrp_project_get_resource_by_name     (MrpProject           *project,
 						       const gchar          *name);
+MrpResource *    mrp_project_get_resource_by_id       (MrpProject           *project,
+						       guint                 id);
+MrpResource *    mrp_project_get_resource_by_uid      (MrpProject           *project,
+						       const gchar          *uid);
 GList           *mrp_project_get_resources            (MrpProject           *project);
 void             mrp_project_add_resource             (MrpProject           *project,
 						       MrpResource          *resource);
@@ -95,6 +102,8 @@ void             mrp_project_remove_resource          (MrpProject           *pro
 						       MrpResource          *resource);
 MrpGroup        *mrp_project_get_group_by_name        (MrpProject           *project,
 						       const gchar          *name);
+MrpGroup        *mrp_project_get_group_by_id          (MrpProject           *project,
+						       guint                 id);
 GList           *mrp_project_get_groups               (MrpProject           *project);
 void             mrp_project_add_group                (MrpProject           *project,
 						       MrpGroup             *group);
@@ -102,6 +111,10 @@ void             mrp_project_remove_group             (MrpProject           *pro
 						       MrpGroup             *group);
 MrpTask         *mrp_project_get_task_by_name         (MrpProject           *project,
 						       const gchar          *name);
+MrpTask         *mrp_project_get_task_by_id           (MrpProject           *project,
+						       guint                 id);
+MrpTask         *mrp_project_get_task_by_uid          (MrpProject           *project,
+						       const gchar          *uid);
 GList           *mrp_project_get_all_tasks            (MrpProject           *project);
 void             mrp_project_insert_task              (MrpProject           *project,
 						       MrpTask              *parent,
@@ -116,6 +129,7 @@ gboolean         mrp_project_move_task                (MrpProject           *pro
 						       gboolean              before,
 						       GError              **error);
 MrpTask         *mrp_project_get_root_task            (MrpProject           *project);
+gfloat           mrp_project_get_cost                 (MrpProject           *project);
 void             mrp_project_task_traverse            (MrpProject           *project,
 						       MrpTask              *root,
 						       MrpTaskTraverseFunc   func,
@@ -41,7 +41,11 @@ struct _MrpResourcePriv {
         gint             units;
         gchar           *email;
         gchar           *note;
+
+	/* Assignments newest first, and their links keyed by task. */
 	GList           *assignments;
+	GHashTable      *assignment_links;
+	gboolean         duplicate_assignments;
 
 	MrpCalendar     *calendar;
 	gfloat           cost;
@@ -236,6 +240,7 @@ resource_init (MrpResource *resource)
         priv = g_new0 (MrpResourcePriv, 1);
 
 	priv->assignments = NULL;
+	priv->assignment_links = g_hash_table_new (NULL, NULL);
 	priv->type        = MRP_RESOURCE_TYPE_NONE;
         priv->name        = g_strdup ("");
 	priv->short_name    = g_strdup ("");
@@ -264,6 +269,8 @@ resource_finalize (GObject *object)
 		g_object_unref (priv->calendar);
 	}
 
+	g_hash_table_destroy (priv->assignment_links);
+
 	g_free (priv);
 	resource->priv = NULL;
 
@@ -507,6 +514,12 @@ resource_invalidate_task_cost_foreach (MrpAssignment *assignment,
 	mrp_task_invalidate_cost (mrp_assignment_get_task (assignment));
 }
 
+static gboolean
+resource_remove_link_func (gpointer key, gpointer value, gpointer user_data)
+{
+	return TRUE;
+}
+
 static void
 resource_removed (MrpObject *object)
 {
@@ -525,6 +538,11 @@ resource_removed (MrpObject *object)
 	g_list_free (priv->assignments);
 	priv->assignments = NULL;
 
+	g_hash_table_foreach_remove (priv->assignment_links,
+				     resource_remove_link_func,
+				     NULL);
+	priv->duplicate_assignments = FALSE;
+
         if (MRP_OBJECT_CLASS (parent_class)->removed) {
                 (* MRP_OBJECT_CLASS (parent_class)->removed) (object);
         }
@@ -540,6 +558,37 @@ resource_group_removed_cb (MrpGroup     *group,
 	mrp_object_set (MRP_OBJECT (resource), "group", NULL, NULL);
 }
 
+static void
+resource_unlink_assignment (MrpResource   *resource,
+			    MrpTask       *task,
+			    MrpAssignment *assignment)
+{
+	MrpResourcePriv *priv;
+	GList           *link, *l;
+
+	priv = resource->priv;
+
+	link = g_hash_table_lookup (priv->assignment_links, task);
+
+	if (!link || link->data != assignment) {
+		priv->assignments = g_list_remove (priv->assignments, assignment);
+		return;
+	}
+
+	priv->assignments = g_list_delete_link (priv->assignments, link);
+	g_hash_table_remove (priv->assignment_links, task);
+
+	/* Let the next assignment to the same task take over, if any. */
+	if (priv->duplicate_assignments) {
+		for (l = priv->assignments; l; l = l->next) {
+			if (mrp_assignment_get_task (l->data) == task) {
+				g_hash_table_insert (priv->assignment_links, task, l);
+				break;
+			}
+		}
+	}
+}
+
 static void
 resource_assignment_removed_cb (MrpAssignment *assignment,
 				MrpResource *resource)
@@ -559,7 +608,7 @@ resource_assignment_removed_cb (MrpAssignment *assignment,
 		return;
 	}
 
-	priv->assignments = g_list_remove (priv->assignments, assignment);
+	resource_unlink_assignment (resource, task, assignment);
 
 	g_signal_emit (resource, signals[ASSIGNMENT_REMOVED],
 		       0,
@@ -591,6 +640,7 @@ void
 imrp_resource_add_assignment (MrpResource *resource, MrpAssignment *assignment)
 {
 	MrpResourcePriv *priv;
+	MrpTask         *task;
 
 	g_return_if_fail (MRP_IS_RESOURCE (resource));
 	g_return_if_fail (MRP_IS_ASSIGNMENT (assignment));
@@ -600,6 +650,12 @@ imrp_resource_add_assignment (MrpResource *resource, MrpAssignment *assignment)
 	priv->assignments = g_list_prepend (priv->assignments,
 					    g_object_ref (assignment));
 
+	task = mrp_assignment_get_task (assignment);
+	if (g_hash_table_lookup (priv->assignment_links, task)) {
+		priv->duplicate_assignments = TRUE;
+	}
+	g_hash_table_insert (priv->assignment_links, task, priv->assignments);
+
 	g_signal_connect (G_OBJECT (assignment),
 			  "removed",
 			  G_CALLBACK (resource_assignment_removed_cb),
@@ -736,6 +792,29 @@ mrp_resource_get_assignments (MrpResource *resource)
 	return resource->priv->assignments;
 }
 
+/**
+ * mrp_resource_get_assignment:
+ * @resource: an #MrpResource
+ * @task: an #MrpTask
+ *
+ * Retrieves the #MrpAssignment of @resource on @task, the counterpart of
+ * mrp_task_get_assignment().
+ *
+ * Return value: The assignment if it exists, otherwise %NULL.
+ **/
+MrpAssignment *
+mrp_resource_get_assignment (MrpResource *resource, MrpTask *task)
+{
+	GList *link;
+
+	g_return_val_if_fail (MRP_IS_RESOURCE (resource), NULL);
+	g_return_val_if_fail (MRP_IS_TASK (task), NULL);
+
+	link = g_hash_table_lookup (resource->priv->assignment_links, task);
+
+	return link ? link->data : NULL;
+}
+
 /**
  * mrp_resource_get_assigned_tasks:
  * @resource: an #MrpResource
@@ -823,3 +902,127 @@ mrp_resource_set_calendar (MrpResource *resource, MrpCalendar *calendar)
 
 	g_object_set (resource, "calendar", calendar, NULL);
 }
+
+/**
+ * mrp_resource_get_cost:
+ * @resource: an #MrpResource
+ *
+ * Retrieves the standard cost of @resource, per hour.
+ *
+ * Return value: the cost of @resource.
+ **/
+gfloat
+mrp_resource_get_cost (MrpResource *resource)
+{
+	g_return_val_if_fail (MRP_IS_RESOURCE (resource), 0);
+
+	return resource->priv->cost;
+}
+
+/**
+ * mrp_resource_set_cost:
+ * @resource: an #MrpResource
+ * @cost: the standard cost per hour
+ *
+ * Sets the standard cost of @resource. This is the same as setting the "cost"
+ * property without going through the property machinery.
+ **/
+void
+mrp_resource_set_cost (MrpResource *resource, gfloat cost)
+{
+	MrpResourcePriv *priv;
+
+	g_return_if_fail (MRP_IS_RESOURCE (resource));
+
+	priv = resource->priv;
+
+	if (priv->cost == cost) {
+		return;
+	}
+
+	priv->cost = cost;
+	resource_invalidate_task_costs (resource);
+
+	mrp_object_changed (MRP_OBJECT (resource));
+	g_object_notify (G_OBJECT (resource), "cost");
+}
+
+/**
+ * mrp_resource_get_group:
+ * @resource: an #MrpResource
+ *
+ * Retrieves the group that @resource belongs to.
+ *
+ * Return value: an #MrpGroup, or %NULL if @resource is not in a group.
+ **/
+MrpGroup *
+mrp_resource_get_group (MrpResource *resource)
+{
+	g_return_val_if_fail (MRP_IS_RESOURCE (resource), NULL);
+
+	return resource->priv->group;
+}
+
+/**
+ * mrp_resource_get_resource_type:
+ * @resource: an #MrpResource
+ *
+ * Retrieves the type of @resource, work or material.
+ *
+ * Return value: the type of @resource.
+ **/
+MrpResourceType
+mrp_resource_get_resource_type (MrpResource *resource)
+{
+	g_return_val_if_fail (MRP_IS_RESOURCE (resource), MRP_RESOURCE_TYPE_NONE);
+
+	return resource->priv->type;
+}
+
+/**
+ * mrp_resource_get_units:
+ * @resource: an #MrpResource
+ *
+ * Retrieves the number of units of @resource that are available.
+ *
+ * Return value: the number of units.
+ **/
+gint
+mrp_resource_get_units (MrpResource *resource)
+{
+	g_return_val_if_fail (MRP_IS_RESOURCE (resource), 0);
+
+	return resource->priv->units;
+}
+
+/**
+ * mrp_resource_get_email:
+ * @resource: an #MrpResource
+ *
+ * Retrieves the email address of @resource.
+ *
+ * Return value: the email address, owned by @resource.
+ **/
+const gchar *
+mrp_resource_get_email (MrpResource *resource)
+{
+	g_return_val_if_fail (MRP_IS_RESOURCE (resource), NULL);
+
+	return resource->priv->email;
+}
+
+/**
+ * mrp_resource_get_note:
+ * @resource: an #MrpResource
+ *
+ * Retrieves the note of @resource.
+ *
+ * Return value: the note, owned by @resource.
+ **/
+const gchar *
+mrp_resource_get_note (MrpResource *resource)
+{
+	g_return_val_if_fail (MRP_IS_RESOURCE (resource), NULL);
+
+	return resource->priv->note;
+}
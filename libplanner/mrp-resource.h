@@ -69,6 +69,9 @@ void            mrp_resource_assign             (MrpResource     *resource,
 
 GList *         mrp_resource_get_assignments    (MrpResource     *resource);
 
+MrpAssignment * mrp_resource_get_assignment     (MrpResource     *resource,
+						 MrpTask         *task);
+
 GList *         mrp_resource_get_assigned_tasks (MrpResource     *resource);
 
 gint            mrp_resource_compare            (gconstpointer    a,
@@ -79,5 +82,14 @@ MrpCalendar *   mrp_resource_get_calendar       (MrpResource     *resource);
 void            mrp_resource_set_calendar       (MrpResource     *resource,
 						 MrpCalendar     *calendar);
 
+gfloat          mrp_resource_get_cost           (MrpResource     *resource);
+void            mrp_resource_set_cost           (MrpResource     *resource,
+						 gfloat           cost);
+MrpGroup *      mrp_resource_get_group          (MrpResource     *resource);
+MrpResourceType mrp_resource_get_resource_type  (MrpResource     *resource);
+gint            mrp_resource_get_units          (MrpResource     *resource);
+const gchar *   mrp_resource_get_email          (MrpResource     *resource);
+const gchar *   mrp_resource_get_note           (MrpResource     *resource);
+
 
 #endif /* __MRP_RESOURCE_H__ */
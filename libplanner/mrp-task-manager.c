@@ -33,6 +33,7 @@
 #include "mrp-private.h"
 #include "mrp-time.h"
 #include "mrp-error.h"
+#include "mrp-trace.h"
 
 struct _MrpTaskManagerPriv {
 	MrpProject *project;
@@ -1367,8 +1368,6 @@ task_manager_get_task_units_intervals (MrpTaskManager *manager,
 	MrpUnitsInterval   *unit_ival_start_cmp;
 	MrpUnitsInterval   *split_unit_ival;
 	MrpAssignment      *v_assignment;
-	MrpResource        *v_resource;
-	GList              *v_assignments, *v_a;
 	gint                v_units;
 	GList              *v_tasks, *v_l;
 	GPtrArray          *array_split;
@@ -1428,76 +1427,69 @@ task_manager_get_task_units_intervals (MrpTaskManager *manager,
 				}
 
 				/* Compare resources task with resources of dominant task. */
-				v_assignments = mrp_task_get_assignments (v_task);
-
-				for (v_a = v_assignments; v_a; v_a = v_a->next) {
-					v_assignment = v_a->data;
-
-					v_resource = mrp_assignment_get_resource (v_assignment);
-					if (v_resource == resource) {
-						v_units = mrp_assignment_get_units (v_assignment);
-						/*
-						   If the dominant cost is compatible with the task
-						   request -> break.
-
-						   FIXME - tasks that share the vampirised resource not work!
-						*/
-						if (100 - v_units > units) {
-							break;
-						}
-
-						/* Trim the interval of the dominant task. */
-						v_start = (v_start < i_start ?
-								   i_start : v_start);
-						v_end = (v_end > i_end ?
-								 i_end : v_end);
-
-						if (i_start < v_start) {
-							/*
-							     ----...
-							   ------...
-							   ival len from start to dominant
-							*/
-							ival = mrp_interval_new (i_start-date, v_start-date);
-
-							unit_ival_start = units_interval_new (ival, units, TRUE);
-							unit_ival_start->units_full = units;
-							unit_ival_end = units_interval_new (ival, units, FALSE);
-							unit_ival_end->units_full = units;
-							g_ptr_array_add (array, unit_ival_start);
-							g_ptr_array_add (array, unit_ival_end);
-						}
-
-						ival = mrp_interval_new (v_start-date, v_end-date);
-
-						unit_ival_start = units_interval_new (ival, (100 - v_units), TRUE);
-						unit_ival_start->units_full = units;
-						unit_ival_end = units_interval_new (ival, (100 - v_units), FALSE);
-						unit_ival_end->units_full = units;
-						g_ptr_array_add (array, unit_ival_start);
-						g_ptr_array_add (array, unit_ival_end);
-
-						if (v_end < i_end) {
-							/*
-							   ----  ...
-							   ------...
-							   ival len from end to dominant
-							*/
-							ival = mrp_interval_new (v_end-date, i_end-date);
-
-							unit_ival_start = units_interval_new (ival, units, TRUE);
-							unit_ival_start->units_full = units;
-							unit_ival_end = units_interval_new (ival, units, FALSE);
-							unit_ival_end->units_full = units;
-							g_ptr_array_add (array, unit_ival_start);
-							g_ptr_array_add (array, unit_ival_end);
-						}
-						break;
-					}
-				} /* for (v_a = v_assignments; v_a; ... */
-				if (v_a != NULL) {
+				v_assignment = mrp_task_get_assignment (v_task, resource);
+				if (!v_assignment) {
+					continue;
+				}
+
+				v_units = mrp_assignment_get_units (v_assignment);
+				/*
+				   If the dominant cost is compatible with the task
+				   request -> break.
+
+				   FIXME - tasks that share the vampirised resource not work!
+				*/
+				if (100 - v_units > units) {
 					break;
 				}
+
+				/* Trim the interval of the dominant task. */
+				v_start = (v_start < i_start ?
+						   i_start : v_start);
+				v_end = (v_end > i_end ?
+						 i_end : v_end);
+
+				if (i_start < v_start) {
+					/*
+					     ----...
+					   ------...
+					   ival len from start to dominant
+					*/
+					ival = mrp_interval_new (i_start-date, v_start-date);
+
+					unit_ival_start = units_interval_new (ival, units, TRUE);
+					unit_ival_start->units_full = units;
+					unit_ival_end = units_interval_new (ival, units, FALSE);
+					unit_ival_end->units_full = units;
+					g_ptr_array_add (array, unit_ival_start);
+					g_ptr_array_add (array, unit_ival_end);
+				}
+
+				ival = mrp_interval_new (v_start-date, v_end-date);
+
+				unit_ival_start = units_interval_new (ival, (100 - v_units), TRUE);
+				unit_ival_start->units_full = units;
+				unit_ival_end = units_interval_new (ival, (100 - v_units), FALSE);
+				unit_ival_end->units_full = units;
+				g_ptr_array_add (array, unit_ival_start);
+				g_ptr_array_add (array, unit_ival_end);
+
+				if (v_end < i_end) {
+					/*
+					   ----  ...
+					   ------...
+					   ival len from end to dominant
+					*/
+					ival = mrp_interval_new (v_end-date, i_end-date);
+
+					unit_ival_start = units_interval_new (ival, units, TRUE);
+					unit_ival_start->units_full = units;
+					unit_ival_end = units_interval_new (ival, units, FALSE);
+					unit_ival_end->units_full = units;
+					g_ptr_array_add (array, unit_ival_start);
+					g_ptr_array_add (array, unit_ival_end);
+				}
+				break;
 			} /* for (v_l = v_tasks; v_l; ... */
 
 
@@ -2124,25 +2116,35 @@ task_manager_do_forward_pass_helper (MrpTaskManager *manager,
 				GList         *assignments, *a;
 				MrpAssignment *assignment;
 				gint           n, units;
+				gboolean       changed = FALSE;
 
 				assignments = mrp_task_get_assignments (task);
 
-				n = g_list_length (assignments);
+				n = mrp_task_get_nres (task);
 				units = floor (0.5 + 100.0 * (gdouble) work / duration / n);
 
 				for (a = assignments; a; a = a->next) {
 					assignment = a->data;
 
+					if (mrp_assignment_get_units (assignment) == units) {
+						continue;
+					}
+
 					g_signal_handlers_block_by_func (assignment,
 									 task_manager_assignment_units_notify_cb,
 									 manager);
 
-					g_object_set (assignment, "units", units, NULL);
+					mrp_assignment_set_units (assignment, units);
+					changed = TRUE;
 
 					g_signal_handlers_unblock_by_func (assignment,
 									   task_manager_assignment_units_notify_cb,
 									   manager);
 				}
+
+				if (changed) {
+					mrp_task_invalidate_cost (task);
+				}
 			}
 		}
 	}
@@ -2201,7 +2203,9 @@ task_manager_do_backward_pass (MrpTaskManager *manager)
 	GList              *successors, *s;
 	mrptime             project_finish;
 	mrptime             t1, t2;
+	mrptime             free_finish, finish;
 	gint                duration;
+	gint                total_slack, free_slack;
 	gboolean            critical;
 	gboolean            was_critical;
 
@@ -2223,6 +2227,11 @@ task_manager_do_backward_pass (MrpTaskManager *manager)
 			t1 = MIN (project_finish, mrp_task_get_latest_finish (parent));
 		}
 
+		/* The latest finish that doesn't push any successor, for the
+		 * free slack.
+		 */
+		free_finish = t1;
+
 		successors = imrp_task_peek_successors (task);
 		for (s = successors; s; s = s->next) {
 			MrpRelation *relation;
@@ -2243,6 +2252,11 @@ task_manager_do_backward_pass (MrpTaskManager *manager)
 						mrp_relation_get_lag (relation);
 
 					t1 = MIN (t1, t2);
+
+					t2 = mrp_task_get_start (successor) -
+						mrp_relation_get_lag (relation);
+
+					free_finish = MIN (free_finish, t2);
 				}
 			} else {
 				/* No children, check the real successor. */
@@ -2250,11 +2264,39 @@ task_manager_do_backward_pass (MrpTaskManager *manager)
 					mrp_relation_get_lag (relation);
 
 				t1 = MIN (t1, t2);
+
+				t2 = mrp_task_get_start (successor) -
+					mrp_relation_get_lag (relation);
+
+				free_finish = MIN (free_finish, t2);
 			}
 		}
 
 		imrp_task_set_latest_finish (task, t1);
 
+		/* Work out the slack here once, so that views don't have to
+		 * walk the calendar every time they show it. We don't support
+		 * negative slack.
+		 */
+		finish = mrp_task_get_finish (task);
+		free_finish = MIN (free_finish, t1);
+
+		if (t1 > finish) {
+			total_slack = mrp_project_calculate_summary_duration (
+				priv->project, task, finish, t1);
+		} else {
+			total_slack = 0;
+		}
+
+		if (free_finish > finish) {
+			free_slack = mrp_project_calculate_summary_duration (
+				priv->project, task, finish, free_finish);
+		} else {
+			free_slack = 0;
+		}
+
+		imrp_task_set_slack (task, total_slack, free_slack);
+
 		/* Use the calendar duration to get the actual latest start, or
 		 * calendars will make this break.
 		 */
@@ -2281,7 +2323,7 @@ task_manager_do_backward_pass (MrpTaskManager *manager)
 #endif
 
 		if (was_critical != critical) {
-			g_object_set (task, "critical", critical, NULL);
+			imrp_task_set_critical (task, critical);
 		}
 	}
 
@@ -2342,6 +2384,8 @@ mrp_task_manager_recalc (MrpTaskManager *manager,
 {
 	MrpTaskManagerPriv *priv;
 	MrpProject         *project;
+	GList              *tasks;
+	gint64              start;
 
 	g_return_if_fail (MRP_IS_TASK_MANAGER (manager));
 	g_return_if_fail (manager->priv->root != NULL);
@@ -2376,13 +2420,28 @@ mrp_task_manager_recalc (MrpTaskManager *manager,
 
 	priv->in_recalc = TRUE;
 
+	start = mrp_trace_now ();
+
 	if (priv->needs_rebuild) {
 		mrp_task_manager_rebuild (manager);
 	}
 
+	/* Hold back the notifications until both passes are done, so that
+	 * each changed property is only notified once and listeners see the
+	 * final values.
+	 */
+	tasks = mrp_task_manager_get_all_tasks (manager);
+	tasks = g_list_prepend (tasks, priv->root);
+	g_list_foreach (tasks, (GFunc) g_object_freeze_notify, NULL);
+
 	task_manager_do_forward_pass (manager, NULL);
 	task_manager_do_backward_pass (manager);
 
+	g_list_foreach (tasks, (GFunc) g_object_thaw_notify, NULL);
+	g_list_free (tasks);
+
+	mrp_trace_complete ("recalc", start, NULL);
+
 	priv->needs_recalc = FALSE;
 	priv->in_recalc = FALSE;
 }
@@ -45,7 +45,9 @@ enum {
 	PROP_CONSTRAINT,
 	PROP_NOTE,
 	PROP_PERCENT_COMPLETE,
-	PROP_PRIORITY
+	PROP_PRIORITY,
+	PROP_TOTAL_SLACK,
+	PROP_FREE_SLACK
 };
 
 /* Signals */
@@ -96,8 +98,9 @@ struct _MrpTaskPriv {
 	/* Calculated duration. */
 	gint              duration;
 
-	/* Slack. */
-	gint              slack;
+	/* Slack in working time, calculated in the backward pass. */
+	gint              total_slack;
+	gint              free_slack;
 
 	/* Calculated start and finish values. */
 	mrptime           start;
@@ -122,14 +125,20 @@ struct _MrpTaskPriv {
 
 	MrpConstraint     constraint;
 
-	/* List of assignments. */
+	/* List of assignments, newest first, and the link of each one keyed
+	 * by resource.
+	 */
 	GList            *assignments;
+	GHashTable       *assignment_links;
+	gboolean          duplicate_assignments;
 
 	/* Intervals to build graphical view of the task */
 	GList            *unit_ivals;
 
-	gfloat            cost;
-	gboolean          cost_cached;
+	/* Cost of the task, kept up to date. For summary tasks it's the sum
+	 * of the children's costs.
+	 */
+	gdouble           cost;
 };
 
 
@@ -192,12 +201,12 @@ task_init (MrpTask *task)
 	priv->name = g_strdup ("");
 	priv->node = g_node_new (task);
 	priv->assignments = NULL;
+	priv->assignment_links = g_hash_table_new (NULL, NULL);
 	priv->constraint.type = MRP_CONSTRAINT_ASAP;
 	priv->graph_node = g_new0 (MrpTaskGraphNode, 1);
 	priv->note = g_strdup ("");
 
 	priv->cost = 0.0;
-	priv->cost_cached = FALSE;
 	priv->unit_ivals = NULL;
 }
 
@@ -403,6 +412,24 @@ task_class_init (MrpTaskClass *klass)
 				  "Priority of the task",
 				  0, 9999, 0,
 				  G_PARAM_READWRITE));
+
+	g_object_class_install_property (
+		object_class,
+		PROP_TOTAL_SLACK,
+		g_param_spec_int ("total_slack",
+				  "Total slack",
+				  "Time the task can slip without delaying the project",
+				  0, G_MAXINT, 0,
+				  G_PARAM_READABLE));
+
+	g_object_class_install_property (
+		object_class,
+		PROP_FREE_SLACK,
+		g_param_spec_int ("free_slack",
+				  "Free slack",
+				  "Time the task can slip without delaying any successor",
+				  0, G_MAXINT, 0,
+				  G_PARAM_READABLE));
 }
 
 static void
@@ -427,6 +454,8 @@ task_finalize (GObject *object)
 	g_node_destroy (priv->node);
 	g_free (priv->graph_node);
 
+	g_hash_table_destroy (priv->assignment_links);
+
 	g_free (priv);
 	task->priv = NULL;
 
@@ -443,35 +472,17 @@ task_set_property (GObject      *object,
 {
 	MrpTask     *task;
 	MrpTaskPriv *priv;
-	const gchar *str;
-	gint         i_val;
-	MrpTaskType  type;
-	gboolean     changed = FALSE;
 
 	task = MRP_TASK (object);
 	priv = task->priv;
 
 	switch (prop_id) {
 	case PROP_NAME:
-		str = g_value_get_string (value);
-
-		if (!priv->name || strcmp (priv->name, str)) {
-			g_free (task->priv->name);
-			priv->name = g_strdup (str);
-			changed = TRUE;
-		}
-
+		mrp_task_set_name (task, g_value_get_string (value));
 		break;
 
 	case PROP_NOTE:
-		str = g_value_get_string (value);
-
-		if (!priv->note || strcmp (priv->note, str)) {
-			g_free (task->priv->note);
-			priv->note = g_strdup (str);
-			changed = TRUE;
-		}
-
+		mrp_task_set_note (task, g_value_get_string (value));
 		break;
 
 	case PROP_START:
@@ -483,43 +494,11 @@ task_set_property (GObject      *object,
 		break;
 
 	case PROP_DURATION:
-		if (mrp_task_get_n_children (task) > 0 ||
-		    priv->type == MRP_TASK_TYPE_MILESTONE) {
-			return;
-		}
-
-		if (priv->sched == MRP_TASK_SCHED_FIXED_WORK) {
-			return;
-		}
-
-		i_val = g_value_get_int (value);
-
-		if (priv->duration != i_val) {
-			priv->duration = i_val;
-
-			g_object_notify (object, "work");
-			changed = TRUE;
-
-			mrp_task_invalidate_cost (task);
-		}
+		mrp_task_set_duration (task, g_value_get_int (value));
 		break;
 
 	case PROP_WORK:
-		if (mrp_task_get_n_children (task) > 0 ||
-		    priv->type == MRP_TASK_TYPE_MILESTONE) {
-			return;
-		}
-
-		i_val = g_value_get_int (value);
-
-		if (priv->work != i_val) {
-			priv->work = i_val;
-
-			g_object_notify (object, "duration");
-			changed = TRUE;
-
-			mrp_task_invalidate_cost (task);
-		}
+		mrp_task_set_work (task, g_value_get_int (value));
 		break;
 
 	case PROP_CRITICAL:
@@ -527,66 +506,28 @@ task_set_property (GObject      *object,
 		break;
 
 	case PROP_TYPE:
-		type = g_value_get_enum (value);
-		if (type != priv->type) {
-			priv->type = type;
-
-			if (type == MRP_TASK_TYPE_MILESTONE) {
-				priv->duration = 0;
-				priv->work = 0;
-			} else {
-				/* FIXME: we need a way to specify a default
-				 * work/duration for tasks.
-				 */
-				priv->duration = 60*60*8;
-				priv->work = 60*60*8;
-			}
-
-			g_object_notify (G_OBJECT (task), "duration");
-			g_object_notify (G_OBJECT (task), "work");
-
-			changed = TRUE;
-		}
+		mrp_task_set_task_type (task, g_value_get_enum (value));
 		break;
 
 	case PROP_SCHED:
-		priv->sched = g_value_get_enum (value);
-		changed = TRUE;
+		mrp_task_set_sched (task, g_value_get_enum (value));
 		break;
 
 	case PROP_CONSTRAINT:
-		/* FIXME: compare */
-		priv->constraint = *(MrpConstraint *) g_value_get_boxed (value);
-		changed = TRUE;
+		mrp_task_set_constraint (task, g_value_get_boxed (value));
 		break;
 
 	case PROP_PERCENT_COMPLETE:
-		i_val = g_value_get_int (value);
-
-		if (priv->percent_complete != i_val) {
-			priv->percent_complete = i_val;
-			changed = TRUE;
-		}
-
+		mrp_task_set_percent_complete (task, g_value_get_int (value));
 		break;
 
 	case PROP_PRIORITY:
-		i_val = g_value_get_int (value);
-
-		if (priv->priority != i_val) {
-			priv->priority = i_val;
-			changed = TRUE;
-		}
-
+		mrp_task_set_priority (task, g_value_get_int (value));
 		break;
 
 	default:
 		break;
 	}
-
-	if (changed) {
-		mrp_object_changed (MRP_OBJECT (object));
-	}
 }
 
 static void
@@ -644,6 +585,12 @@ task_get_property (GObject    *object,
 	case PROP_PRIORITY:
 		g_value_set_int (value, priv->priority);
 		break;
+	case PROP_TOTAL_SLACK:
+		g_value_set_int (value, priv->total_slack);
+		break;
+	case PROP_FREE_SLACK:
+		g_value_set_int (value, priv->free_slack);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -667,6 +614,45 @@ task_removed (MrpObject *object)
         }
 }
 
+static void
+task_unlink_assignment (MrpTask *task, MrpAssignment *assignment)
+{
+	MrpTaskPriv *priv;
+	MrpResource *resource;
+	GList       *link, *l;
+
+	priv = task->priv;
+
+	resource = mrp_assignment_get_resource (assignment);
+	link = g_hash_table_lookup (priv->assignment_links, resource);
+
+	if (!link || link->data != assignment) {
+		priv->assignments = g_list_remove (priv->assignments, assignment);
+		return;
+	}
+
+	priv->assignments = g_list_delete_link (priv->assignments, link);
+	g_hash_table_remove (priv->assignment_links, resource);
+
+	/* The same resource can be assigned more than once, in that case the
+	 * next one in the list takes over.
+	 */
+	if (priv->duplicate_assignments) {
+		for (l = priv->assignments; l; l = l->next) {
+			if (mrp_assignment_get_resource (l->data) == resource) {
+				g_hash_table_insert (priv->assignment_links, resource, l);
+				break;
+			}
+		}
+	}
+}
+
+static gboolean
+task_remove_link_func (gpointer key, gpointer value, gpointer user_data)
+{
+	return TRUE;
+}
+
 static void
 task_assignment_removed_cb (MrpAssignment *assignment, MrpTask *task)
 {
@@ -677,7 +663,9 @@ task_assignment_removed_cb (MrpAssignment *assignment, MrpTask *task)
 
 	priv = task->priv;
 
-	priv->assignments = g_list_remove (priv->assignments, assignment);
+	task_unlink_assignment (task, assignment);
+
+	mrp_task_invalidate_cost (task);
 
 	g_signal_emit (task, signals[ASSIGNMENT_REMOVED], 0, assignment);
 	g_object_unref (assignment);
@@ -750,6 +738,11 @@ task_remove_assignments (MrpTask *task)
 	g_list_free (copy);
 
 	priv->assignments = NULL;
+
+	g_hash_table_foreach_remove (priv->assignment_links,
+				     task_remove_link_func,
+				     NULL);
+	priv->duplicate_assignments = FALSE;
 }
 
 static gboolean
@@ -921,17 +914,30 @@ mrp_task_get_name (MrpTask *task)
 
 /**
  * mrp_task_set_name:
- * @task: an #MrpResource
+ * @task: an #MrpTask
  * @name: new name of @task
  *
  * Sets the name of @task.
  **/
-void mrp_task_set_name (MrpTask *task, const gchar *name)
+void
+mrp_task_set_name (MrpTask *task, const gchar *name)
 {
+	MrpTaskPriv *priv;
+
 	g_return_if_fail (MRP_IS_TASK (task));
 	g_return_if_fail (name != NULL);
 
-	mrp_object_set (MRP_OBJECT (task), "name", name, NULL);
+	priv = task->priv;
+
+	if (priv->name && strcmp (priv->name, name) == 0) {
+		return;
+	}
+
+	g_free (priv->name);
+	priv->name = g_strdup (name);
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "name");
 }
 
 void
@@ -1427,6 +1433,7 @@ void
 imrp_task_add_assignment (MrpTask *task, MrpAssignment *assignment)
 {
 	MrpTaskPriv *priv;
+	MrpResource *resource;
 
 	g_return_if_fail (MRP_IS_TASK (task));
 	g_return_if_fail (MRP_IS_ASSIGNMENT (assignment));
@@ -1436,6 +1443,14 @@ imrp_task_add_assignment (MrpTask *task, MrpAssignment *assignment)
 	priv->assignments = g_list_prepend (priv->assignments,
 					    g_object_ref (assignment));
 
+	resource = mrp_assignment_get_resource (assignment);
+	if (g_hash_table_lookup (priv->assignment_links, resource)) {
+		priv->duplicate_assignments = TRUE;
+	}
+	g_hash_table_insert (priv->assignment_links, resource, priv->assignments);
+
+	mrp_task_invalidate_cost (task);
+
 	g_signal_connect (assignment,
 			  "removed",
 			  G_CALLBACK (task_assignment_removed_cb),
@@ -1527,6 +1542,41 @@ mrp_task_get_latest_finish (MrpTask *task)
 	return task->priv->latest_finish;
 }
 
+/**
+ * mrp_task_get_total_slack:
+ * @task: an #MrpTask
+ *
+ * Retrieves the total slack of @task, i.e. the working time between the
+ * finish and the latest finish of the task, measured with the project
+ * calendar. It is updated every time the project is rescheduled.
+ *
+ * Return value: The total slack of @task.
+ **/
+gint
+mrp_task_get_total_slack (MrpTask *task)
+{
+	g_return_val_if_fail (MRP_IS_TASK (task), 0);
+
+	return task->priv->total_slack;
+}
+
+/**
+ * mrp_task_get_free_slack:
+ * @task: an #MrpTask
+ *
+ * Retrieves the free slack of @task, i.e. the working time the task can be
+ * delayed without delaying the start of any of its successors.
+ *
+ * Return value: The free slack of @task.
+ **/
+gint
+mrp_task_get_free_slack (MrpTask *task)
+{
+	g_return_val_if_fail (MRP_IS_TASK (task), 0);
+
+	return task->priv->free_slack;
+}
+
 /**
  * mrp_task_get_duration:
  * @task: an #MrpTask
@@ -1669,16 +1719,13 @@ mrp_task_get_assignments (MrpTask *task)
  **/
 gint mrp_task_get_nres (MrpTask *task)
 {
-	GList *assignments, *a;
-	gint nres = 0;
-
-	assignments = mrp_task_get_assignments (task);
+	g_return_val_if_fail (MRP_IS_TASK (task), 0);
 
-	for (a = assignments; a; a = a->next) {
-		nres++;
+	if (task->priv->duplicate_assignments) {
+		return g_list_length (task->priv->assignments);
 	}
 
-	return (nres);
+	return g_hash_table_size (task->priv->assignment_links);
 }
 
 /**
@@ -1694,20 +1741,14 @@ gint mrp_task_get_nres (MrpTask *task)
 MrpAssignment *
 mrp_task_get_assignment (MrpTask *task, MrpResource *resource)
 {
-	GList *l;
+	GList *link;
 
 	g_return_val_if_fail (MRP_IS_TASK (task), NULL);
 	g_return_val_if_fail (MRP_IS_RESOURCE (resource), NULL);
 
-	for (l = task->priv->assignments; l; l = l->next) {
-		MrpAssignment *assignment = l->data;
-
-		if (mrp_assignment_get_resource (assignment) == resource) {
-			return assignment;
-		}
-	}
+	link = g_hash_table_lookup (task->priv->assignment_links, resource);
 
-	return NULL;
+	return link ? link->data : NULL;
 }
 
 /**
@@ -1775,61 +1816,94 @@ mrp_task_reset_constraint (MrpTask *task)
  * mrp_task_get_cost:
  * @task: an #MrpTask
  *
- * Calculates the cost to complete @task.
+ * Retrieves the cost to complete @task. For summary tasks this is the sum of
+ * the costs of the children.
  *
  * Return value: The cost to complete @task.
  **/
 gfloat
 mrp_task_get_cost (MrpTask *task)
 {
-	MrpTaskPriv *priv;
-	GList       *assignments, *l;
-	MrpResource *resource;
-	gfloat       total = 0;
-	gfloat       cost;
-	MrpTask     *child;
-
 	g_return_val_if_fail (MRP_IS_TASK (task), 0);
 
-	priv = task->priv;
+	return task->priv->cost;
+}
 
-	if (priv->cost_cached) {
-		return priv->cost;
-	}
+static gdouble
+task_calculate_cost (MrpTask *task)
+{
+	MrpTaskPriv *priv;
+	GNode       *node;
+	GList       *l;
+	gdouble      total = 0;
+
+	priv = task->priv;
 
-	/* summary task cost calc */
-	child = mrp_task_get_first_child (task);
-	if (child) {
-		while (child) {
-			total += mrp_task_get_cost (child);
-			child = mrp_task_get_next_sibling (child);
+	if (priv->node->children) {
+		for (node = priv->node->children; node; node = node->next) {
+			total += MRP_TASK (node->data)->priv->cost;
 		}
 	} else {
-	/* non summary task cost calc */
-		assignments = mrp_task_get_assignments (task);
-		for (l = assignments; l; l = l->next) {
-			resource = mrp_assignment_get_resource (l->data);
+		for (l = priv->assignments; l; l = l->next) {
+			MrpAssignment *assignment = l->data;
 
-			mrp_object_get (resource, "cost", &cost, NULL);
-			total += mrp_assignment_get_units (l->data) * priv->duration * cost / (3600.0 * 100);
+			total += mrp_assignment_get_units (assignment) * priv->duration *
+				mrp_resource_get_cost (mrp_assignment_get_resource (assignment)) /
+				(3600.0 * 100);
 		}
 	}
 
-	priv->cost = total;
-	priv->cost_cached = TRUE;
-
 	return total;
 }
 
+/**
+ * mrp_task_invalidate_cost:
+ * @task: an #MrpTask
+ *
+ * Recalculates the cost of @task, from its assignments or from its children if
+ * it is a summary task, and then the cost of each of its ancestors from their
+ * children. Needs to be called when anything that the cost depends on
+ * changes.
+ **/
 void
 mrp_task_invalidate_cost (MrpTask *task)
 {
+	MrpTaskPriv *priv;
+	GNode       *node;
+	MrpTask     *root;
+	MrpProject  *project;
+	gdouble      total;
+
 	g_return_if_fail (MRP_IS_TASK (task));
 
-	task->priv->cost_cached = FALSE;
+	priv = task->priv;
 
-	if (task->priv->node->parent) {
-		mrp_task_invalidate_cost (task->priv->node->parent->data);
+	total = task_calculate_cost (task);
+	if (total == priv->cost) {
+		return;
+	}
+
+	priv->cost = total;
+
+	/* Summing the children again instead of adding the difference keeps
+	 * rounding errors from building up in the summary tasks. Stop as soon
+	 * as a summary task comes out the same, nothing above it changes.
+	 */
+	root = task;
+	for (node = priv->node->parent; node; node = node->parent) {
+		root = node->data;
+
+		total = task_calculate_cost (root);
+		if (total == root->priv->cost) {
+			return;
+		}
+
+		root->priv->cost = total;
+	}
+
+	project = mrp_object_get_project (MRP_OBJECT (root));
+	if (project) {
+		imrp_project_cost_changed (project, root);
 	}
 }
 
@@ -1907,7 +1981,15 @@ imrp_task_set_duration (MrpTask *task, gint duration)
 {
 	g_return_if_fail (MRP_IS_TASK (task));
 
+	if (task->priv->duration == duration) {
+		return;
+	}
+
 	task->priv->duration = duration;
+
+	if (!task->priv->node->children) {
+		mrp_task_invalidate_cost (task);
+	}
 }
 
 void
@@ -1932,6 +2014,26 @@ imrp_task_set_latest_finish (MrpTask *task,
 	task->priv->latest_finish = time;
 }
 
+void
+imrp_task_set_slack (MrpTask *task,
+		     gint     total_slack,
+		     gint     free_slack)
+{
+	MrpTaskPriv *priv;
+
+	priv = task->priv;
+
+	if (priv->total_slack != total_slack) {
+		priv->total_slack = total_slack;
+		g_object_notify (G_OBJECT (task), "total_slack");
+	}
+
+	if (priv->free_slack != free_slack) {
+		priv->free_slack = free_slack;
+		g_object_notify (G_OBJECT (task), "free_slack");
+	}
+}
+
 MrpConstraint
 imrp_task_get_constraint (MrpTask *task)
 {
@@ -1990,6 +2092,47 @@ imrp_task_peek_successors (MrpTask *task)
 	return task->priv->successors;
 }
 
+/* Returns the number of bytes held by the task itself, not counting its
+ * children or the objects it links to. Used to account for tasks that are
+ * only kept alive by the undo history.
+ */
+gsize
+imrp_task_get_size (MrpTask *task)
+{
+	MrpTaskPriv *priv;
+	gsize        size;
+
+	g_return_val_if_fail (MRP_IS_TASK (task), 0);
+
+	priv = task->priv;
+
+	size = sizeof (MrpTask) + sizeof (MrpTaskPriv) + sizeof (GNode);
+
+	if (priv->name) {
+		size += strlen (priv->name) + 1;
+	}
+	if (priv->note) {
+		size += strlen (priv->note) + 1;
+	}
+	if (priv->graph_node) {
+		size += sizeof (MrpTaskGraphNode) +
+			sizeof (GList) * (g_list_length (priv->graph_node->prev) +
+					  g_list_length (priv->graph_node->next));
+	}
+
+	size += sizeof (GList) * (g_list_length (priv->predecessors) +
+				  g_list_length (priv->successors));
+
+	/* Each assignment has a list link and a hash table entry. */
+	size += (sizeof (GList) + 3 * sizeof (gpointer)) *
+		g_list_length (priv->assignments);
+
+	size += (sizeof (GList) + sizeof (MrpUnitsInterval)) *
+		g_list_length (priv->unit_ivals);
+
+	return size;
+}
+
 MrpTaskType
 mrp_task_get_task_type (MrpTask *task)
 {
@@ -2021,3 +2164,282 @@ mrp_task_get_critical (MrpTask *task)
 
 	return task->priv->critical;
 }
+
+/**
+ * mrp_task_get_note:
+ * @task: an #MrpTask
+ *
+ * Retrieves the note of @task.
+ *
+ * Return value: the note, owned by @task.
+ **/
+const gchar *
+mrp_task_get_note (MrpTask *task)
+{
+	g_return_val_if_fail (MRP_IS_TASK (task), NULL);
+
+	return task->priv->note;
+}
+
+/**
+ * mrp_task_get_constraint:
+ * @task: an #MrpTask
+ *
+ * Retrieves the scheduling constraint of @task.
+ *
+ * Return value: the constraint of @task.
+ **/
+MrpConstraint
+mrp_task_get_constraint (MrpTask *task)
+{
+	return imrp_task_get_constraint (task);
+}
+
+/**
+ * mrp_task_set_note:
+ * @task: an #MrpTask
+ * @note: the new note, or %NULL
+ *
+ * Sets the note of @task. This is the same as setting the "note" property
+ * without going through the property machinery.
+ **/
+void
+mrp_task_set_note (MrpTask *task, const gchar *note)
+{
+	MrpTaskPriv *priv;
+
+	g_return_if_fail (MRP_IS_TASK (task));
+
+	priv = task->priv;
+
+	if (priv->note == note ||
+	    (priv->note && note && strcmp (priv->note, note) == 0)) {
+		return;
+	}
+
+	g_free (priv->note);
+	priv->note = g_strdup (note);
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "note");
+}
+
+/**
+ * mrp_task_set_duration:
+ * @task: an #MrpTask
+ * @duration: the new duration, in seconds of working time
+ *
+ * Sets the duration of a fixed duration @task. Summary tasks, milestones and
+ * fixed work tasks get their duration from the scheduler and are left alone.
+ **/
+void
+mrp_task_set_duration (MrpTask *task, gint duration)
+{
+	MrpTaskPriv *priv;
+
+	g_return_if_fail (MRP_IS_TASK (task));
+
+	priv = task->priv;
+
+	if (mrp_task_get_n_children (task) > 0 ||
+	    priv->type == MRP_TASK_TYPE_MILESTONE ||
+	    priv->sched == MRP_TASK_SCHED_FIXED_WORK) {
+		return;
+	}
+
+	if (priv->duration == duration) {
+		return;
+	}
+
+	priv->duration = duration;
+
+	mrp_task_invalidate_cost (task);
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "duration");
+	g_object_notify (G_OBJECT (task), "work");
+}
+
+/**
+ * mrp_task_set_work:
+ * @task: an #MrpTask
+ * @work: the new amount of work, in seconds
+ *
+ * Sets the work of @task. Summary tasks and milestones are left alone.
+ **/
+void
+mrp_task_set_work (MrpTask *task, gint work)
+{
+	MrpTaskPriv *priv;
+
+	g_return_if_fail (MRP_IS_TASK (task));
+
+	priv = task->priv;
+
+	if (mrp_task_get_n_children (task) > 0 ||
+	    priv->type == MRP_TASK_TYPE_MILESTONE) {
+		return;
+	}
+
+	if (priv->work == work) {
+		return;
+	}
+
+	priv->work = work;
+
+	mrp_task_invalidate_cost (task);
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "work");
+	g_object_notify (G_OBJECT (task), "duration");
+}
+
+/**
+ * mrp_task_set_task_type:
+ * @task: an #MrpTask
+ * @type: the new type
+ *
+ * Makes @task a milestone or a normal task. Milestones have no work or
+ * duration, a task that stops being one gets a default of one day.
+ **/
+void
+mrp_task_set_task_type (MrpTask *task, MrpTaskType type)
+{
+	MrpTaskPriv *priv;
+
+	g_return_if_fail (MRP_IS_TASK (task));
+
+	priv = task->priv;
+
+	if (priv->type == type) {
+		return;
+	}
+
+	priv->type = type;
+
+	if (type == MRP_TASK_TYPE_MILESTONE) {
+		priv->duration = 0;
+		priv->work = 0;
+	} else {
+		/* FIXME: we need a way to specify a default work/duration for
+		 * tasks.
+		 */
+		priv->duration = 60*60*8;
+		priv->work = 60*60*8;
+	}
+
+	mrp_task_invalidate_cost (task);
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "type");
+	g_object_notify (G_OBJECT (task), "duration");
+	g_object_notify (G_OBJECT (task), "work");
+}
+
+/**
+ * mrp_task_set_sched:
+ * @task: an #MrpTask
+ * @sched: the new scheduling type
+ *
+ * Sets whether @task has fixed work or fixed duration.
+ **/
+void
+mrp_task_set_sched (MrpTask *task, MrpTaskSched sched)
+{
+	g_return_if_fail (MRP_IS_TASK (task));
+
+	if (task->priv->sched == sched) {
+		return;
+	}
+
+	task->priv->sched = sched;
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "sched");
+}
+
+/**
+ * mrp_task_set_constraint:
+ * @task: an #MrpTask
+ * @constraint: the new constraint
+ *
+ * Sets the scheduling constraint of @task.
+ **/
+void
+mrp_task_set_constraint (MrpTask             *task,
+			 const MrpConstraint *constraint)
+{
+	MrpTaskPriv *priv;
+
+	g_return_if_fail (MRP_IS_TASK (task));
+	g_return_if_fail (constraint != NULL);
+
+	priv = task->priv;
+
+	if (priv->constraint.type == constraint->type &&
+	    priv->constraint.time == constraint->time) {
+		return;
+	}
+
+	priv->constraint = *constraint;
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "constraint");
+}
+
+/**
+ * mrp_task_set_percent_complete:
+ * @task: an #MrpTask
+ * @percent_complete: how much of @task is done, 0-100
+ *
+ * Sets how far @task has come.
+ **/
+void
+mrp_task_set_percent_complete (MrpTask *task, gshort percent_complete)
+{
+	g_return_if_fail (MRP_IS_TASK (task));
+
+	if (task->priv->percent_complete == percent_complete) {
+		return;
+	}
+
+	task->priv->percent_complete = percent_complete;
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "percent-complete");
+}
+
+/**
+ * mrp_task_set_priority:
+ * @task: an #MrpTask
+ * @priority: the new priority, 0-9999
+ *
+ * Sets the priority of @task, a hint for resource levelling.
+ **/
+void
+mrp_task_set_priority (MrpTask *task, gint priority)
+{
+	g_return_if_fail (MRP_IS_TASK (task));
+
+	if (task->priv->priority == priority) {
+		return;
+	}
+
+	task->priv->priority = priority;
+
+	mrp_object_changed (MRP_OBJECT (task));
+	g_object_notify (G_OBJECT (task), "priority");
+}
+
+void
+imrp_task_set_critical (MrpTask *task, gboolean critical)
+{
+	g_return_if_fail (MRP_IS_TASK (task));
+
+	if (task->priv->critical == critical) {
+		return;
+	}
+
+	task->priv->critical = critical;
+	g_object_notify (G_OBJECT (task), "critical");
+}
@@ -120,6 +120,8 @@ mrptime          mrp_task_get_work_start            (MrpTask          *task);
 mrptime          mrp_task_get_finish                (MrpTask          *task);
 mrptime          mrp_task_get_latest_start          (MrpTask          *task);
 mrptime          mrp_task_get_latest_finish         (MrpTask          *task);
+gint             mrp_task_get_total_slack           (MrpTask          *task);
+gint             mrp_task_get_free_slack            (MrpTask          *task);
 gint             mrp_task_get_duration              (MrpTask          *task);
 gint             mrp_task_get_work                  (MrpTask          *task);
 gint             mrp_task_get_priority              (MrpTask          *task);
@@ -145,6 +147,24 @@ MrpTaskType      mrp_task_get_task_type             (MrpTask          *task);
 MrpTaskSched     mrp_task_get_sched                 (MrpTask          *task);
 gshort           mrp_task_get_percent_complete      (MrpTask          *task);
 gboolean         mrp_task_get_critical              (MrpTask          *task);
+const gchar     *mrp_task_get_note                  (MrpTask          *task);
+MrpConstraint    mrp_task_get_constraint            (MrpTask          *task);
+void             mrp_task_set_note                  (MrpTask          *task,
+						     const gchar      *note);
+void             mrp_task_set_duration              (MrpTask          *task,
+						     gint              duration);
+void             mrp_task_set_work                  (MrpTask          *task,
+						     gint              work);
+void             mrp_task_set_task_type             (MrpTask          *task,
+						     MrpTaskType       type);
+void             mrp_task_set_sched                 (MrpTask          *task,
+						     MrpTaskSched      sched);
+void             mrp_task_set_constraint            (MrpTask          *task,
+						     const MrpConstraint *constraint);
+void             mrp_task_set_percent_complete      (MrpTask          *task,
+						     gshort            percent_complete);
+void             mrp_task_set_priority              (MrpTask          *task,
+						     gint              priority);
 
 
 #endif /* __MRP_TASK_H__ */
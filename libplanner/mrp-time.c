@@ -51,7 +51,104 @@ static const gchar *month_names_initial[12];
 static const gchar *short_day_names[7];
 static const gchar *day_names[7];
 
-static struct tm *mrp_time_to_tm   (mrptime    t);
+static void       mrp_time_to_tm   (mrptime    t,
+				    struct tm *tm);
+
+#define SECS_IN_MIN  60
+#define SECS_IN_HOUR (60*60)
+#define SECS_IN_DAY  (60*60*24)
+
+/* Days between 1970-01-01 and a date in the proleptic Gregorian calendar, and
+ * back. Plain integer arithmetic on 400 year eras (146097 days), after Howard
+ * Hinnant's days_from_civil and civil_from_days.
+ */
+static glong
+time_days_from_civil (glong year, gint month, gint day)
+{
+	glong era;
+	glong yoe, doy, doe;
+
+	year -= month <= 2;
+	era = (year >= 0 ? year : year - 399) / 400;
+	yoe = year - era * 400;
+	doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+	return era * 146097 + doe - 719468;
+}
+
+static void
+time_civil_from_days (glong days, gint *year, gint *month, gint *day)
+{
+	glong era;
+	glong doe, yoe, doy, mp;
+
+	days += 719468;
+	era = (days >= 0 ? days : days - 146096) / 146097;
+	doe = days - era * 146097;
+	yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	mp = (5 * doy + 2) / 153;
+
+	*day = doy - (153 * mp + 2) / 5 + 1;
+	*month = mp < 10 ? mp + 3 : mp - 9;
+	*year = yoe + era * 400 + (*month <= 2);
+}
+
+/* Splits @t into whole days since the epoch and seconds into the day, rounding
+ * towards minus infinity.
+ */
+static glong
+time_split (mrptime t, gint *secs)
+{
+	glong days, rem;
+
+	days = t / SECS_IN_DAY;
+	rem = t % SECS_IN_DAY;
+
+	days -= rem < 0;
+	rem += (rem < 0) * SECS_IN_DAY;
+
+	*secs = rem;
+
+	return days;
+}
+
+/* Reads exactly @n decimal digits. */
+static gboolean
+time_parse_digits (const gchar *str, gint n, gint *value)
+{
+	gint i;
+
+	*value = 0;
+
+	for (i = 0; i < n; i++) {
+		if (str[i] < '0' || str[i] > '9') {
+			return FALSE;
+		}
+
+		*value = *value * 10 + (str[i] - '0');
+	}
+
+	return TRUE;
+}
+
+/* Writes @value as exactly @n decimal digits, zero padded. */
+static void
+time_write_digits (gchar *buf, gint n, gint value)
+{
+	while (n-- > 0) {
+		buf[n] = '0' + value % 10;
+		value /= 10;
+	}
+}
+
+/* Day of week for a day number, 0 for Monday. 1970-01-01 was a Thursday. */
+static gint
+time_weekday_from_monday (glong days)
+{
+	return (days % 7 + 10) % 7;
+}
 
 
 
@@ -76,12 +173,15 @@ mrp_time_compose (gint year,
 		  gint minute,
 		  gint second)
 {
-	MrpTime t;
-
-	mrp_time2_set_date (&t, year, month, day);
-	mrp_time2_set_time (&t, hour, minute, second);
-
-	return mrp_time2_get_epoch (&t);
+	g_return_val_if_fail (year >= 1 && year <= 9999, 0);
+	g_return_val_if_fail (month >= 1 && month <= 12, 0);
+	g_return_val_if_fail (day >= 1 && day <= 31, 0);
+	g_return_val_if_fail (hour >= 0 && hour < 24, 0);
+	g_return_val_if_fail (minute >= 0 && minute < 60, 0);
+	g_return_val_if_fail (second >= 0 && second < 60, 0);
+
+	return time_days_from_civil (year, month, day) * SECS_IN_DAY +
+		hour * SECS_IN_HOUR + minute * SECS_IN_MIN + second;
 }
 
 /**
@@ -107,10 +207,9 @@ mrp_time_decompose (mrptime  t,
 		    gint    *minute,
 		    gint    *second)
 {
-	MrpTime t2;
-	gint    tmp;
-
-	mrp_time2_set_epoch (&t2, t);
+	glong days;
+	gint  secs;
+	gint  tmp;
 
 	if (!year) {
 		year = &tmp;
@@ -131,8 +230,12 @@ mrp_time_decompose (mrptime  t,
 		second = &tmp;
 	}
 
-	mrp_time2_get_date (&t2, year, month, day);
-	mrp_time2_get_time (&t2, hour, minute, second);
+	days = time_split (t, &secs);
+	time_civil_from_days (days, year, month, day);
+
+	*hour = secs / SECS_IN_HOUR;
+	*minute = secs % SECS_IN_HOUR / SECS_IN_MIN;
+	*second = secs % SECS_IN_MIN;
 
 	return TRUE;
 }
@@ -164,28 +267,25 @@ mrp_time_debug_print (mrptime t)
 mrptime
 mrp_time_from_tm (struct tm *tm)
 {
-	/* A portable implementation is available in the notes of the man page
-	 * for timegm */
-
-	gchar   *old_tz;
-	mrptime  t;
-
-	/* This is a hack. Set the timezone to UTC temporarily. */
-	old_tz = g_strdup (g_getenv ("TZ"));
-	g_setenv ("TZ", "UTC", TRUE);
+	glong year, month;
 
-	t = mktime (tm);
+	g_return_val_if_fail (tm != NULL, 0);
 
-	/* And set it back. */
-	if (old_tz != NULL && old_tz[0] != '\0') {
-		g_setenv ("TZ", old_tz, TRUE);
-	} else {
-		g_unsetenv ("TZ");
+	/* Like timegm(), the fields are taken as UTC and may be out of
+	 * range. Only the month needs to be normalized, the rest are
+	 * just added up.
+	 */
+	year = tm->tm_year + 1900 + tm->tm_mon / 12;
+	month = tm->tm_mon % 12;
+	if (month < 0) {
+		month += 12;
+		year--;
 	}
 
-	g_free (old_tz);
-
-	return t;
+	return (time_days_from_civil (year, month + 1, 1) + tm->tm_mday - 1) * SECS_IN_DAY +
+		(glong) tm->tm_hour * SECS_IN_HOUR +
+		(glong) tm->tm_min * SECS_IN_MIN +
+		tm->tm_sec;
 }
 
 /**
@@ -199,30 +299,45 @@ mrptime
 mrp_time_current_time (void)
 {
 	time_t     t;
-	struct tm *tm;
+	struct tm  tm;
 
 	t = time (NULL);
-	tm = localtime (&t);
-	return mrp_time_from_tm (tm);
+#ifndef WIN32
+	localtime_r (&t, &tm);
+#else
+	/* The Windows runtime keeps this buffer per thread. */
+	tm = *localtime (&t);
+#endif
+	return mrp_time_from_tm (&tm);
 }
 
 /**
  * mrp_time_to_tm:
  * @t: an #mrptime value
+ * @tm: the struct tm to fill in
  *
- * Converts @t to a struct tm value.
- *
- * Return value: struct tm time, which is static data and should not be
- * modified or freed.
+ * Converts @t to a struct tm value, in UTC.
  **/
-static struct tm *
-mrp_time_to_tm (mrptime t)
+static void
+mrp_time_to_tm (mrptime t, struct tm *tm)
 {
-	time_t tt;
+	glong days;
+	gint  secs;
+	gint  year, month, day;
+
+	days = time_split (t, &secs);
+	time_civil_from_days (days, &year, &month, &day);
 
-	tt = t;
+	memset (tm, 0, sizeof (struct tm));
 
-	return gmtime (&tt);
+	tm->tm_year = year - 1900;
+	tm->tm_mon = month - 1;
+	tm->tm_mday = day;
+	tm->tm_hour = secs / SECS_IN_HOUR;
+	tm->tm_min = secs % SECS_IN_HOUR / SECS_IN_MIN;
+	tm->tm_sec = secs % SECS_IN_MIN;
+	tm->tm_wday = (time_weekday_from_monday (days) + 1) % 7;
+	tm->tm_yday = days - time_days_from_civil (year, 1, 1);
 }
 
 /**
@@ -238,85 +353,87 @@ mrptime
 mrp_time_from_string (const gchar  *str,
 		      GError      **err)
 {
-	gint     len;
-	gboolean is_utc;
-	gboolean is_date;
-	gint     year;
-	gint     month;
-	gint     day;
-	gint     hour = 0;
-	gint     minute = 0;
-	gint     second = 0;
+	gint year;
+	gint month;
+	gint day;
+	gint hour = 0;
+	gint minute = 0;
+	gint second = 0;
+
+	g_return_val_if_fail (str != NULL, 0);
+
+	/* Accepts a date, "YYYYMMDD", a floating time "YYYYMMDDTHHMMSS" or a
+	 * UTC time, the same ending in 'Z'.
+	 *
+	 * FIXME: If we want to support reading times other than in UTC,
+	 * implement that here.
+	 */
+	if (!time_parse_digits (str, 4, &year) ||
+	    !time_parse_digits (str + 4, 2, &month) ||
+	    !time_parse_digits (str + 6, 2, &day)) {
+		return 0;
+	}
 
-	len = strlen (str);
+	str += 8;
 
-	if (len == 15) { /* floating time */
-		is_utc = FALSE;
-		is_date = FALSE;
-	} else if (len == 16) { /* UTC time, ends in 'Z' */
-		is_utc = TRUE;
-		is_date = FALSE;
+	if (*str == 'T') {
+		if (!time_parse_digits (str + 1, 2, &hour) ||
+		    !time_parse_digits (str + 3, 2, &minute) ||
+		    !time_parse_digits (str + 5, 2, &second)) {
+			return 0;
+		}
 
-		if (str[15] != 'Z') {
-			/*g_set_error (err,
-				     GQuark domain,
-				     gint code,
-				     const gchar *format,
-				     ...);*/
+		str += 7;
 
-			return 0;
+		if (*str == 'Z') {
+			str++;
 		}
 	}
-	else if (len == 8) { /* A date. */
-		is_utc = TRUE;
-		is_date = TRUE;
-	} else {
-		/*g_set_error (err,
-		  GQuark domain,
-		  gint code,
-		  const gchar *format,
-		  ...);*/
 
+	if (*str != '\0') {
 		return 0;
 	}
 
-	if (is_date) {
-		if (sscanf (str, "%04d%02d%02d", &year, &month, &day) != 3) {
-			return 0;
-		}
-	} else {
-		gchar tsep;
+	if (year < 1 || month < 1 || month > 12 || day < 1 || day > 31 ||
+	    hour > 23 || minute > 59 || second > 59) {
+		return 0;
+	}
 
-		if (sscanf (str,"%04d%02d%02d%c%02d%02d%02d",
-			    &year, &month, &day,
-			    &tsep,
-			    &hour, &minute, &second) != 7) {
-			return 0;
-		}
+	return time_days_from_civil (year, month, day) * SECS_IN_DAY +
+		hour * SECS_IN_HOUR + minute * SECS_IN_MIN + second;
+}
 
-		if (tsep != 'T') {
-			/*g_set_error (err,
-			  GQuark domain,
-			  gint code,
-			  const gchar *format,
-			  ...);*/
-			return 0;
-		}
+/**
+ * mrp_time_to_string_buf:
+ * @t: an #mrptime time
+ * @buf: a buffer of at least %MRP_TIME_STRING_LEN bytes
+ *
+ * Writes @t as an ISO8601 string in UTC to @buf, the same as
+ * mrp_time_to_string() but without allocating.
+ **/
+void
+mrp_time_to_string_buf (mrptime t, gchar *buf)
+{
+	gint year, month, day;
+	gint hour, minute, second;
 
-	}
+	g_return_if_fail (buf != NULL);
 
-	/* FIXME: If we want to support reading times other than in UTC,
-	 * implement that here.
-	 */
-	if (!is_utc) {
+	mrp_time_decompose (t, &year, &month, &day, &hour, &minute, &second);
+
+	if (year < 0 || year > 9999) {
+		year = 0;
 	}
 
-	return mrp_time_compose (year,
-				 month,
-				 day,
-				 hour,
-				 minute,
-				 second);
+	time_write_digits (buf, 4, year);
+	time_write_digits (buf + 4, 2, month);
+	time_write_digits (buf + 6, 2, day);
+	buf[8] = 'T';
+	time_write_digits (buf + 9, 2, hour);
+	time_write_digits (buf + 11, 2, minute);
+	time_write_digits (buf + 13, 2, second);
+	buf[15] = 'Z';
+	buf[16] = '\0';
 }
 
 /**
@@ -330,11 +447,11 @@ mrp_time_from_string (const gchar  *str,
 gchar *
 mrp_time_to_string (mrptime t)
 {
-	MrpTime t2;
+	gchar buf[MRP_TIME_STRING_LEN];
 
-	mrp_time2_set_epoch (&t2, t);
+	mrp_time_to_string_buf (t, buf);
 
-	return mrp_time2_to_string (&t2);
+	return g_strdup (buf);
 }
 
 /**
@@ -348,34 +465,141 @@ mrp_time_to_string (mrptime t)
 mrptime
 mrp_time_align_day (mrptime t)
 {
-	MrpTime t2;
-
-	mrp_time2_set_epoch (&t2, t);
-	mrp_time2_align_prev (&t2, MRP_TIME_UNIT_DAY);
+	gint secs;
 
-	return mrp_time2_get_epoch (&t2);
+	return time_split (t, &secs) * SECS_IN_DAY;
 }
 
+/**
+ * mrp_time_align_prev:
+ * @t: an #mrptime value
+ * @unit: the unit to align to
+ *
+ * Aligns a time value to the start of the @unit it's in. Weeks start on
+ * Monday.
+ *
+ * Return value: Aligned value.
+ **/
 mrptime
 mrp_time_align_prev (mrptime t, MrpTimeUnit unit)
 {
-	MrpTime t2;
+	glong days;
+	gint  secs, hour;
+	gint  year, month, day;
 
-	mrp_time2_set_epoch (&t2, t);
-	mrp_time2_align_prev (&t2, unit);
+	days = time_split (t, &secs);
+
+	switch (unit) {
+	case MRP_TIME_UNIT_HOUR:
+		return t - secs % SECS_IN_HOUR;
+
+	case MRP_TIME_UNIT_TWO_HOURS:
+		hour = secs / SECS_IN_HOUR;
+		hour = hour >= 2 ? hour - (2 - hour % 2) : 0;
+		return days * SECS_IN_DAY + hour * SECS_IN_HOUR;
+
+	case MRP_TIME_UNIT_HALFDAY:
+		return days * SECS_IN_DAY + (secs >= 12 * SECS_IN_HOUR) * 12 * SECS_IN_HOUR;
+
+	case MRP_TIME_UNIT_DAY:
+		return days * SECS_IN_DAY;
+
+	case MRP_TIME_UNIT_WEEK:
+		return (days - time_weekday_from_monday (days)) * SECS_IN_DAY;
+
+	case MRP_TIME_UNIT_MONTH:
+	case MRP_TIME_UNIT_QUARTER:
+	case MRP_TIME_UNIT_HALFYEAR:
+	case MRP_TIME_UNIT_YEAR:
+		time_civil_from_days (days, &year, &month, &day);
+
+		if (unit == MRP_TIME_UNIT_QUARTER) {
+			month = (month - 1) / 3 * 3 + 1;
+		}
+		else if (unit == MRP_TIME_UNIT_HALFYEAR) {
+			month = (month - 1) / 6 * 6 + 1;
+		}
+		else if (unit == MRP_TIME_UNIT_YEAR) {
+			month = 1;
+		}
+
+		return time_days_from_civil (year, month, 1) * SECS_IN_DAY;
+
+	case MRP_TIME_UNIT_NONE:
+	default:
+		g_assert_not_reached ();
+	}
 
-	return mrp_time2_get_epoch (&t2);
+	return t;
 }
 
+/**
+ * mrp_time_align_next:
+ * @t: an #mrptime value
+ * @unit: the unit to align to
+ *
+ * Aligns a time value to the start of the @unit after the one it's in. Weeks
+ * start on Monday.
+ *
+ * Return value: Aligned value.
+ **/
 mrptime
 mrp_time_align_next (mrptime t, MrpTimeUnit unit)
 {
-	MrpTime t2;
+	glong days;
+	gint  secs, hour;
+	gint  year, month, day;
 
-	mrp_time2_set_epoch (&t2, t);
-	mrp_time2_align_next (&t2, unit);
+	days = time_split (t, &secs);
+
+	switch (unit) {
+	case MRP_TIME_UNIT_HOUR:
+		return t - secs % SECS_IN_HOUR + SECS_IN_HOUR;
+
+	case MRP_TIME_UNIT_TWO_HOURS:
+		hour = secs / SECS_IN_HOUR;
+		return days * SECS_IN_DAY + (hour + 2 - hour % 2) * SECS_IN_HOUR;
 
-	return mrp_time2_get_epoch (&t2);
+	case MRP_TIME_UNIT_HALFDAY:
+		return days * SECS_IN_DAY + (secs < 12 * SECS_IN_HOUR ? 12 : 24) * SECS_IN_HOUR;
+
+	case MRP_TIME_UNIT_DAY:
+		return (days + 1) * SECS_IN_DAY;
+
+	case MRP_TIME_UNIT_WEEK:
+		return (days + 7 - time_weekday_from_monday (days)) * SECS_IN_DAY;
+
+	case MRP_TIME_UNIT_MONTH:
+	case MRP_TIME_UNIT_QUARTER:
+	case MRP_TIME_UNIT_HALFYEAR:
+	case MRP_TIME_UNIT_YEAR:
+		time_civil_from_days (days, &year, &month, &day);
+
+		if (unit == MRP_TIME_UNIT_MONTH) {
+			month += 1;
+		}
+		else if (unit == MRP_TIME_UNIT_QUARTER) {
+			month = (month - 1) / 3 * 3 + 4;
+		}
+		else if (unit == MRP_TIME_UNIT_HALFYEAR) {
+			month = (month - 1) / 6 * 6 + 7;
+		} else {
+			month = 13;
+		}
+
+		if (month > 12) {
+			month -= 12;
+			year++;
+		}
+
+		return time_days_from_civil (year, month, 1) * SECS_IN_DAY;
+
+	case MRP_TIME_UNIT_NONE:
+	default:
+		g_assert_not_reached ();
+	}
+
+	return t;
 }
 
 /**
@@ -389,17 +613,9 @@ mrp_time_align_next (mrptime t, MrpTimeUnit unit)
 gint
 mrp_time_day_of_week (mrptime t)
 {
-	MrpTime t2;
-	gint    weekday;
-
-	mrp_time2_set_epoch (&t2, t);
-
-	weekday = g_date_get_weekday (&t2.date);
-	if (weekday == 7) {
-		weekday = 0;
-	}
+	gint secs;
 
-	return weekday;
+	return (time_weekday_from_monday (time_split (t, &secs)) + 1) % 7;
 }
 
 /**
@@ -618,271 +834,288 @@ imrp_time_init (void)
 #endif
 }
 
-static gint
-time_format_helper (const gchar *format,
-		    MrpTime     *t,
-		    gchar       *buffer)
+typedef struct {
+	gchar code;  /* Conversion character, or 0 for literal text. */
+	gint  start; /* Literal text, offset and length in the format. */
+	gint  len;
+} TimeFormatOp;
+
+struct _MrpTimeFormat {
+	gchar        *format;
+	TimeFormatOp *ops;
+	gint          n_ops;
+	gboolean      needs_week;
+};
+
+static void
+time_format_put (gchar       *buf,
+		 gint         size,
+		 gint        *len,
+		 const gchar *str,
+		 gint         n)
 {
-	gint  len = 0;
-	gchar str[5];
-	gint  year, month, day;
-	gint  hour, min, sec;
-	gint  weekday;
+	gint i;
 
-	if (!format) {
-		return 1;
+	for (i = 0; i < n && *len + i < size - 1; i++) {
+		buf[*len + i] = str[i];
 	}
 
-	year = g_date_get_year (&t->date);
-	month = g_date_get_month (&t->date);
-	day = g_date_get_day (&t->date);
+	*len += n;
+}
 
-	hour = t->hour;
-	min = t->min;
-	sec = t->sec;
+/* Writes @value with at least @width digits, zero padded. */
+static void
+time_format_put_number (gchar *buf,
+			gint   size,
+			gint  *len,
+			gint   value,
+			gint   width)
+{
+	gchar str[12];
+	gint  n = 0;
 
-	weekday = g_date_get_weekday (&t->date);
-	if (weekday == 7) {
-		weekday = 0;
-	}
+	do {
+		str[sizeof (str) - ++n] = '0' + value % 10;
+		value /= 10;
+	} while (value > 0 || n < width);
 
-	while (*format) {
-		register gchar c = *format++;
-		register gint tmp;
+	time_format_put (buf, size, len, str + sizeof (str) - n, n);
+}
 
-		if (c != '%') {
-			if (buffer) {
-				buffer[len] = c;
-			}
+/**
+ * mrp_time_format_new:
+ * @format: format string, see mrp_time_format()
+ *
+ * Parses @format once so that it can be rendered for many times with
+ * mrp_time_format_render() without parsing or allocating.
+ *
+ * Return value: Newly created #MrpTimeFormat, free with
+ * mrp_time_format_free().
+ **/
+MrpTimeFormat *
+mrp_time_format_new (const gchar *format)
+{
+	MrpTimeFormat *compiled;
+	GArray        *ops;
+	TimeFormatOp   op;
+	const gchar   *p;
+	const gchar   *literal;
 
-			len++;
+	g_return_val_if_fail (format != NULL, NULL);
+
+	compiled = g_new0 (MrpTimeFormat, 1);
+	compiled->format = g_strdup (format);
+
+	ops = g_array_new (FALSE, FALSE, sizeof (TimeFormatOp));
+
+	p = literal = compiled->format;
+	while (TRUE) {
+		if (*p != '%' && *p != '\0') {
+			p++;
 			continue;
 		}
 
-		c = *format++;
-		switch (c) {
+		if (p > literal) {
+			op.code = 0;
+			op.start = literal - compiled->format;
+			op.len = p - literal;
+			g_array_append_val (ops, op);
+		}
+
+		if (*p == '\0' || *(p + 1) == '\0') {
+			break;
+		}
+
+		op.code = *(p + 1);
+		op.start = 0;
+		op.len = 0;
+
+		switch (op.code) {
+		case 'a': case 'A': case 'b': case 'B': case 'd': case 'e':
+		case 'H': case 'I': case 'k': case 'l': case 'm': case 'M':
+		case 'R': case 'S': case 'y': case 'Y':
+			g_array_append_val (ops, op);
+			break;
+		case 'W':
+			compiled->needs_week = TRUE;
+			g_array_append_val (ops, op);
+			break;
+		case 'j':
+			g_warning ("%%j not implemented.");
+			g_array_append_val (ops, op);
+			break;
+		case 'p':
+		case 'P':
+			g_warning ("%%%c not yet implemented.", op.code);
+			g_array_append_val (ops, op);
+			break;
+		case 'U':
+			g_warning ("%%U not implemented");
+			break;
+		default:
+			g_warning ("Failed to parse format string.");
+			break;
+		}
+
+		p += 2;
+		literal = p;
+	}
+
+	compiled->n_ops = ops->len;
+	compiled->ops = (TimeFormatOp *) g_array_free (ops, FALSE);
+
+	return compiled;
+}
+
+/**
+ * mrp_time_format_free:
+ * @format: an #MrpTimeFormat
+ *
+ * Frees a format created with mrp_time_format_new().
+ **/
+void
+mrp_time_format_free (MrpTimeFormat *format)
+{
+	g_return_if_fail (format != NULL);
+
+	g_free (format->format);
+	g_free (format->ops);
+	g_free (format);
+}
+
+/**
+ * mrp_time_format_render:
+ * @format: an #MrpTimeFormat
+ * @t: an #mrptime value
+ * @buf: buffer to write the string to
+ * @size: size of @buf in bytes
+ *
+ * Formats @t into @buf. Like snprintf(), the output is truncated to fit
+ * and always nul-terminated if @size is positive.
+ *
+ * Return value: The length of the whole formatted string, without the
+ * terminating nul. If this is @size or more the output was truncated.
+ **/
+gint
+mrp_time_format_render (MrpTimeFormat *format,
+			mrptime        t,
+			gchar         *buf,
+			gint           size)
+{
+	TimeFormatOp *op;
+	glong         days;
+	gint          secs;
+	gint          year, month, day;
+	gint          hour, min, sec;
+	gint          weekday;
+	gint          week = 0;
+	gint          len = 0;
+	gint          i;
+
+	g_return_val_if_fail (format != NULL, 0);
+	g_return_val_if_fail (buf != NULL || size == 0, 0);
+
+	days = time_split (t, &secs);
+	time_civil_from_days (days, &year, &month, &day);
+
+	hour = secs / SECS_IN_HOUR;
+	min = secs % SECS_IN_HOUR / SECS_IN_MIN;
+	sec = secs % SECS_IN_MIN;
+
+	/* The name arrays start on Sunday. */
+	weekday = (time_weekday_from_monday (days) + 1) % 7;
+
+	if (format->needs_week) {
+		week = mrp_time_week_number (t);
+	}
+
+	for (i = 0; i < format->n_ops; i++) {
+		op = &format->ops[i];
+
+		switch (op->code) {
+		case 0:
+			time_format_put (buf, size, &len,
+					 format->format + op->start, op->len);
+			break;
 		case 'a':
-			/* The abbreviated weekday name (Mon, Tue, ...). */
-			if (buffer) {
-				strcpy (buffer + len, short_day_names[weekday]);
-			}
-			len += strlen (short_day_names[weekday]);
+			time_format_put (buf, size, &len,
+					 short_day_names[weekday],
+					 strlen (short_day_names[weekday]));
 			break;
 		case 'A':
-			/* The full weekday name (Monday, Tuesday, ...). */
-			if (buffer) {
-				strcpy (buffer + len, day_names[weekday]);
-			}
-			len += strlen (day_names[weekday]);
+			time_format_put (buf, size, &len,
+					 day_names[weekday],
+					 strlen (day_names[weekday]));
 			break;
 		case 'b':
-			/* The abbreviated month name (Jan, Feb, ...). */
-			if (buffer) {
-				strcpy (buffer + len, short_month_names[month-1]);
-			}
-			len += strlen (short_month_names[month-1]);
+			time_format_put (buf, size, &len,
+					 short_month_names[month - 1],
+					 strlen (short_month_names[month - 1]));
 			break;
 		case 'B':
-			/* The full month name (January, February, ...). */
-			if (buffer) {
-				strcpy (buffer + len, month_names[month-1]);
-			}
-			len += strlen (month_names[month-1]);
+			time_format_put (buf, size, &len,
+					 month_names[month - 1],
+					 strlen (month_names[month - 1]));
 			break;
 		case 'd':
-			/* The day of the month (01 - 31). */
-			if (buffer) {
-				buffer[len] = day / 10 + '0';
-				buffer[len+1] = day - 10 * (day / 10) + '0';
-			}
-			len += 2;
+			time_format_put_number (buf, size, &len, day, 2);
 			break;
 		case 'e':
-			/* The day of the month (1 - 31). */
-			if (buffer) {
-				if (day > 9) {
-					buffer[len] = day / 10 + '0';
-					buffer[len+1] = day - 10 * (day / 10) + '0';
-				} else {
-					buffer[len] = day + '0';
-				}
-			}
-			len += day > 9 ? 2 : 1;
+			time_format_put_number (buf, size, &len, day, 1);
 			break;
 		case 'H':
-			/* The hour using a 24-hour clock (00 - 23). */
-			if (buffer) {
-				buffer[len] = hour / 10 + '0';
-				buffer[len+1] = hour - 10 * (hour / 10) + '0';
-			}
-			len += 2;
+			time_format_put_number (buf, size, &len, hour, 2);
 			break;
 		case 'I':
-			/* The hour using a 12-hour clock (01 - 12). */
-			if (buffer) {
-				tmp = hour % 12;
-
-				if (tmp == 0) {
-					tmp = 12;
-				}
-
-				buffer[len] = tmp / 10 + '0';
-				buffer[len+1] = tmp - 10 * (tmp / 10) + '0';
-			}
-			len += 2;
-			break;
-		case 'j':
-			/* The day of the year (001 - 366). */
-			g_warning ("%%j not implemented.");
-			if (buffer) {
-				buffer[len] = ' ';
-				buffer[len+1] = ' ';
-				buffer[len+2] = ' ';
-			}
-			len += 3;
+			time_format_put_number (buf, size, &len,
+						hour % 12 == 0 ? 12 : hour % 12, 2);
 			break;
 		case 'k':
-			/* The hour using a 24-hour clock (0 to 23). */
-			if (buffer) {
-				if (hour > 9) {
-					buffer[len] = hour / 10 + '0';
-					buffer[len+1] = hour - 10 * (hour / 10) + '0';
-				} else {
-					buffer[len] = hour + '0';
-				}
-			}
-			len += hour > 9 ? 2 : 1;
+			time_format_put_number (buf, size, &len, hour, 1);
 			break;
 		case 'l':
-			/* The hour using a 12-hour clock (1 - 12). */
-			tmp = hour % 12;
-			if (tmp == 0) {
-				tmp = 12;
-			}
-
-			if (buffer) {
-				if (tmp > 9) {
-					buffer[len] = tmp / 10 + '0';
-					buffer[len+1] = tmp - 10 * (tmp / 10) + '0';
-				} else {
-					buffer[len] = tmp + '0';
-				}
-			}
-			len += tmp > 9 ? 2 : 1;
+			time_format_put_number (buf, size, &len,
+						hour % 12 == 0 ? 12 : hour % 12, 1);
 			break;
 		case 'm':
-			/* The month number (01 to 12). */
-			if (buffer) {
-				buffer[len] = month / 10 + '0';
-				buffer[len+1] = month - 10 * (month / 10) + '0';
-			}
-			len += 2;
+			time_format_put_number (buf, size, &len, month, 2);
 			break;
 		case 'M':
-			/* The minute (00 - 59). */
-			if (buffer) {
-				buffer[len] = min / 10 + '0';
-				buffer[len+1] = min - 10 * (min / 10) + '0';
-			}
-			len += 2;
-			break;
-		case 'p':
-			/* Either 'AM' or 'PM' according  to the given time value. */
-			g_warning ("%%p not yet implemented.");
-			if (buffer) {
-				buffer[len] = ' ';
-				buffer[len+1] = ' ';
-			}
-			len += 2;
-			break;
-		case 'P':
-			/* Like %p but in lowercase. */
-			g_warning ("%%P not yet implemented.");
-			if (buffer) {
-				buffer[len] = ' ';
-				buffer[len+1] = ' ';
-			}
-			len += 2;
+			time_format_put_number (buf, size, &len, min, 2);
 			break;
 		case 'R':
-			/* The time in 24 hour notation (%H:%M). FIXME: use locale. */
-			if (buffer) {
-				buffer[len] = hour / 10 + '0';
-				buffer[len+1] = hour - 10 * (hour / 10) + '0';
-			}
-			len += 2;
-
-			if (buffer) {
-				buffer[len] = ':';
-			}
-			len++;
-
-			if (buffer) {
-				buffer[len] = min / 10 + '0';
-				buffer[len+1] = min - 10 * (min / 10) + '0';
-			}
-			len += 2;
+			/* FIXME: use locale. */
+			time_format_put_number (buf, size, &len, hour, 2);
+			time_format_put (buf, size, &len, ":", 1);
+			time_format_put_number (buf, size, &len, min, 2);
 			break;
 		case 'S':
-			/* The second (00 - 61). */
-			if (buffer) {
-				buffer[len] = sec / 10 + '0';
-				buffer[len+1] = sec - 10 * (sec / 10) + '0';
-			}
-			len += 2;
-			break;
-		case 'U':
-			/* The week number, (1 - 53), starting with the first
-			 * Sunday as the first day of week 1.
-			 */
-			g_warning ("%%W not implemented");
+			time_format_put_number (buf, size, &len, sec, 2);
 			break;
 		case 'W':
-			/* The week number, (1 - 53), starting with the first
-			 *  Monday as the first day of week 1.
-			 */
-			snprintf (str, sizeof (str), "%d", mrp_time2_get_week_number (t, NULL));
-			if (buffer) {
-				strcpy (buffer + len, str);
-			}
-			len += strlen (str);
+			time_format_put_number (buf, size, &len, week, 1);
 			break;
 		case 'y':
-			/* The year without a century (range 00 to 99). */
-			if (buffer) {
-				tmp = year % 100;
-				buffer[len] = tmp / 10 + '0';
-				tmp -= 10 * (tmp / 10);
-				buffer[len+1] = tmp + '0';
-			}
-			len += 2;
+			time_format_put_number (buf, size, &len, year % 100, 2);
 			break;
 		case 'Y':
-			/* The year including the century. */
-			if (buffer) {
-				tmp = year;
-				buffer[len] = tmp / 1000 + '0';
-				tmp -= 1000 * (tmp / 1000);
-				buffer[len+1] = tmp / 100 + '0';
-				tmp -= 100 * (tmp / 100);
-				buffer[len+2] = tmp / 10 + '0';
-				tmp -= 10 * (tmp / 10);
-				buffer[len+3] = tmp + '0';
-			}
-			len += 4;
+			time_format_put_number (buf, size, &len, year, 4);
 			break;
-		default:
-			g_warning ("Failed to parse format string.");
+		case 'j':
+			time_format_put (buf, size, &len, "   ", 3);
+			break;
+		case 'p':
+		case 'P':
+			time_format_put (buf, size, &len, "  ", 2);
 			break;
 		}
 	}
 
-	if (buffer) {
-		buffer[len] = 0;
+	if (size > 0) {
+		buf[MIN (len, size - 1)] = '\0';
 	}
 
-	/* Include the terminating zero. */
-	return len + 1;
+	return len;
 }
 
 /**
@@ -915,22 +1148,36 @@ time_format_helper (const gchar *format,
  * %Y     The year including the century.
  * </programlisting></informalexample>
  *
+ * If the same format is used for many times, compile it once with
+ * mrp_time_format_new() and use mrp_time_format_render().
+ *
  * Return value: Newly created string that needs to be freed.
  **/
 gchar *
 mrp_time_format (const gchar *format, mrptime t)
 {
-	MrpTime  t2;
-	gint     len;
-	gchar   *buffer;
+	MrpTimeFormat *compiled;
+	gchar          buf[256];
+	gchar         *str;
+	gint           len;
 
-	mrp_time2_set_epoch (&t2, t);
+	if (!format) {
+		return g_strdup ("");
+	}
+
+	compiled = mrp_time_format_new (format);
+
+	len = mrp_time_format_render (compiled, t, buf, sizeof (buf));
+	if (len < (gint) sizeof (buf)) {
+		str = g_strdup (buf);
+	} else {
+		str = g_malloc (len + 1);
+		mrp_time_format_render (compiled, t, str, len + 1);
+	}
 
-	len = time_format_helper (format, &t2, NULL);
-	buffer = g_malloc (len);
-	time_format_helper (format, &t2, buffer);
+	mrp_time_format_free (compiled);
 
-	return buffer;
+	return str;
 }
 
 /**
@@ -945,13 +1192,13 @@ mrp_time_format (const gchar *format, mrptime t)
 gchar *
 mrp_time_format_locale (mrptime t)
 {
-	struct tm   *tm;
+	struct tm    tm;
 	gchar        buffer[256];
 	const gchar *format = "%x"; /* Keep in variable get rid of warning. */
 
-	tm = mrp_time_to_tm (t);
+	mrp_time_to_tm (t, &tm);
 
-	if (!strftime (buffer, sizeof (buffer), format, tm)) {
+	if (!strftime (buffer, sizeof (buffer), format, &tm)) {
 		return g_strdup ("");
 	}
 
@@ -963,10 +1210,6 @@ mrp_time_format_locale (mrptime t)
  * New API, the long-term plan is to move completely to this.
  */
 
-#define SECS_IN_MIN  60
-#define SECS_IN_HOUR (60*60)
-#define SECS_IN_DAY  (60*60*24)
-
 MrpTime *
 mrp_time2_new (void)
 {
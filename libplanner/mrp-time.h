@@ -35,6 +35,11 @@ typedef long mrptime;
 #define MRP_TIME_MIN 0
 #define MRP_TIME_MAX 2147483647
 
+/* "YYYYMMDDTHHMMSSZ" and the terminating nul. */
+#define MRP_TIME_STRING_LEN 17
+
+typedef struct _MrpTimeFormat MrpTimeFormat;
+
 typedef enum {
 	MRP_TIME_UNIT_NONE,
 	MRP_TIME_UNIT_YEAR,
@@ -65,6 +70,8 @@ gboolean     mrp_time_decompose          (mrptime       t,
 mrptime      mrp_time_from_string        (const gchar  *str,
 					  GError      **err);
 gchar *      mrp_time_to_string          (mrptime       t);
+void         mrp_time_to_string_buf      (mrptime       t,
+					  gchar        *buf);
 mrptime      mrp_time_from_msdate_string (const gchar  *str);
 mrptime      mrp_time_align_day          (mrptime       t);
 mrptime      mrp_time_align_prev         (mrptime       t,
@@ -79,6 +86,12 @@ const gchar *mrp_time_month_name_initial (mrptime       t);
 gchar *      mrp_time_format             (const gchar  *format,
 					  mrptime       t);
 gchar *      mrp_time_format_locale      (mrptime       t);
+MrpTimeFormat *mrp_time_format_new       (const gchar  *format);
+void         mrp_time_format_free        (MrpTimeFormat *format);
+gint         mrp_time_format_render      (MrpTimeFormat *format,
+					  mrptime       t,
+					  gchar        *buf,
+					  gint          size);
 void         mrp_time_debug_print        (mrptime       t);
 GParamSpec * mrp_param_spec_time         (const gchar  *name,
 					  const gchar  *nick,
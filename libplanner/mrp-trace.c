@@ -0,0 +1,236 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "mrp-trace.h"
+
+typedef enum {
+	TRACE_UNKNOWN,
+	TRACE_OFF,
+	TRACE_ON
+} TraceState;
+
+static TraceState  state = TRACE_UNKNOWN;
+static gboolean    hud = FALSE;
+static FILE       *trace_file = NULL;
+static gboolean    first_event = TRUE;
+static gint64      epoch = 0;
+
+/* Event name -> duration of its latest occurrence, in microseconds. */
+static GHashTable *last_durations = NULL;
+
+static gint        counters[MRP_TRACE_NUM_COUNTERS];
+
+static void
+trace_close (void)
+{
+	if (trace_file) {
+		fputs ("\n]\n", trace_file);
+		fclose (trace_file);
+		trace_file = NULL;
+	}
+}
+
+static void
+trace_init (void)
+{
+	const gchar *filename;
+
+	filename = g_getenv ("PLANNER_TRACE");
+	hud = g_getenv ("PLANNER_DEBUG_PERF_HUD") != NULL;
+
+	if (filename && filename[0] != 0) {
+		trace_file = fopen (filename, "w");
+		if (trace_file) {
+			fputs ("[\n", trace_file);
+			atexit (trace_close);
+		} else {
+			g_warning ("Could not open trace file '%s'.", filename);
+		}
+	}
+
+	if (trace_file || hud) {
+		state = TRACE_ON;
+		last_durations = g_hash_table_new_full (g_str_hash,
+							g_str_equal,
+							g_free,
+							g_free);
+		epoch = mrp_trace_now ();
+	} else {
+		state = TRACE_OFF;
+	}
+}
+
+gboolean
+mrp_trace_is_enabled (void)
+{
+	if (state == TRACE_UNKNOWN) {
+		trace_init ();
+	}
+
+	return state == TRACE_ON;
+}
+
+gboolean
+mrp_trace_hud_is_enabled (void)
+{
+	return mrp_trace_is_enabled () && hud;
+}
+
+/* Returns a timestamp in microseconds, only meaningful for differences.
+ * Uses the monotonic clock so that wall clock adjustments don't end up in
+ * the durations.
+ */
+gint64
+mrp_trace_now (void)
+{
+#if GLIB_CHECK_VERSION (2, 28, 0)
+	return g_get_monotonic_time ();
+#else
+	GTimeVal tv;
+
+	g_get_current_time (&tv);
+
+	return (gint64) tv.tv_sec * G_USEC_PER_SEC + tv.tv_usec;
+#endif
+}
+
+/* Records an event that started at @start and ends now. The arguments
+ * are pairs of names and integer values, terminated by NULL, and end up
+ * in the "args" of the trace event.
+ */
+void
+mrp_trace_complete (const gchar *name,
+		    gint64       start,
+		    const gchar *first_arg_name,
+		    ...)
+{
+	gint64       end;
+	gint64      *duration;
+	const gchar *arg_name;
+	gboolean     first_arg;
+	va_list      args;
+
+	g_return_if_fail (name != NULL);
+
+	if (!mrp_trace_is_enabled ()) {
+		return;
+	}
+
+	end = mrp_trace_now ();
+
+	duration = g_hash_table_lookup (last_durations, name);
+	if (!duration) {
+		duration = g_new (gint64, 1);
+		g_hash_table_insert (last_durations, g_strdup (name), duration);
+	}
+	*duration = end - start;
+
+	if (!trace_file) {
+		return;
+	}
+
+	fprintf (trace_file,
+		 "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+		 "\"ts\":%" G_GINT64_FORMAT ",\"dur\":%" G_GINT64_FORMAT,
+		 first_event ? "" : ",\n",
+		 name,
+		 start - epoch,
+		 end - start);
+
+	first_event = FALSE;
+
+	if (first_arg_name) {
+		fputs (",\"args\":{", trace_file);
+
+		first_arg = TRUE;
+		va_start (args, first_arg_name);
+		for (arg_name = first_arg_name; arg_name; arg_name = va_arg (args, const gchar *)) {
+			fprintf (trace_file, "%s\"%s\":%d",
+				 first_arg ? "" : ",",
+				 arg_name,
+				 va_arg (args, gint));
+			first_arg = FALSE;
+		}
+		va_end (args);
+
+		fputc ('}', trace_file);
+	}
+
+	fputc ('}', trace_file);
+}
+
+/* Returns the duration of the latest @name event in microseconds, or -1 if
+ * there hasn't been one.
+ */
+gint64
+mrp_trace_get_last_duration (const gchar *name)
+{
+	gint64 *duration;
+
+	if (!mrp_trace_is_enabled ()) {
+		return -1;
+	}
+
+	duration = g_hash_table_lookup (last_durations, name);
+
+	return duration ? *duration : -1;
+}
+
+/* Adds @n to the counter. Does nothing unless tracing is enabled, callers
+ * in hot paths should check mrp_trace_is_enabled() themselves to skip the
+ * call altogether.
+ */
+void
+mrp_trace_count (MrpTraceCounter counter,
+		 gint            n)
+{
+	if (counter >= MRP_TRACE_NUM_COUNTERS || !mrp_trace_is_enabled ()) {
+		return;
+	}
+
+	g_atomic_int_add (&counters[counter], n);
+}
+
+/* Returns the counter's value and resets it. */
+gint
+mrp_trace_take_count (MrpTraceCounter counter)
+{
+	gint n;
+
+	g_return_val_if_fail (counter < MRP_TRACE_NUM_COUNTERS, 0);
+
+	do {
+		n = g_atomic_int_get (&counters[counter]);
+	} while (!g_atomic_int_compare_and_exchange (&counters[counter], n, 0));
+
+	return n;
+}
+
+void
+mrp_trace_flush (void)
+{
+	if (trace_file) {
+		fflush (trace_file);
+	}
+}
@@ -0,0 +1,54 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Lightweight timing instrumentation, off unless asked for.
+ *
+ * Set PLANNER_TRACE to a file name to get a trace of the expensive
+ * operations (recalc, reflow, expose) in Chrome's trace event format,
+ * loadable in chrome://tracing. PLANNER_DEBUG_PERF_HUD makes the charts
+ * show the latest numbers on top of the canvas.
+ */
+
+#ifndef __MRP_TRACE_H__
+#define __MRP_TRACE_H__
+
+#include <glib.h>
+
+typedef enum {
+	MRP_TRACE_COUNTER_ROWS_DRAWN,
+	MRP_TRACE_COUNTER_CALENDAR_LOOKUPS,
+	MRP_TRACE_NUM_COUNTERS
+} MrpTraceCounter;
+
+gboolean mrp_trace_is_enabled        (void);
+gboolean mrp_trace_hud_is_enabled    (void);
+gint64   mrp_trace_now               (void);
+void     mrp_trace_complete          (const gchar     *name,
+				      gint64           start,
+				      const gchar     *first_arg_name,
+				      ...);
+gint64   mrp_trace_get_last_duration (const gchar     *name);
+void     mrp_trace_count             (MrpTraceCounter  counter,
+				      gint             n);
+gint     mrp_trace_take_count        (MrpTraceCounter  counter);
+void     mrp_trace_flush             (void);
+
+#endif /* __MRP_TRACE_H__ */
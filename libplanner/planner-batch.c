@@ -0,0 +1,327 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* A command line tool that loads, reschedules and saves or exports
+ * projects without any user interface. It only links against
+ * libplanner, so starting it is cheap enough to run over many files.
+ */
+
+#include <config.h>
+#include <locale.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#ifndef WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+#include "mrp-application.h"
+#include "mrp-project.h"
+#include "mrp-paths.h"
+
+typedef struct {
+	const gchar *name;
+	const gchar *extension;
+	const gchar *writer;     /* File writer, or NULL to save with storage. */
+} BatchFormat;
+
+/* "planner" is the native format, written by the storage module.
+ * "xml-0.11" is the file format of Planner before 0.12, written by the
+ * XSL downgrade stylesheet.
+ */
+static const BatchFormat formats[] = {
+	{ "planner",  ".planner", NULL },
+	{ "html",     ".html",    "text/html" },
+	{ "xml-0.11", ".xml",     "text/xml" },
+	{ NULL }
+};
+
+/* Command line options */
+static gboolean   reschedule = FALSE;
+static gchar     *format_name = NULL;
+static gchar     *output = NULL;
+static gchar     *output_dir = NULL;
+static gint       jobs = 1;
+static gchar    **args_remaining = NULL;
+
+static GOptionEntry options[] = {
+	{ "reschedule", 'r', 0, G_OPTION_ARG_NONE, &reschedule, N_("Reschedule the projects before saving them."), NULL },
+	{ "format", 'f', 0, G_OPTION_ARG_STRING, &format_name, N_("Output format: planner (native, the default), html, or xml-0.11 (the format of Planner before 0.12)."), N_("FORMAT") },
+	{ "output", 'o', 0, G_OPTION_ARG_STRING, &output, N_("Output file or sql:// URI, when processing a single project."), N_("URI") },
+	{ "output-dir", 'd', 0, G_OPTION_ARG_FILENAME, &output_dir, N_("Directory for the output files (default: next to the input)."), N_("DIR") },
+	{ "jobs", 'j', 0, G_OPTION_ARG_INT, &jobs, N_("Number of projects to process in parallel."), N_("N") },
+	{ G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &args_remaining, NULL, N_("FILES|URIs") },
+	{ NULL }
+};
+
+static const BatchFormat *
+batch_get_format (const gchar *name)
+{
+	gint i;
+
+	if (!name) {
+		return &formats[0];
+	}
+
+	for (i = 0; formats[i].name; i++) {
+		if (strcmp (formats[i].name, name) == 0) {
+			return &formats[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* The output file for an input file: the same name with the extension of
+ * the format, in the output directory if there is one.
+ */
+static gchar *
+batch_get_output_uri (const gchar *arg, const BatchFormat *format)
+{
+	gchar *base, *dot;
+	gchar *dir;
+	gchar *filename;
+	gchar *uri;
+
+	if (output) {
+		return mrp_project_make_uri (output);
+	}
+
+	base = g_path_get_basename (arg);
+	dot = strrchr (base, '.');
+	if (dot) {
+		*dot = '\0';
+	}
+
+	if (output_dir) {
+		dir = g_strdup (output_dir);
+	} else {
+		dir = g_path_get_dirname (arg);
+	}
+
+	filename = g_strconcat (base, format->extension, NULL);
+	g_free (base);
+
+	base = g_build_filename (dir, filename, NULL);
+	uri = mrp_project_make_uri (base);
+
+	g_free (base);
+	g_free (filename);
+	g_free (dir);
+
+	return uri;
+}
+
+static gboolean
+batch_process (MrpApplication    *app,
+	       const gchar       *arg,
+	       const BatchFormat *format)
+{
+	MrpProject *project;
+	GTimer     *timer;
+	GError     *error = NULL;
+	gchar      *uri;
+	gchar      *output_uri;
+	gboolean    success;
+	gdouble     load_time;
+	gdouble     schedule_time = 0;
+	gdouble     save_time = 0;
+
+	timer = g_timer_new ();
+
+	project = mrp_project_new (app);
+
+	uri = mrp_project_make_uri (arg);
+	success = uri && mrp_project_load (project, uri, &error);
+	g_free (uri);
+
+	load_time = g_timer_elapsed (timer, NULL);
+
+	if (success && reschedule) {
+		g_timer_start (timer);
+		mrp_project_reschedule (project);
+		schedule_time = g_timer_elapsed (timer, NULL);
+	}
+
+	if (success) {
+		g_timer_start (timer);
+
+		output_uri = batch_get_output_uri (arg, format);
+
+		if (format->writer) {
+			success = mrp_project_export (project, output_uri,
+						      format->writer, TRUE, &error);
+		} else {
+			success = mrp_project_save_as (project, output_uri,
+						       TRUE, &error);
+		}
+
+		g_free (output_uri);
+
+		save_time = g_timer_elapsed (timer, NULL);
+	}
+
+	/* One line per file, written in one go so that lines from
+	 * parallel workers don't mix.
+	 */
+	if (success) {
+		printf ("%s\tok\t%.1f\t%.1f\t%.1f\n",
+			arg,
+			1000 * load_time,
+			1000 * schedule_time,
+			1000 * save_time);
+	} else {
+		printf ("%s\t%s\n",
+			arg,
+			error ? error->message : _("Invalid file name"));
+	}
+	fflush (stdout);
+
+	if (error) {
+		g_error_free (error);
+	}
+
+	g_object_unref (project);
+	g_timer_destroy (timer);
+
+	return success;
+}
+
+/* Processes every n_workers:th file starting at @worker. Returns the
+ * number of failed files.
+ */
+static gint
+batch_run_worker (gint worker, gint n_workers, const BatchFormat *format)
+{
+	MrpApplication *app;
+	gint            failed = 0;
+	gint            i;
+
+	app = mrp_application_new ();
+
+	for (i = worker; args_remaining[i]; i += n_workers) {
+		if (!batch_process (app, args_remaining[i], format)) {
+			failed++;
+		}
+	}
+
+	g_object_unref (app);
+
+	return failed;
+}
+
+int
+main (int argc, char **argv)
+{
+	GOptionContext    *context;
+	const BatchFormat *format;
+	GError            *error = NULL;
+	gchar             *locale_dir;
+	gint               n_files;
+	gint               failed = 0;
+#ifndef WIN32
+	pid_t             *pids;
+	gint               i, status;
+#endif
+
+	setlocale (LC_ALL, "");
+
+	locale_dir = mrp_paths_get_locale_dir ();
+	bindtextdomain (GETTEXT_PACKAGE, locale_dir);
+	g_free (locale_dir);
+	bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
+	textdomain (GETTEXT_PACKAGE);
+
+	g_type_init ();
+
+	context = g_option_context_new (_("- reschedule, convert and export projects"));
+	g_option_context_add_main_entries (context, options, GETTEXT_PACKAGE);
+
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("%s\n", error->message);
+		g_error_free (error);
+		g_option_context_free (context);
+		return 2;
+	}
+
+	g_option_context_free (context);
+
+	format = batch_get_format (format_name);
+	if (!format) {
+		g_printerr (_("Unknown format '%s'.\n"), format_name);
+		return 2;
+	}
+
+	n_files = args_remaining ? g_strv_length (args_remaining) : 0;
+	if (n_files == 0) {
+		g_printerr (_("No projects given.\n"));
+		return 2;
+	}
+
+	if (output && n_files > 1) {
+		g_printerr (_("--output can only be used with a single project.\n"));
+		return 2;
+	}
+
+	jobs = CLAMP (jobs, 1, n_files);
+
+#ifndef WIN32
+	if (jobs > 1) {
+		/* Each worker loads the modules and projects on its own, so
+		 * they don't share any state.
+		 */
+		pids = g_new0 (pid_t, jobs);
+
+		for (i = 0; i < jobs; i++) {
+			pids[i] = fork ();
+
+			if (pids[i] == 0) {
+				_exit (batch_run_worker (i, jobs, format) > 0 ? 1 : 0);
+			}
+			else if (pids[i] < 0) {
+				g_printerr (_("Could not start worker: %s\n"),
+					    g_strerror (errno));
+				failed++;
+			}
+		}
+
+		for (i = 0; i < jobs; i++) {
+			if (pids[i] > 0 &&
+			    (waitpid (pids[i], &status, 0) < 0 ||
+			     !WIFEXITED (status) || WEXITSTATUS (status) != 0)) {
+				failed++;
+			}
+		}
+
+		g_free (pids);
+
+		return failed > 0 ? 1 : 0;
+	}
+#endif
+
+	failed = batch_run_worker (0, 1, format);
+
+	return failed > 0 ? 1 : 0;
+}
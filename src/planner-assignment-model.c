@@ -200,12 +200,12 @@ mam_get_value (GtkTreeModel *tree_model,
                 g_free (str);
                 break;
         case RESOURCE_ASSIGNMENT_COL_UNITS:
-                g_object_get (resource, "units", &units, NULL);
+                units = mrp_resource_get_units (resource);
                 g_value_init (value, G_TYPE_INT);
                 g_value_set_int (value, units);
                 break;
         case RESOURCE_ASSIGNMENT_COL_COST_STD:
-                mrp_object_get (resource, "cost", &rate, NULL);
+                rate = mrp_resource_get_cost (resource);
                 g_value_init (value, G_TYPE_FLOAT);
                 g_value_set_int (value, rate);
                 break;
@@ -19,6 +19,7 @@
  */
 
 #include <config.h>
+#include <string.h>
 #include <glib.h>
 #include <glib/gi18n.h>
 #include "planner-cmd-manager.h"
@@ -26,6 +27,7 @@
 
 struct _PlannerCmdManagerPriv {
 	gint   limit;
+	gsize  byte_limit;
 
 	GList *list;
 	GList *current;
@@ -37,6 +39,8 @@ struct _PlannerCmdManagerPriv {
 enum {
 	UNDO_STATE_CHANGED,
 	REDO_STATE_CHANGED,
+	TRANSACTION_BEGIN,
+	TRANSACTION_END,
 	LAST_SIGNAL
 };
 
@@ -106,6 +110,28 @@ cmd_manager_class_init (PlannerCmdManagerClass *klass)
 		NULL, NULL,
 		planner_marshal_VOID__BOOLEAN_STRING,
 		G_TYPE_NONE, 2, G_TYPE_BOOLEAN, G_TYPE_STRING);
+
+	/* Emitted around the commands of a transaction, both when it's
+	 * recorded and when it's undone or redone, so that listeners can
+	 * hold off expensive work like rescheduling until the end.
+	 */
+	signals[TRANSACTION_BEGIN] = g_signal_new (
+		"transaction_begin",
+		G_TYPE_FROM_CLASS (klass),
+		G_SIGNAL_RUN_LAST,
+		0,
+		NULL, NULL,
+		planner_marshal_VOID__VOID,
+		G_TYPE_NONE, 0);
+
+	signals[TRANSACTION_END] = g_signal_new (
+		"transaction_end",
+		G_TYPE_FROM_CLASS (klass),
+		G_SIGNAL_RUN_LAST,
+		0,
+		NULL, NULL,
+		planner_marshal_VOID__VOID,
+		G_TYPE_NONE, 0);
 }
 
 static void
@@ -116,10 +142,11 @@ cmd_manager_init (PlannerCmdManager *manager)
 	priv = g_new0 (PlannerCmdManagerPriv, 1);
 	manager->priv = priv;
 
-	/* Set a sane default, might need to make it tweakable. NOTE: Must be >
-	 * 1.
+	/* Set sane defaults, can be changed with planner_cmd_manager_set_limit
+	 * and planner_cmd_manager_set_byte_limit. NOTE: Must be > 1.
 	 */
 	priv->limit = 100;
+	priv->byte_limit = 16 * 1024 * 1024;
 }
 
 static void
@@ -258,6 +285,11 @@ cmd_manager_free_func (PlannerCmd *cmd,
 	g_free (cmd);
 }
 
+/* Trims the oldest operations off the history so that at most priv->limit
+ * operations are kept and their commands stay within priv->byte_limit bytes,
+ * counting whole transactions as one operation. The most recent operation is
+ * always kept, however large.
+ */
 static void
 cmd_manager_ensure_limit (PlannerCmdManager *manager)
 {
@@ -265,7 +297,9 @@ cmd_manager_ensure_limit (PlannerCmdManager *manager)
 	GList                 *l;
 	PlannerCmd            *cmd;
 	gboolean               inside_transaction;
+	gboolean               starts_operation;
 	gint                   num;
+	gsize                  bytes;
 
 	priv = manager->priv;
 
@@ -280,31 +314,47 @@ cmd_manager_ensure_limit (PlannerCmdManager *manager)
 
 	inside_transaction = FALSE;
 	num = 0;
+	bytes = 0;
 
-	/* Get the number of operations, counting whole transactions as one
-	 * operation.
+	/* The list is newest first, so a transaction starts with its END
+	 * command.
 	 */
 	for (l = priv->list; l; l = l->next) {
 		cmd = l->data;
 
+		starts_operation = !inside_transaction &&
+			cmd->type != PLANNER_CMD_TYPE_BEGIN_TRANSACTION;
+
 		if (cmd->type == PLANNER_CMD_TYPE_END_TRANSACTION) {
 			inside_transaction = TRUE;
 		}
 		else if (cmd->type == PLANNER_CMD_TYPE_BEGIN_TRANSACTION) {
 			inside_transaction = FALSE;
-			num++;
 		}
-		else if (!inside_transaction) {
+
+		if (starts_operation) {
+			if (num >= priv->limit) {
+				break;
+			}
+
+			if (num > 0 && priv->byte_limit > 0 && bytes >= priv->byte_limit) {
+				break;
+			}
+
 			num++;
 		}
 
-		if (cmd->type != PLANNER_CMD_TYPE_BEGIN_TRANSACTION && num > priv->limit) {
-			break;
-		}
+		bytes += cmd->size;
 	}
 
 	if (l != NULL) {
-		/* Trim the undo history. */
+		/* Trim the undo history. If the current command goes too,
+		 * everything that's left has been undone.
+		 */
+		if (priv->current && g_list_position (l, priv->current) >= 0) {
+			priv->current = NULL;
+		}
+
 		l->prev->next = NULL;
 		l->prev = NULL;
 
@@ -342,8 +392,6 @@ cmd_manager_insert (PlannerCmdManager *manager,
 		priv->list = current;
 	}
 
-	cmd_manager_ensure_limit (manager);
-
 	priv->list = g_list_prepend (priv->list, cmd);
 	priv->current = priv->list;
 
@@ -355,6 +403,11 @@ cmd_manager_insert (PlannerCmdManager *manager,
 		retval = TRUE;
 	}
 
+	/* Trim after running the command, it may have grown while saving the
+	 * state it needs for undo.
+	 */
+	cmd_manager_ensure_limit (manager);
+
 	cmd_manager_dump (manager);
 
 	state_changed (manager);
@@ -423,6 +476,55 @@ planner_cmd_manager_redo (PlannerCmdManager *manager)
 	return TRUE;
 }
 
+void
+planner_cmd_manager_set_limit (PlannerCmdManager *manager,
+			       gint               limit)
+{
+	g_return_if_fail (PLANNER_IS_CMD_MANAGER (manager));
+	g_return_if_fail (limit > 1);
+
+	manager->priv->limit = limit;
+
+	cmd_manager_ensure_limit (manager);
+	state_changed (manager);
+}
+
+/* A byte_limit of 0 means that the history is only limited by the number of
+ * operations.
+ */
+void
+planner_cmd_manager_set_byte_limit (PlannerCmdManager *manager,
+				    gsize              byte_limit)
+{
+	g_return_if_fail (PLANNER_IS_CMD_MANAGER (manager));
+
+	manager->priv->byte_limit = byte_limit;
+
+	cmd_manager_ensure_limit (manager);
+	state_changed (manager);
+}
+
+/* Forgets the whole history, for when the objects the commands refer to
+ * were replaced behind the manager's back.
+ */
+void
+planner_cmd_manager_clear (PlannerCmdManager *manager)
+{
+	PlannerCmdManagerPriv *priv;
+
+	g_return_if_fail (PLANNER_IS_CMD_MANAGER (manager));
+
+	priv = manager->priv;
+
+	g_list_foreach (priv->list, (GFunc) cmd_manager_free_func, NULL);
+	g_list_free (priv->list);
+
+	priv->list = NULL;
+	priv->current = NULL;
+
+	state_changed (manager);
+}
+
 PlannerCmdManager *
 planner_cmd_manager_new (void)
 {
@@ -447,6 +549,8 @@ transaction_cmd_do (PlannerCmd *cmd)
 {
 	PlannerCmd *cmd_sub;
 
+	g_signal_emit (cmd->manager, signals[TRANSACTION_BEGIN], 0);
+
 	while (1) {
 		cmd_sub = get_redo_cmd (cmd->manager, TRUE);
 
@@ -465,6 +569,8 @@ transaction_cmd_do (PlannerCmd *cmd)
 		g_assert (cmd_sub->type == PLANNER_CMD_TYPE_NORMAL);
 	}
 
+	g_signal_emit (cmd->manager, signals[TRANSACTION_END], 0);
+
 	/* FIXME: need to make sure we handle transactions that doesn't work. */
 
 	return TRUE;
@@ -475,6 +581,8 @@ transaction_cmd_undo (PlannerCmd *cmd)
 {
 	PlannerCmd *cmd_sub;
 
+	g_signal_emit (cmd->manager, signals[TRANSACTION_BEGIN], 0);
+
 	while (1) {
 		cmd_sub = get_undo_cmd (cmd->manager, TRUE);
 
@@ -492,6 +600,8 @@ transaction_cmd_undo (PlannerCmd *cmd)
 
 		g_assert (cmd_sub->type == PLANNER_CMD_TYPE_NORMAL);
 	}
+
+	g_signal_emit (cmd->manager, signals[TRANSACTION_END], 0);
 }
 
 gboolean
@@ -522,6 +632,8 @@ planner_cmd_manager_begin_transaction (PlannerCmdManager *manager,
 
 	cmd_manager_insert (manager, cmd, FALSE);
 
+	g_signal_emit (manager, signals[TRANSACTION_BEGIN], 0);
+
 	return TRUE;
 }
 
@@ -568,6 +680,10 @@ planner_cmd_manager_end_transaction (PlannerCmdManager *manager)
 
 	priv->inside_transaction = FALSE;
 
+	cmd_manager_ensure_limit (manager);
+
+	g_signal_emit (manager, signals[TRANSACTION_END], 0);
+
 	return TRUE;
 }
 
@@ -587,6 +703,8 @@ planner_cmd_new_size (gsize               size,
 	cmd->undo_func = undo_func;
 	cmd->free_func = free_func;
 
+	cmd->size = size + (name ? strlen (name) + 1 : 0);
+
 	return cmd;
 }
 
@@ -66,6 +66,12 @@ struct _PlannerCmd {
 	PlannerCmdFreeFunc  free_func;
 
 	PlannerCmdType      type;
+
+	/* Rough number of bytes kept alive by the command, used to keep the
+	 * undo history within its memory budget. Commands that hold on to
+	 * more than their own struct should add to it.
+	 */
+	gsize               size;
 };
 
 
@@ -78,6 +84,11 @@ gboolean           planner_cmd_manager_redo              (PlannerCmdManager  *ma
 gboolean           planner_cmd_manager_begin_transaction (PlannerCmdManager  *manager,
 							  const gchar        *name);
 gboolean           planner_cmd_manager_end_transaction   (PlannerCmdManager  *manager);
+void               planner_cmd_manager_set_limit         (PlannerCmdManager  *manager,
+							  gint                limit);
+void               planner_cmd_manager_set_byte_limit    (PlannerCmdManager  *manager,
+							  gsize               byte_limit);
+void               planner_cmd_manager_clear             (PlannerCmdManager  *manager);
 PlannerCmd *       planner_cmd_new_size                  (gsize               size,
 							  const gchar        *name,
 							  PlannerCmdDoFunc    do_func,
@@ -191,19 +191,24 @@ planner_format_duration (MrpProject *project,
 gchar *
 planner_format_date (mrptime date)
 {
-	gchar *svalue;
+	static MrpTimeFormat *format = NULL;
+	gchar                 buf[64];
 
 	if (date == MRP_TIME_INVALID) {
-		svalue = g_strdup ("");
-	} else {
+		return g_strdup ("");
+	}
+
+	if (!format) {
 		/* i18n: this string is the date nr and month name, displayed
 		 * e.g. in the date cells in the task tree. See
 		 * libmrproject/docs/DateFormat.
 		 */
-		svalue = mrp_time_format (_("%b %e"), date);
+		format = mrp_time_format_new (_("%b %e"));
 	}
 
-	return svalue;
+	mrp_time_format_render (format, date, buf, sizeof (buf));
+
+	return g_strdup (buf);
 }
 
 gchar *
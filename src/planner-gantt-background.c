@@ -27,6 +27,7 @@
 #include <glib/gi18n.h>
 #include <libplanner/mrp-project.h>
 #include <libplanner/mrp-time.h>
+#include <libplanner/mrp-trace.h>
 #include "planner-gantt-background.h"
 #include "planner-scale-utils.h"
 
@@ -490,6 +491,7 @@ gantt_background_draw (GnomeCanvasItem *item,
 	gint                   level;
 	gdouble                i2w_dx,i2w_dy;
 	gint                   xx,yy;
+	gint64                 start;
 
 	background = PLANNER_GANTT_BACKGROUND (item);
 	priv = background->priv;
@@ -498,6 +500,8 @@ gantt_background_draw (GnomeCanvasItem *item,
 		return;
 	}
 
+	start = mrp_trace_now ();
+
 	calendar = mrp_project_get_calendar (priv->project);
 
 	hscale = priv->hscale;
@@ -674,6 +678,10 @@ gantt_background_draw (GnomeCanvasItem *item,
 			       cx1 - x,
 			       cy2 + DASH_LENGTH - y);
 	}
+
+	mrp_trace_complete ("gantt-background", start,
+			    "days", (gint) ((t2 - t0) / (60*60*24)) + 1,
+			    NULL);
 }
 
 static void
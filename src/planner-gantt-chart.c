@@ -30,6 +30,7 @@
 #include <gdk/gdkkeysyms.h>
 #include <glib/gi18n.h>
 #include <libplanner/mrp-task.h>
+#include <libplanner/mrp-trace.h>
 #include "planner-marshal.h"
 #include "planner-conf.h"
 #include "planner-gantt-chart.h"
@@ -39,6 +40,7 @@
 #include "planner-gantt-row.h"
 #include "planner-relation-arrow.h"
 #include "planner-scale-utils.h"
+#include "planner-perf-hud.h"
 
 /* Padding to the left and right of the contents of the gantt chart. */
 #define PADDING 100.0
@@ -88,6 +90,18 @@ struct _PlannerGanttChartPriv {
 
 	GHashTable      *relation_hash;
 
+	/* Visible rows in display order, used for hit-testing without
+	 * walking every canvas item. Rebuilt lazily after structural changes.
+	 */
+	GPtrArray       *row_index;
+	gboolean         row_index_valid;
+
+	/* Relation arrows waiting to be routed. They are routed together
+	 * once per reflow or recalc, and skipped while off-screen.
+	 */
+	GHashTable      *dirty_arrows;
+	guint            arrow_layout_idle_id;
+
 	GnomeCanvasItem *background;
 
 	gdouble          zoom;
@@ -183,6 +197,8 @@ static void        gantt_chart_task_removed             (MrpTask            *tas
 static void        gantt_chart_build_tree               (PlannerGanttChart  *chart);
 static void        gantt_chart_reflow                   (PlannerGanttChart  *chart,
 							 gboolean            height_changed);
+static void        gantt_chart_queue_arrow_layout       (PlannerGanttChart  *chart);
+static void        gantt_chart_layout_arrows            (PlannerGanttChart  *chart);
 static TreeNode *  gantt_chart_insert_task              (PlannerGanttChart  *chart,
 							 GtkTreePath        *path,
 							 MrpTask            *task);
@@ -370,6 +386,8 @@ gantt_chart_init (PlannerGanttChart *chart)
 	/* Easiest way to get access to the chart from the canvas items. */
 	g_object_set_data (G_OBJECT (priv->canvas), "chart", chart);
 
+	planner_perf_hud_attach (priv->canvas, "gantt");
+
 	gtk_box_pack_start (GTK_BOX (chart),
 			    GTK_WIDGET (priv->canvas),
 			    TRUE,
@@ -389,6 +407,12 @@ gantt_chart_init (PlannerGanttChart *chart)
 
 	priv->relation_hash = g_hash_table_new (NULL, NULL);
 
+	priv->row_index = g_ptr_array_new ();
+	priv->row_index_valid = FALSE;
+
+	priv->dirty_arrows = g_hash_table_new (NULL, NULL);
+	priv->arrow_layout_idle_id = 0;
+
 	priv->highlight_critical = planner_conf_get_bool (CRITICAL_PATH_KEY,
 							  NULL);
 	priv->nonstandard_days   = planner_conf_get_bool (NOSTDDAYS_PATH_KEY,
@@ -458,6 +482,8 @@ gantt_chart_finalize (GObject *object)
 	PlannerGanttChart *chart = PLANNER_GANTT_CHART (object);
 
 	g_hash_table_destroy (chart->priv->relation_hash);
+	g_ptr_array_free (chart->priv->row_index, TRUE);
+	g_hash_table_destroy (chart->priv->dirty_arrows);
 
 	g_free (chart->priv);
 
@@ -479,6 +505,15 @@ gantt_chart_destroy (GtkObject *object)
 		chart->priv->tree = NULL;
 	}
 
+	g_ptr_array_set_size (chart->priv->row_index, 0);
+	chart->priv->row_index_valid = FALSE;
+
+	if (chart->priv->arrow_layout_idle_id != 0) {
+		g_source_remove (chart->priv->arrow_layout_idle_id);
+		chart->priv->arrow_layout_idle_id = 0;
+	}
+	g_hash_table_remove_all (chart->priv->dirty_arrows);
+
 	if (chart->priv->model != NULL) {
 		g_object_unref (chart->priv->model);
 		chart->priv->model = NULL;
@@ -594,6 +629,18 @@ gantt_chart_size_allocate (GtkWidget     *widget,
 	}
 }
 
+/* Arrows skipped by the layout pass because they were off-screen need to
+ * be routed when they are scrolled into view.
+ */
+static void
+gantt_chart_adjustment_value_changed (GtkAdjustment     *adjustment,
+				      PlannerGanttChart *chart)
+{
+	if (g_hash_table_size (chart->priv->dirty_arrows) > 0) {
+		gantt_chart_queue_arrow_layout (chart);
+	}
+}
+
 static void
 gantt_chart_set_adjustments (PlannerGanttChart *chart,
 			     GtkAdjustment     *hadj,
@@ -615,10 +662,16 @@ gantt_chart_set_adjustments (PlannerGanttChart *chart,
 	}
 
 	if (priv->hadjustment && (priv->hadjustment != hadj)) {
+		g_signal_handlers_disconnect_by_func (priv->hadjustment,
+						      gantt_chart_adjustment_value_changed,
+						      chart);
 		g_object_unref (priv->hadjustment);
 	}
 
 	if (priv->vadjustment && (priv->vadjustment != vadj)) {
+		g_signal_handlers_disconnect_by_func (priv->vadjustment,
+						      gantt_chart_adjustment_value_changed,
+						      chart);
 		g_object_unref (priv->vadjustment);
 	}
 
@@ -631,6 +684,11 @@ gantt_chart_set_adjustments (PlannerGanttChart *chart,
 						   hadj,
 						   NULL);
 
+		g_signal_connect (priv->hadjustment,
+				  "value-changed",
+				  G_CALLBACK (gantt_chart_adjustment_value_changed),
+				  chart);
+
 		need_adjust = TRUE;
 	}
 
@@ -639,6 +697,11 @@ gantt_chart_set_adjustments (PlannerGanttChart *chart,
 		g_object_ref (priv->vadjustment);
 		gtk_object_sink (GTK_OBJECT (priv->vadjustment));
 
+		g_signal_connect (priv->vadjustment,
+				  "value-changed",
+				  G_CALLBACK (gantt_chart_adjustment_value_changed),
+				  chart);
+
 		need_adjust = TRUE;
 	}
 
@@ -963,9 +1026,12 @@ gantt_chart_reflow_idle (PlannerGanttChart *chart)
 	gdouble                width, height;
 	gdouble                bx1, bx2;
 	GtkAllocation          allocation;
+	gint64                 start;
 
 	priv = chart->priv;
 
+	start = mrp_trace_now ();
+
 	if (priv->height_changed || priv->height == -1) {
 		height = gantt_chart_reflow_do (chart, priv->tree, 0);
 		priv->height = height;
@@ -1019,6 +1085,11 @@ gantt_chart_reflow_idle (PlannerGanttChart *chart)
 	priv->height_changed = FALSE;
 	priv->reflow_idle_id = 0;
 
+	/* Route the arrows after the rows have their final positions. */
+	gantt_chart_layout_arrows (chart);
+
+	mrp_trace_complete ("gantt-reflow", start, NULL);
+
 	return FALSE;
 }
 
@@ -1035,6 +1106,13 @@ planner_gantt_chart_reflow_now (PlannerGanttChart *chart)
 static void
 gantt_chart_reflow (PlannerGanttChart *chart, gboolean height_changed)
 {
+	/* Rows were added, removed, expanded or collapsed, the hit-test index
+	 * must be rebuilt even if we don't reflow right now.
+	 */
+	if (height_changed) {
+		chart->priv->row_index_valid = FALSE;
+	}
+
 	if (! gtk_widget_get_mapped (GTK_WIDGET (chart))) {
 		return;
 	}
@@ -1048,6 +1126,198 @@ gantt_chart_reflow (PlannerGanttChart *chart, gboolean height_changed)
 	chart->priv->reflow_idle_id = g_idle_add ((GSourceFunc) gantt_chart_reflow_idle, chart);
 }
 
+typedef struct {
+	gint     cx1, cy1, cx2, cy2;
+	gdouble  wx1, wy1, wx2, wy2;
+} ArrowLayoutArea;
+
+static gboolean
+gantt_chart_layout_arrow_func (PlannerRelationArrow *arrow,
+			       gpointer              value,
+			       ArrowLayoutArea      *area)
+{
+	GnomeCanvasItem *item;
+	gdouble          x1, y1, x2, y2;
+
+	if (!planner_relation_arrow_get_extents (arrow, &x1, &y1, &x2, &y2)) {
+		/* Hidden, keep it dirty until it's shown again. */
+		return FALSE;
+	}
+
+	item = GNOME_CANVAS_ITEM (arrow);
+
+	/* Skip arrows that are off-screen both where they will end up and
+	 * where they are currently drawn (the bbox is in canvas pixels and
+	 * empty if the arrow was never routed).
+	 */
+	if ((x2 < area->wx1 || x1 > area->wx2 || y2 < area->wy1 || y1 > area->wy2) &&
+	    (item->x2 <= item->x1 ||
+	     item->x2 < area->cx1 || item->x1 > area->cx2 ||
+	     item->y2 < area->cy1 || item->y1 > area->cy2)) {
+		return FALSE;
+	}
+
+	planner_relation_arrow_update (arrow);
+
+	return TRUE;
+}
+
+static void
+gantt_chart_layout_arrows (PlannerGanttChart *chart)
+{
+	PlannerGanttChartPriv *priv;
+	ArrowLayoutArea        area;
+	GtkAllocation          allocation;
+
+	priv = chart->priv;
+
+	if (priv->arrow_layout_idle_id != 0) {
+		g_source_remove (priv->arrow_layout_idle_id);
+		priv->arrow_layout_idle_id = 0;
+	}
+
+	if (g_hash_table_size (priv->dirty_arrows) == 0) {
+		return;
+	}
+
+	allocation = GTK_WIDGET (priv->canvas)->allocation;
+
+	gnome_canvas_get_scroll_offsets (priv->canvas, &area.cx1, &area.cy1);
+	area.cx2 = area.cx1 + allocation.width;
+	area.cy2 = area.cy1 + allocation.height;
+
+	gnome_canvas_c2w (priv->canvas, area.cx1, area.cy1, &area.wx1, &area.wy1);
+	gnome_canvas_c2w (priv->canvas, area.cx2, area.cy2, &area.wx2, &area.wy2);
+
+	g_hash_table_foreach_remove (priv->dirty_arrows,
+				     (GHRFunc) gantt_chart_layout_arrow_func,
+				     &area);
+}
+
+static gboolean
+gantt_chart_arrow_layout_idle (PlannerGanttChart *chart)
+{
+	chart->priv->arrow_layout_idle_id = 0;
+
+	gantt_chart_layout_arrows (chart);
+
+	return FALSE;
+}
+
+static void
+gantt_chart_queue_arrow_layout (PlannerGanttChart *chart)
+{
+	PlannerGanttChartPriv *priv;
+
+	priv = chart->priv;
+
+	/* Arrows are routed when we get mapped. */
+	if (! gtk_widget_get_mapped (GTK_WIDGET (chart))) {
+		return;
+	}
+
+	if (priv->arrow_layout_idle_id != 0) {
+		return;
+	}
+
+	/* Run before the canvas redraws, so that the arrows don't lag one
+	 * frame behind the bars.
+	 */
+	priv->arrow_layout_idle_id = g_idle_add_full (G_PRIORITY_HIGH_IDLE,
+						      (GSourceFunc) gantt_chart_arrow_layout_idle,
+						      chart,
+						      NULL);
+}
+
+/* Marks the arrow as needing to be routed again. All queued arrows are
+ * routed in one pass, so an arrow is only routed once however many times
+ * its rows change before that.
+ */
+void
+planner_gantt_chart_queue_arrow (PlannerGanttChart    *chart,
+				 PlannerRelationArrow *arrow)
+{
+	g_return_if_fail (PLANNER_IS_GANTT_CHART (chart));
+	g_return_if_fail (PLANNER_IS_RELATION_ARROW (arrow));
+
+	g_hash_table_insert (chart->priv->dirty_arrows, arrow, arrow);
+
+	gantt_chart_queue_arrow_layout (chart);
+}
+
+static void
+gantt_chart_row_index_build (TreeNode  *root,
+			     GPtrArray *index)
+{
+	TreeNode *node;
+	guint     i;
+
+	for (i = 0; i < root->num_children; i++) {
+		node = root->children[i];
+
+		g_ptr_array_add (index, node->item);
+
+		if (node->expanded) {
+			gantt_chart_row_index_build (node, index);
+		}
+	}
+}
+
+/* Returns the row whose bar or label is at the world coordinate (x, y), or
+ * NULL. Rows are laid out top to bottom in display order, so we can do a
+ * binary search on their y coordinate instead of letting the canvas ask
+ * every item (including all the relation arrows).
+ */
+PlannerGanttRow *
+planner_gantt_chart_get_row_at (PlannerGanttChart *chart,
+				gdouble            x,
+				gdouble            y)
+{
+	PlannerGanttChartPriv *priv;
+	PlannerGanttRow       *row;
+	gdouble                y1, y2;
+	guint                  lo, hi, mid;
+
+	g_return_val_if_fail (PLANNER_IS_GANTT_CHART (chart), NULL);
+
+	priv = chart->priv;
+
+	if (!priv->row_index_valid) {
+		g_ptr_array_set_size (priv->row_index, 0);
+
+		if (priv->tree != NULL) {
+			gantt_chart_row_index_build (priv->tree, priv->row_index);
+		}
+
+		priv->row_index_valid = TRUE;
+	}
+
+	lo = 0;
+	hi = priv->row_index->len;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		row = g_ptr_array_index (priv->row_index, mid);
+
+		planner_gantt_row_get_geometry (row, NULL, &y1, NULL, &y2);
+
+		if (y < y1) {
+			hi = mid;
+		}
+		else if (y >= y2) {
+			lo = mid + 1;
+		} else {
+			if (planner_gantt_row_hit_test (row, x, y)) {
+				return row;
+			}
+
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
 static TreeNode *
 gantt_chart_insert_task (PlannerGanttChart *chart,
 			 GtkTreePath  *path,
@@ -1274,6 +1544,7 @@ gantt_chart_relation_removed (MrpTask           *task,
 	arrow = g_hash_table_lookup (chart->priv->relation_hash, relation);
 	if (arrow != NULL) {
 		g_hash_table_remove (chart->priv->relation_hash, relation);
+		g_hash_table_remove (chart->priv->dirty_arrows, arrow);
 
 		gtk_object_destroy (GTK_OBJECT (arrow));
 		gantt_chart_reflow (chart, FALSE);
@@ -26,6 +26,8 @@
 #include <gtk/gtk.h>
 #include <libgnomecanvas/gnome-canvas.h>
 #include "planner-task-tree.h"
+#include "planner-gantt-row.h"
+#include "planner-relation-arrow.h"
 
 #define PLANNER_TYPE_GANTT_CHART                (planner_gantt_chart_get_type ())
 #define PLANNER_GANTT_CHART(obj)                (G_TYPE_CHECK_INSTANCE_CAST ((obj), PLANNER_TYPE_GANTT_CHART, PlannerGanttChart))
@@ -81,6 +83,11 @@ void             planner_gantt_chart_status_updated   (PlannerGanttChart *chart,
 void             planner_gantt_chart_resource_clicked (PlannerGanttChart *chart,
 						       MrpResource       *resource);
 void             planner_gantt_chart_reflow_now       (PlannerGanttChart *chart);
+PlannerGanttRow *planner_gantt_chart_get_row_at       (PlannerGanttChart *chart,
+						       gdouble            x,
+						       gdouble            y);
+void             planner_gantt_chart_queue_arrow      (PlannerGanttChart *chart,
+						       PlannerRelationArrow *arrow);
 
 void
 planner_gantt_chart_set_highlight_critical_tasks      (PlannerGanttChart  *chart,
@@ -55,6 +55,7 @@ struct _PlannerGanttHeaderPriv {
 	gdouble             x2;
 
 	gchar              *date_hint;
+	MrpTimeFormat      *date_hint_format;
 };
 
 /* Properties */
@@ -258,6 +259,8 @@ gantt_header_init (PlannerGanttHeader *header)
 
 	priv->layout = gtk_widget_create_pango_layout (GTK_WIDGET (header),
 						       NULL);
+
+	priv->date_hint_format = mrp_time_format_new (_("%a, %e %b %Y"));
 }
 
 static void
@@ -376,6 +379,7 @@ gantt_header_finalize (GObject *object)
 	g_object_unref (header->priv->layout);
 
 	g_free (header->priv->date_hint);
+	mrp_time_format_free (header->priv->date_hint_format);
 
 	g_free (header->priv);
 
@@ -509,7 +513,7 @@ gantt_header_expose_event (GtkWidget      *widget,
 	mrptime                 t0;
 	mrptime                 t1;
 	mrptime                 t;
-	gchar                  *str;
+	gchar                   str[128];
 	gint                    minor_width;
 	gint                    major_width;
 	GdkGC                  *gc;
@@ -577,13 +581,14 @@ gantt_header_expose_event (GtkWidget      *widget,
 			       x, 0,
 			       x, height / 2);
 
-		str = planner_scale_format_time (t,
-					    priv->major_unit,
-					    priv->major_format);
+		planner_scale_format_time_buf (t,
+					       priv->major_unit,
+					       priv->major_format,
+					       str,
+					       sizeof (str));
 		pango_layout_set_text (priv->layout,
 				       str,
 				       -1);
-		g_free (str);
 
 		rect.x = x;
 		rect.width = major_width;
@@ -616,13 +621,14 @@ gantt_header_expose_event (GtkWidget      *widget,
 			       x, height / 2,
 			       x, height);
 
-		str = planner_scale_format_time (t,
-					    priv->minor_unit,
-					    priv->minor_format);
+		planner_scale_format_time_buf (t,
+					       priv->minor_unit,
+					       priv->minor_format,
+					       str,
+					       sizeof (str));
 		pango_layout_set_text (priv->layout,
 				       str,
 				       -1);
-		g_free (str);
 
 		rect.x = x;
 		rect.width = minor_width;
@@ -650,21 +656,20 @@ gantt_header_motion_notify_event (GtkWidget	 *widget,
 	PlannerGanttHeader     *header;
 	PlannerGanttHeaderPriv *priv;
 	mrptime                 t;
-	char                   *str;
+	gchar                   str[128];
 
 	header = PLANNER_GANTT_HEADER (widget);
 	priv = header->priv;
 
 	t = floor ((priv->x1 + event->x) / priv->hscale + 0.5);
-	str = mrp_time_format (_("%a, %e %b %Y"), t);
+	mrp_time_format_render (priv->date_hint_format, t, str, sizeof (str));
 
+	/* Only allocate when the hint actually changes. */
 	if (!priv->date_hint || strcmp (str, priv->date_hint) != 0) {
-		g_signal_emit (widget, signals[DATE_HINT_CHANGED], 0, str);
-
 		g_free (priv->date_hint);
-		priv->date_hint = str;
-	} else {
-		g_free (str);
+		priv->date_hint = g_strdup (str);
+
+		g_signal_emit (widget, signals[DATE_HINT_CHANGED], 0, priv->date_hint);
 	}
 
 	return FALSE;
@@ -42,19 +42,29 @@ struct _PlannerGanttModelPriv {
 	GHashTable *task2node;
 	GNode      *tree;
 
-	GHashTable *task2cache;
-	gint        wbs_stamp;
+	/* Parent node -> SiblingIndex, built on demand. */
+	GHashTable *node2siblings;
+
+	/* Node -> position among its siblings, see SiblingIndex. */
+	GHashTable *node2pos;
+
+	/* While frozen, changed tasks are collected here and their rows
+	 * are only signalled once, when the model is thawed.
+	 */
+	gint        freeze_count;
+	GHashTable *changed_tasks;
 };
 
+/* The children of a node in an array, so that we can get the nth child and
+ * the position of a child without walking the sibling list, which is slow
+ * for projects with many tasks on one level. Positions are stored in
+ * node2pos and renumbered lazily: the ones for children before n_valid are
+ * correct, the rest are updated the next time one of them is asked for.
+ */
 typedef struct {
-	gchar *wbs;
-	gint   wbs_stamp;
-
-	gchar *start;
-	gchar *finish;
-	gchar *duration;
-	gchar *work;
-} ValueCache;
+	GPtrArray *children;
+	guint      n_valid;
+} SiblingIndex;
 
 
 static void         gantt_model_init                 (PlannerGanttModel      *model);
@@ -73,14 +83,7 @@ static void         gantt_model_task_prop_changed_cb (MrpTask                *ta
 static GtkTreePath *gantt_model_get_path_from_node   (PlannerGanttModel      *model,
 						      GNode                  *node);
 gchar *             get_wbs_from_task                (MrpTask                *task);
-static const gchar *value_cache_get_wbs              (PlannerGanttModel      *model,
-						      MrpTask                *task);
-static ValueCache * value_cache_get                  (PlannerGanttModel      *model,
-						      MrpTask                *task);
-static void         value_cache_clear                (PlannerGanttModel      *model,
-						      MrpTask                *task);
-static void         value_cache_clear_cache_wbs      (PlannerGanttModel      *model);
-static void         value_cache_free                 (ValueCache             *cache);
+static void         sibling_index_free               (SiblingIndex           *index);
 
 
 static GObjectClass *parent_class;
@@ -138,6 +141,198 @@ gantt_model_connect_to_task_signals (PlannerGanttModel *model, MrpTask *task)
 				 0);
 }
 
+static void
+sibling_index_free (SiblingIndex *index)
+{
+	g_ptr_array_free (index->children, TRUE);
+	g_free (index);
+}
+
+static SiblingIndex *
+gantt_model_get_sibling_index (PlannerGanttModel *model,
+			       GNode             *parent)
+{
+	SiblingIndex *index;
+	GNode        *child;
+
+	index = g_hash_table_lookup (model->priv->node2siblings, parent);
+	if (index) {
+		return index;
+	}
+
+	index = g_new0 (SiblingIndex, 1);
+	index->children = g_ptr_array_new ();
+
+	for (child = g_node_first_child (parent); child; child = g_node_next_sibling (child)) {
+		g_hash_table_insert (model->priv->node2pos,
+				     child,
+				     GINT_TO_POINTER (index->children->len));
+		g_ptr_array_add (index->children, child);
+	}
+
+	index->n_valid = index->children->len;
+
+	g_hash_table_insert (model->priv->node2siblings, parent, index);
+
+	return index;
+}
+
+static gint
+gantt_model_node_get_position (PlannerGanttModel *model,
+			       GNode             *node)
+{
+	SiblingIndex *index;
+	guint         i;
+
+	index = gantt_model_get_sibling_index (model, node->parent);
+
+	if (index->n_valid < index->children->len) {
+		for (i = index->n_valid; i < index->children->len; i++) {
+			g_hash_table_insert (model->priv->node2pos,
+					     g_ptr_array_index (index->children, i),
+					     GUINT_TO_POINTER (i));
+		}
+
+		index->n_valid = index->children->len;
+	}
+
+	return GPOINTER_TO_INT (g_hash_table_lookup (model->priv->node2pos, node));
+}
+
+static GNode *
+gantt_model_node_nth_child (PlannerGanttModel *model,
+			    GNode             *parent,
+			    gint               n)
+{
+	SiblingIndex *index;
+
+	index = gantt_model_get_sibling_index (model, parent);
+
+	if (n < 0 || (guint) n >= index->children->len) {
+		return NULL;
+	}
+
+	return g_ptr_array_index (index->children, n);
+}
+
+static guint
+gantt_model_node_n_children (PlannerGanttModel *model,
+			     GNode             *parent)
+{
+	SiblingIndex *index;
+
+	index = gantt_model_get_sibling_index (model, parent);
+
+	return index->children->len;
+}
+
+static void
+gantt_model_node_insert (PlannerGanttModel *model,
+			 GNode             *parent,
+			 gint               pos,
+			 GNode             *node)
+{
+	SiblingIndex  *index;
+	GPtrArray     *children;
+	GNode         *sibling;
+
+	index = gantt_model_get_sibling_index (model, parent);
+	children = index->children;
+
+	if (pos < 0 || (guint) pos > children->len) {
+		pos = children->len;
+	}
+
+	/* Link the node next to its new sibling, without walking the list. */
+	if ((guint) pos < children->len) {
+		sibling = g_ptr_array_index (children, pos);
+		g_node_insert_before (parent, sibling, node);
+	} else if (pos > 0) {
+		sibling = g_ptr_array_index (children, pos - 1);
+		g_node_insert_after (parent, sibling, node);
+	} else {
+		g_node_prepend (parent, node);
+	}
+
+	g_ptr_array_add (children, NULL);
+	g_memmove (&children->pdata[pos + 1],
+		   &children->pdata[pos],
+		   (children->len - pos - 1) * sizeof (gpointer));
+	children->pdata[pos] = node;
+
+	g_hash_table_insert (model->priv->node2pos, node, GINT_TO_POINTER (pos));
+
+	/* Everything after the new node has moved one step. */
+	index->n_valid = MIN (index->n_valid, (guint) pos);
+	if (index->n_valid == (guint) pos) {
+		index->n_valid++;
+	}
+}
+
+static void
+gantt_model_node_unlink (PlannerGanttModel *model,
+			 GNode             *node)
+{
+	SiblingIndex *index;
+	gint          pos;
+
+	if (node->parent == NULL) {
+		return;
+	}
+
+	pos = gantt_model_node_get_position (model, node);
+
+	index = gantt_model_get_sibling_index (model, node->parent);
+	g_ptr_array_remove_index (index->children, pos);
+	index->n_valid = MIN (index->n_valid, (guint) pos);
+
+	g_hash_table_remove (model->priv->node2pos, node);
+
+	g_node_unlink (node);
+}
+
+/* Appends the WBS code of the node, like "1.3.2". The numbers come straight
+ * from the sibling indices, so after a structural change only the siblings
+ * following the changed position get renumbered, and nothing is stored per
+ * task.
+ */
+static void
+gantt_model_append_wbs (PlannerGanttModel *model,
+			GNode             *node,
+			GString           *wbs)
+{
+	if (node->parent != model->priv->tree) {
+		gantt_model_append_wbs (model, node->parent, wbs);
+		g_string_append_c (wbs, '.');
+	}
+
+	g_string_append_printf (wbs, "%d",
+				gantt_model_node_get_position (model, node) + 1);
+}
+
+/* Returns the position the task should have in its parent's node, using
+ * the position of the previous sibling which is already in the tree.
+ */
+static gint
+gantt_model_get_task_position (PlannerGanttModel *model,
+			       MrpTask           *task)
+{
+	MrpTask *sibling;
+	GNode   *node;
+
+	sibling = mrp_task_get_prev_sibling (task);
+	if (!sibling) {
+		return 0;
+	}
+
+	node = g_hash_table_lookup (model->priv->task2node, sibling);
+	if (!node || !node->parent) {
+		return mrp_task_get_position (task);
+	}
+
+	return gantt_model_node_get_position (model, node) + 1;
+}
+
 static void
 gantt_model_task_inserted_cb (MrpProject        *project,
 			      MrpTask           *task,
@@ -152,20 +347,18 @@ gantt_model_task_inserted_cb (MrpProject        *project,
 	gint         pos;
 	gboolean     has_child_toggled;
 
-	value_cache_clear_cache_wbs (model);
-
 	node = g_node_new (task);
 
 	g_hash_table_insert (model->priv->task2node, task, node);
 
 	parent = mrp_task_get_parent (task);
-	pos = mrp_task_get_position (task);
+	pos = gantt_model_get_task_position (model, task);
 
 	parent_node = g_hash_table_lookup (model->priv->task2node, parent);
 
-	has_child_toggled = (g_node_n_children (parent_node) == 0);
+	has_child_toggled = (gantt_model_node_n_children (model, parent_node) == 0);
 
-	g_node_insert (parent_node, pos, node);
+	gantt_model_node_insert (model, parent_node, pos, node);
 
 	if (has_child_toggled && parent_node->parent != NULL) {
 		parent_path = gantt_model_get_path_from_node (model, parent_node);
@@ -207,6 +400,8 @@ traverse_remove_subtree (GNode             *node,
 					      model);
 
 	g_hash_table_remove (model->priv->task2node, node->data);
+	g_hash_table_remove (model->priv->node2siblings, node);
+	g_hash_table_remove (model->priv->node2pos, node);
 
 	return FALSE;
 }
@@ -215,7 +410,7 @@ static void
 gantt_model_remove_subtree (PlannerGanttModel *model,
 			    GNode             *node)
 {
-	g_node_unlink (node);
+	gantt_model_node_unlink (model, node);
 
 	g_node_traverse (node,
 			 G_POST_ORDER,
@@ -249,8 +444,6 @@ gantt_model_task_removed_cb (MrpProject        *project,
 		return;
 	}
 
-	value_cache_clear_cache_wbs (model);
-
 	g_signal_handlers_disconnect_by_func (task,
 					      gantt_model_task_notify_cb,
 					      model);
@@ -263,7 +456,7 @@ gantt_model_task_removed_cb (MrpProject        *project,
 	path = gantt_model_get_path_from_node (model, node);
 	gtk_tree_model_get_iter (GTK_TREE_MODEL (model), &iter, path);
 
-	has_child_toggled = (g_node_n_children (parent_node) == 1);
+	has_child_toggled = (gantt_model_node_n_children (model, parent_node) == 1);
 
 	gantt_model_remove_subtree (model, node);
 
@@ -312,10 +505,10 @@ gantt_model_reattach_subtasks (GtkTreeModel *tree_model,
 	child = mrp_task_get_first_child (task);
 	while (child) {
 		node = g_hash_table_lookup (priv->task2node, child);
-		pos = mrp_task_get_position (child);
-		g_node_insert (parent_node, pos, node);
+		pos = gantt_model_get_task_position (model, child);
+		gantt_model_node_insert (model, parent_node, pos, node);
 
-		has_child_toggled = (g_node_n_children (parent_node) == 1);
+		has_child_toggled = (gantt_model_node_n_children (model, parent_node) == 1);
 
 		/* Emit has_child_toggled if necessary. */
 		if (has_child_toggled) {
@@ -342,15 +535,17 @@ gantt_model_reattach_subtasks (GtkTreeModel *tree_model,
 }
 
 static gboolean
-gantt_model_unlink_subtree_cb (GNode *node, gpointer data)
+gantt_model_unlink_subtree_cb (GNode             *node,
+			       PlannerGanttModel *model)
 {
-	g_node_unlink (node);
+	gantt_model_node_unlink (model, node);
 
 	return FALSE;
 }
 
 static void
-gantt_model_unlink_subtree_recursively (GNode *node)
+gantt_model_unlink_subtree_recursively (PlannerGanttModel *model,
+					GNode             *node)
 {
 	/* Remove the tasks one by one using post order so we don't mess with
 	 * the tree while traversing it.
@@ -360,7 +555,7 @@ gantt_model_unlink_subtree_recursively (GNode *node)
 			 G_TRAVERSE_ALL,
 			 -1,
 			 (GNodeTraverseFunc) gantt_model_unlink_subtree_cb,
-			 NULL);
+			 model);
 }
 
 static void
@@ -377,8 +572,6 @@ gantt_model_task_moved_cb (MrpProject        *project,
 	gint         pos;
 	gboolean     has_child_toggled;
 
-	value_cache_clear_cache_wbs (model);
-
 	path = planner_gantt_model_get_path_from_task (model, task);
 	gtk_tree_model_get_iter (GTK_TREE_MODEL (model), &iter, path);
 
@@ -389,10 +582,10 @@ gantt_model_task_moved_cb (MrpProject        *project,
 	node = g_hash_table_lookup (model->priv->task2node, task);
 
 	parent_node = node->parent;
-	has_child_toggled = (g_node_n_children (parent_node) == 1);
+	has_child_toggled = (gantt_model_node_n_children (model, parent_node) == 1);
 
 	/* Unlink the subtree from the original position in the tree. */
-	gantt_model_unlink_subtree_recursively (node);
+	gantt_model_unlink_subtree_recursively (model, node);
 
 	/* Emit has_child_toggled if necessary. */
 	if (has_child_toggled) {
@@ -409,10 +602,10 @@ gantt_model_task_moved_cb (MrpProject        *project,
 	parent_node = g_hash_table_lookup (model->priv->task2node, parent);
 
 	/* Re-insert the task at the new position. */
-	pos = mrp_task_get_position (task);
-	g_node_insert (parent_node, pos, node);
+	pos = gantt_model_get_task_position (model, task);
+	gantt_model_node_insert (model, parent_node, pos, node);
 
-	has_child_toggled = (g_node_n_children (parent_node) == 1);
+	has_child_toggled = (gantt_model_node_n_children (model, parent_node) == 1);
 
 	/* Emit has_child_toggled if necessary. */
 	if (has_child_toggled) {
@@ -437,23 +630,20 @@ gantt_model_task_moved_cb (MrpProject        *project,
 }
 
 static void
-gantt_model_task_notify_cb (MrpTask           *task,
-			    GParamSpec        *pspec,
-			    PlannerGanttModel *model)
+gantt_model_task_changed (PlannerGanttModel *model,
+			  MrpTask           *task)
 {
 	GtkTreeModel *tree_model;
 	GtkTreePath  *path;
 	GtkTreeIter   iter;
 
-	tree_model = GTK_TREE_MODEL (model);
-
-	if (strcmp (pspec->name, "start") == 0 ||
-	    strcmp (pspec->name, "finish") == 0 ||
-	    strcmp (pspec->name, "duration") == 0 ||
-	    strcmp (pspec->name, "work") == 0) {
-		value_cache_clear (model, task);
+	if (model->priv->freeze_count > 0) {
+		g_hash_table_insert (model->priv->changed_tasks, task, task);
+		return;
 	}
 
+	tree_model = GTK_TREE_MODEL (model);
+
 	path = planner_gantt_model_get_path_from_task (model, task);
 	gtk_tree_model_get_iter (tree_model, &iter, path);
 	gtk_tree_model_row_changed (tree_model, path, &iter);
@@ -461,23 +651,21 @@ gantt_model_task_notify_cb (MrpTask           *task,
 	gtk_tree_path_free (path);
 }
 
+static void
+gantt_model_task_notify_cb (MrpTask           *task,
+			    GParamSpec        *pspec,
+			    PlannerGanttModel *model)
+{
+	gantt_model_task_changed (model, task);
+}
+
 static void
 gantt_model_task_prop_changed_cb (MrpTask           *task,
 				  MrpProperty       *property,
 				  GValue            *value,
 				  PlannerGanttModel *model)
 {
-	GtkTreeModel *tree_model;
-	GtkTreePath  *path;
-	GtkTreeIter   iter;
-
-	tree_model = GTK_TREE_MODEL (model);
-
-	path = planner_gantt_model_get_path_from_task (model, task);
-	gtk_tree_model_get_iter (tree_model, &iter, path);
-	gtk_tree_model_row_changed (tree_model, path, &iter);
-
-	gtk_tree_path_free (path);
+	gantt_model_task_changed (model, task);
 }
 
 static gboolean
@@ -578,7 +766,9 @@ gantt_model_finalize (GObject *object)
 
 	g_node_destroy (model->priv->tree);
 	g_hash_table_destroy (model->priv->task2node);
-	g_hash_table_destroy (model->priv->task2cache);
+	g_hash_table_destroy (model->priv->node2siblings);
+	g_hash_table_destroy (model->priv->node2pos);
+	g_hash_table_destroy (model->priv->changed_tasks);
 
 	g_free (model->priv);
 	model->priv = NULL;
@@ -698,54 +888,32 @@ gantt_model_get_path_from_node (PlannerGanttModel *model,
 				GNode             *node)
 {
 	GtkTreePath *path;
-	GNode       *parent;
-	GNode       *child;
-	gint         i = 0;
+	GNode       *root;
 
 	g_return_val_if_fail (PLANNER_IS_GANTT_MODEL (model), NULL);
 	g_return_val_if_fail (node != NULL, NULL);
 
-	parent = node->parent;
+	root = model->priv->tree;
 
-	if (parent == NULL && node == model->priv->tree) {
+	if (node == root) {
 		return gtk_tree_path_new_first ();
 	}
 
-	g_assert (parent != NULL);
-
-	if (parent == model->priv->tree) {
-		path = gtk_tree_path_new ();
-		child = g_node_first_child (model->priv->tree);
-	} else {
-		path = gantt_model_get_path_from_node (model, parent);
-		child = g_node_first_child (parent);
-	}
+	path = gtk_tree_path_new ();
 
-	if (path == NULL) {
-		return NULL;
-	}
-
-	if (child == NULL) {
-		gtk_tree_path_free (path);
-		return NULL;
-	}
-
-	for (; child; child = g_node_next_sibling (child)) {
-		if (child == node) {
-			break;
+	for (; node != root; node = node->parent) {
+		if (node->parent == NULL) {
+			/* We couldn't reach the root, meaning it's prolly not
+			 * ours.
+			 */
+			gtk_tree_path_free (path);
+			return NULL;
 		}
-		i++;
-	}
 
-	if (child == NULL) {
-		/* We couldn't find node, meaning it's prolly not ours */
-		/* Perhaps I should do a g_return_if_fail here. */
-		gtk_tree_path_free (path);
-		return NULL;
+		gtk_tree_path_prepend_index (path,
+					     gantt_model_node_get_position (model, node));
 	}
 
-	gtk_tree_path_append_index (path, i);
-
 	return path;
 }
 
@@ -790,11 +958,8 @@ gantt_model_get_value (GtkTreeModel *tree_model,
 {
 	GNode       *node;
 	MrpTask     *task;
-	MrpProject  *project;
-	mrptime      t1, t2;
-	gint         duration;
 	const gchar *name;
-	const gchar *cached_str;
+	GString     *wbs;
 
 	g_return_if_fail (iter != NULL);
 
@@ -803,11 +968,13 @@ gantt_model_get_value (GtkTreeModel *tree_model,
 
 	switch (column) {
 	case COL_WBS:
-		cached_str = value_cache_get_wbs (PLANNER_GANTT_MODEL (tree_model),
-						  task);
+		wbs = g_string_sized_new (24);
+		gantt_model_append_wbs (PLANNER_GANTT_MODEL (tree_model),
+					node,
+					wbs);
 
 		g_value_init (value, G_TYPE_STRING);
-		g_value_set_string (value, cached_str);
+		g_value_take_string (value, g_string_free (wbs, FALSE));
 		break;
 
 	case COL_NAME:
@@ -841,27 +1008,13 @@ gantt_model_get_value (GtkTreeModel *tree_model,
 		break;
 
 	case COL_SLACK:
-		t1 = mrp_task_get_finish (task);
-		t2 = mrp_task_get_latest_finish (task);
-		project = mrp_object_get_project (MRP_OBJECT (task));
-
-		/* We don't support negative slack */
-		if (t2 >= t1) {
-			/* use summary duration calc since we want to use
-			 * the project calendar and ignore resource assignments */
-			duration = mrp_project_calculate_summary_duration (
-				project, task, t1, t2);
-		} else {
-			duration = 0;
-		}
-
 		g_value_init (value, G_TYPE_INT);
-		g_value_set_int (value, duration);
+		g_value_set_int (value, mrp_task_get_total_slack (task));
 		break;
 
 	case COL_WEIGHT:
 		g_value_init (value, G_TYPE_INT);
-		if (g_node_n_children (node) > 0) {
+		if (g_node_first_child (node) != NULL) {
 			g_value_set_int (value, PANGO_WEIGHT_BOLD);
 		} else {
 			g_value_set_int (value, PANGO_WEIGHT_NORMAL);
@@ -870,7 +1023,7 @@ gantt_model_get_value (GtkTreeModel *tree_model,
 
 	case COL_EDITABLE:
 		g_value_init (value, G_TYPE_BOOLEAN);
-		if (g_node_n_children (node) > 0) {
+		if (g_node_first_child (node) != NULL) {
 			g_value_set_boolean (value, FALSE);
 		} else {
 			g_value_set_boolean (value, TRUE);
@@ -955,7 +1108,7 @@ gantt_model_iter_has_child (GtkTreeModel *tree_model,
 
 	node = iter->user_data;
 
-	return (g_node_n_children (node) > 0);
+	return (g_node_first_child (node) != NULL);
 }
 
 static gint
@@ -970,7 +1123,7 @@ gantt_model_iter_n_children (GtkTreeModel *tree_model,
 		node = PLANNER_GANTT_MODEL (tree_model)->priv->tree;
 	}
 
-	return g_node_n_children (node);
+	return gantt_model_node_n_children (PLANNER_GANTT_MODEL (tree_model), node);
 }
 
 static gboolean
@@ -993,7 +1146,7 @@ gantt_model_iter_nth_child (GtkTreeModel *tree_model,
 		parent = parent_iter->user_data;
 	}
 
-	child = g_node_nth_child (parent, n);
+	child = gantt_model_node_nth_child (model, parent, n);
 
 	if (child) {
 		iter->user_data = child;
@@ -1053,15 +1206,65 @@ gantt_model_init (PlannerGanttModel *model)
 	model->priv = priv;
 
 	priv->task2node = g_hash_table_new (NULL, NULL);
-	priv->task2cache = g_hash_table_new_full (NULL, NULL,
-						  NULL,
-						  (GDestroyNotify) value_cache_free);
+	priv->node2siblings = g_hash_table_new_full (NULL, NULL,
+						     NULL,
+						     (GDestroyNotify) sibling_index_free);
+	priv->node2pos = g_hash_table_new (NULL, NULL);
+	priv->changed_tasks = g_hash_table_new (NULL, NULL);
 
 	do {
 		model->stamp = g_random_int ();
 	} while (model->stamp == 0);
 }
 
+/* Holds back the row changes caused by changes to tasks until the model is
+ * thawed, so that a task changed many times is only signalled once. Rows
+ * are still inserted and removed right away. Calls can be nested.
+ */
+void
+planner_gantt_model_freeze (PlannerGanttModel *model)
+{
+	g_return_if_fail (PLANNER_IS_GANTT_MODEL (model));
+
+	model->priv->freeze_count++;
+}
+
+static gboolean
+gantt_model_thaw_task_func (MrpTask           *task,
+			    gpointer           value,
+			    PlannerGanttModel *model)
+{
+	/* Skip tasks that were removed while frozen. */
+	if (g_hash_table_lookup (model->priv->task2node, task)) {
+		gantt_model_task_changed (model, task);
+	}
+
+	return TRUE;
+}
+
+/* When the last freeze is undone, each task that changed in the meantime
+ * gets one row change.
+ */
+void
+planner_gantt_model_thaw (PlannerGanttModel *model)
+{
+	PlannerGanttModelPriv *priv;
+
+	g_return_if_fail (PLANNER_IS_GANTT_MODEL (model));
+
+	priv = model->priv;
+
+	g_return_if_fail (priv->freeze_count > 0);
+
+	if (--priv->freeze_count > 0) {
+		return;
+	}
+
+	g_hash_table_foreach_remove (priv->changed_tasks,
+				     (GHRFunc) gantt_model_thaw_task_func,
+				     model);
+}
+
 MrpProject *
 planner_gantt_model_get_project (PlannerGanttModel *model)
 {
@@ -1156,73 +1359,3 @@ get_wbs_from_task(MrpTask *task)
 	}
         return g_string_free (string, FALSE);
 }
-
-static const gchar *
-value_cache_get_wbs (PlannerGanttModel *model,
-		     MrpTask           *task)
-{
-	ValueCache *cache;
-
-	cache = value_cache_get (model, task);
-	if (!cache->wbs) {
-		goto update_cache;
-	}
-
-	if (cache->wbs_stamp != model->priv->wbs_stamp) {
-		goto update_cache;
-	}
-
-	return cache->wbs;
-
- update_cache:
-	g_free (cache->wbs);
-	cache->wbs = get_wbs_from_task(task);
-	cache->wbs_stamp = model->priv->wbs_stamp;
-
-	return cache->wbs;
-}
-
-static void
-value_cache_free (ValueCache *cache)
-{
-	g_free (cache->wbs);
-	g_free (cache->start);
-	g_free (cache->finish);
-	g_free (cache->duration);
-	g_free (cache->work);
-
-	g_free (cache);
-}
-
-static ValueCache *
-value_cache_get (PlannerGanttModel *model,
-		 MrpTask           *task)
-{
-	ValueCache *cache;
-
-	cache = g_hash_table_lookup (model->priv->task2cache, task);
-	if (!cache) {
-		cache = g_new0 (ValueCache, 1);
-		g_hash_table_insert (model->priv->task2cache,
-				     task,
-				     cache);
-	}
-
-	return cache;
-}
-
-static void
-value_cache_clear (PlannerGanttModel *model,
-		   MrpTask           *task)
-{
-	g_hash_table_remove (model->priv->task2cache, task);
-}
-
-static void
-value_cache_clear_cache_wbs (PlannerGanttModel *model)
-{
-	model->priv->wbs_stamp++;
-}
-
-
-
@@ -75,6 +75,8 @@ MrpTask      *     planner_gantt_model_get_task               (PlannerGanttModel
 							       GtkTreeIter       *iter);
 MrpTask           *planner_gantt_model_get_task_from_path     (PlannerGanttModel *model,
 							       GtkTreePath       *path);
+void               planner_gantt_model_freeze                 (PlannerGanttModel *model);
+void               planner_gantt_model_thaw                   (PlannerGanttModel *model);
 
 
 #endif /* __PLANNER_GANTT_MODEL_H__ */
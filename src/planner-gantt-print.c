@@ -35,16 +35,12 @@
 #include "planner-scale-utils.h"
 
 #define d(x)
-#define GET_PAGE(d,r,c) (&d->pages[r*d->cols_of_pages+c])
 #define INDENT_FACTOR 4
 
+/* The elements of one page. Pages are laid out just before they are
+ * printed and freed right after, so only one exists at a time.
+ */
 typedef struct {
-	mrptime  first_time;
-	mrptime  last_time;
-
-	gdouble  gantt_x0;
-	gdouble  gantt_y0;
-
 	GList   *elements;
 	GList   *background_elements;
 } Page;
@@ -94,7 +90,13 @@ struct _PlannerGanttPrintData {
 	PangoFontDescription         *font;
 	PangoFontDescription         *font_bold;
 
-	GList             *tasks;
+	/* The visible tasks, PrintTask. */
+	GPtrArray         *tasks;
+
+	/* Relations where both tasks are visible, one array per row of
+	 * pages with the relations that pass through it.
+	 */
+	GPtrArray        **relations_by_row;
 
 	gdouble            f;
 
@@ -116,7 +118,7 @@ struct _PlannerGanttPrintData {
 
 	mrptime            second_column_start;
 
-	Page              *pages;
+	mrptime            current_time;
 };
 
 typedef struct {
@@ -203,33 +205,49 @@ print_table_header (PlannerGanttPrintData *data)
 	planner_print_job_set_font_regular (data->job);
 }
 
+/* The index of the first task on a row of pages. */
+static gint
+gantt_print_get_first_task (PlannerGanttPrintData *data, gint row)
+{
+	if (row == 0) {
+		return 0;
+	}
+
+	return data->tasks_per_page_with_header +
+		data->tasks_per_page_without_header * (row - 1);
+}
+
+static gint
+gantt_print_get_n_tasks (PlannerGanttPrintData *data, gint row)
+{
+	gint n;
+
+	if (row == 0) {
+		n = data->tasks_per_page_with_header;
+	} else {
+		n = data->tasks_per_page_without_header;
+	}
+
+	return MIN (n, (gint) data->tasks->len - gantt_print_get_first_task (data, row));
+}
+
 static void
 print_table_tasks (PlannerGanttPrintData *data,
-		   gboolean               header,
-		   GList                 *tasks,
-		   gint                   first)
+		   gint                   row)
 {
 	gchar     *str;
 	gint       work;
 	gdouble    x, y;
-	GList     *l, *to;
 	PrintTask *ptask;
-	gint       last, i;
+	gint       first, n, i;
 
-	if (header) {
-		last = first + data->tasks_per_page_with_header;
-	} else {
-		last = first + data->tasks_per_page_without_header;
-	}
-
-	l = g_list_nth (tasks, first);
-	to = g_list_nth (tasks, last);
-	i = 1;
+	first = gantt_print_get_first_task (data, row);
+	n = gantt_print_get_n_tasks (data, row);
 
 	cairo_set_line_width (data->job->cr, THIN_LINE_WIDTH);
 
-	while (l && l != to) {
-		ptask = l->data;
+	for (i = 0; i < n; i++) {
+		ptask = g_ptr_array_index (data->tasks, first + i);
 
 		g_object_get (ptask->task,
 			      "name", &str,
@@ -243,9 +261,9 @@ print_table_tasks (PlannerGanttPrintData *data,
 		}
 
 		x = data->name_x1 + data->job->x_pad + ptask->depth * INDENT_FACTOR * data->job->x_pad;
-		y = i * data->row_height;
+		y = (i + 1) * data->row_height;
 
-		if (header) {
+		if (row == 0) {
 			y += data->header_height;
 		}
 
@@ -270,9 +288,6 @@ print_table_tasks (PlannerGanttPrintData *data,
 		planner_print_job_moveto (data->job, 0, y);
 		planner_print_job_lineto (data->job, data->tree_x2, y);
 		cairo_stroke (data->job->cr);
-
-		i++;
-		l = l->next;
 	}
 
 	cairo_set_line_width (data->job->cr, 1);
@@ -289,7 +304,7 @@ print_time_header (PlannerGanttPrintData *data,
 	gdouble  y1, y2, y3;
 	gdouble  width;
 	mrptime  t;
-	gchar   *str;
+	gchar    str[128];
 
 	y1 = 0;
 	y2 = data->header_height / 2;
@@ -324,15 +339,14 @@ print_time_header (PlannerGanttPrintData *data,
 				cairo_stroke (data->job->cr);
 			}
 
-			str = planner_scale_format_time (t, data->major_unit, data->major_format);
+			planner_scale_format_time_buf (t, data->major_unit, data->major_format,
+						       str, sizeof (str));
 
 			planner_print_job_show_clipped (data->job,
 							x + data->job->x_pad, y,
 							str,
 							MAX (x, x1), y1,
 							x + width, y2);
-
-			g_free (str);
 		}
 
 		t = mrp_time_align_next (t, data->major_unit);
@@ -355,15 +369,14 @@ print_time_header (PlannerGanttPrintData *data,
 				cairo_stroke (data->job->cr);
 			}
 
-			str = planner_scale_format_time (t, data->minor_unit, data->minor_format);
+			planner_scale_format_time_buf (t, data->minor_unit, data->minor_format,
+						       str, sizeof (str));
 
 			planner_print_job_show_clipped (data->job,
 							x + data->job->x_pad, y,
 							str,
 							MAX (x, x1), y2,
 							x + width, y3);
-
-			g_free (str);
 		}
 
 		t = mrp_time_align_next (t, data->minor_unit);
@@ -372,7 +385,7 @@ print_time_header (PlannerGanttPrintData *data,
 
 typedef struct {
 	GtkTreeView *tree_view;
-	GList       *list;
+	GPtrArray   *tasks;
 } ForeachVisibleData;
 
 static gboolean
@@ -400,14 +413,14 @@ foreach_visible_task (GtkTreeModel *model,
 		ptask->task = task;
 		ptask->depth = gtk_tree_path_get_depth (path);
 
-		fvd->list = g_list_prepend (fvd->list, ptask);
+		g_ptr_array_add (fvd->tasks, ptask);
 	}
 	gtk_tree_path_free (parent_path);
 
 	return FALSE;
 }
 
-static GList *
+static GPtrArray *
 gantt_print_get_visible_tasks (PlannerGanttPrintData *data)
 {
 	ForeachVisibleData  fvd;
@@ -415,39 +428,70 @@ gantt_print_get_visible_tasks (PlannerGanttPrintData *data)
 
 	model = gtk_tree_view_get_model (data->tree_view);
 
-	fvd.list = NULL;
+	fvd.tasks = g_ptr_array_new ();
 	fvd.tree_view = data->tree_view;
 
 	gtk_tree_model_foreach (model,
 				foreach_visible_task,
 				&fvd);
 
-	return g_list_reverse (fvd.list);
+	return fvd.tasks;
 }
 
 static void
-gantt_print_free_print_tasks (GList *tasks)
+gantt_print_free_print_tasks (GPtrArray *tasks)
 {
-	GList *l;
+	guint i;
 
-	for (l = tasks; l; l = l->next) {
-		g_free (l->data);
+	for (i = 0; i < tasks->len; i++) {
+		g_free (g_ptr_array_index (tasks, i));
 	}
+
+	g_ptr_array_free (tasks, TRUE);
 }
 
-static GList *
+/* Collects the relations between visible tasks into the rows of pages
+ * they pass through, so that laying out a page only looks at the relations
+ * drawn on it. Must be called after the task coordinates are known.
+ */
+static GPtrArray **
 gantt_print_get_relations (PlannerGanttPrintData *data)
 {
-	GList   *tasks, *l;
-	GList   *predecessors, *p;
-	GList  *relations = NULL;
+	GList       *tasks, *l;
+	GList       *predecessors, *p;
+	GPtrArray  **relations;
+	MrpRelation *relation;
+	TaskCoord   *pre_coord, *suc_coord;
+	gint         from_row, to_row;
+	gint         row;
+
+	relations = g_new (GPtrArray *, data->rows_of_pages);
+	for (row = 0; row < data->rows_of_pages; row++) {
+		relations[row] = g_ptr_array_new ();
+	}
 
 	tasks = mrp_project_get_all_tasks (data->project);
 	for (l = tasks; l; l = l->next) {
 		predecessors = mrp_task_get_predecessor_relations (l->data);
 
 		for (p = predecessors; p; p = p->next) {
-			relations = g_list_prepend (relations, p->data);
+			relation = p->data;
+
+			pre_coord = g_hash_table_lookup (data->task_finish_coords,
+							 mrp_relation_get_predecessor (relation));
+			suc_coord = g_hash_table_lookup (data->task_start_coords,
+							 mrp_relation_get_successor (relation));
+			if (!pre_coord || !suc_coord) {
+				continue;
+			}
+
+			from_row = MAX (0, MIN (pre_coord->row, suc_coord->row));
+			to_row = MIN (data->rows_of_pages - 1,
+				      MAX (pre_coord->row, suc_coord->row));
+
+			for (row = from_row; row <= to_row; row++) {
+				g_ptr_array_add (relations[row], relation);
+			}
 		}
 	}
 
@@ -584,6 +628,513 @@ gantt_print_get_allocated_resources_string (PlannerGanttPrintData  *data,
 	return text != NULL;
 }
 
+static void
+gantt_print_add_coord (GHashTable *coords,
+		       MrpTask    *task,
+		       gint        row,
+		       gint        col,
+		       gdouble     x,
+		       gdouble     y)
+{
+	TaskCoord *task_coord;
+
+	task_coord = g_new0 (TaskCoord, 1);
+	task_coord->row = row;
+	task_coord->col = col;
+	task_coord->x = x;
+	task_coord->y = y;
+
+	g_hash_table_insert (coords, task, task_coord);
+}
+
+/* Lays out the task at position @i on row @row of pages. Without a @page,
+ * all the columns the task covers are walked and only the start and finish
+ * coordinates of the task are recorded, which the relations need. With a
+ * @page, only column @page_col is looked at and the elements that fall on
+ * it are added to the page.
+ */
+static void
+gantt_print_layout_task (PlannerGanttPrintData *data,
+			 Page                  *page,
+			 gint                   page_col,
+			 PrintTask             *ptask,
+			 gint                   row,
+			 gint                   i)
+{
+	Element      element;
+	TaskCoord   *task_coord;
+	gboolean     found;
+	gdouble      x0, y0;
+	gdouble      y1, y2;
+	mrptime      t1, t2;
+	mrptime      start, finish;
+	mrptime      complete;
+	gboolean     is_summary;
+	gboolean     is_critical;
+	MrpTaskType  type;
+	gchar       *str;
+	gint         col;
+
+	if (row == 0) {
+		/* Top-most row has the header. */
+		y0 = data->header_height;
+	} else {
+		y0 = 0;
+	}
+
+	start = mrp_task_get_work_start (ptask->task);
+	finish = mrp_task_get_finish (ptask->task);
+	complete = start + (finish - start) *
+		mrp_task_get_percent_complete (ptask->task) / 100.0;
+
+	is_summary = mrp_task_get_n_children (ptask->task) > 0;
+	type = mrp_task_get_task_type (ptask->task);
+	is_critical = mrp_task_get_critical (ptask->task);
+
+	if (!is_summary && type == MRP_TASK_TYPE_MILESTONE) {
+		finish = start;
+	}
+
+	if (page && page_col > 0) {
+		/* Every column but the first covers the same time span, so
+		 * go straight to the page's one. Step the same way as the
+		 * loop below so that the edges match.
+		 */
+		col = page_col;
+		t1 = data->second_column_start +
+			(page_col - 1) * (mrptime) (data->job->width * data->f);
+	} else {
+		col = 0;
+		t1 = data->start;
+	}
+
+	y1 = y0 + data->row_height * (i + 0.25);
+	y2 = y1 + 0.5 * data->row_height;
+
+	/* Loop through the columns that this task covers. */
+	while (t1 <= finish) {
+		if (col == 0) {
+			/* Left-most column has the task tree. */
+			x0 = data->tree_x2;
+			t2 = data->second_column_start;
+		} else {
+			x0 = 0;
+			t2 = t1 + (mrptime) (data->job->width * data->f);
+		}
+
+		memset (&element, 0, sizeof (element));
+
+		element.y1 = y1;
+		element.y2 = y2;
+		element.is_critical = is_critical;
+
+		found = TRUE;
+
+		/* Identify the cases: only left-most part on page, only
+		 * right-most part, the whole task, or only the mid-section.
+		 */
+		if (start >= t1 && start <= t2 && finish > t2) {
+			/* Left */
+			if (is_summary) {
+				element.type = SUMMARY_LEFT;
+			}
+			else if (type == MRP_TASK_TYPE_MILESTONE) {
+				element.type = MILESTONE;
+			} else {
+				element.type = TASK_LEFT;
+			}
+
+			element.x1 = x0 + (start - t1) / data->f;
+			element.x2 = data->job->width;
+			element.x_complete = x0 + (complete - t1) / data->f;
+			element.x_complete = MIN (element.x_complete, element.x2);
+		}
+		else if (start < t1 && finish >= t1 && finish <= t2) {
+			/* Right */
+			if (is_summary) {
+				element.type = SUMMARY_RIGHT;
+			}
+			else if (type == MRP_TASK_TYPE_MILESTONE) {
+				element.type = MILESTONE;
+			} else {
+				element.type = TASK_RIGHT;
+			}
+
+			element.x1 = x0;
+			element.x2 = x0 + (finish - t1) / data->f;
+			element.x_complete = x0 + (complete - t1) / data->f;
+			element.x_complete = MIN (element.x_complete, element.x2);
+		}
+		else if (start >= t1 && finish <= t2) {
+			/* Whole */
+			if (is_summary) {
+				element.type = SUMMARY_WHOLE;
+			}
+			else if (type == MRP_TASK_TYPE_MILESTONE) {
+				element.type = MILESTONE;
+			} else {
+				element.type = TASK_WHOLE;
+			}
+
+			element.x1 = x0 + (start - t1) / data->f;
+			element.x2 = x0 + (finish - t1) / data->f;
+			element.x_complete = x0 + (complete - t1) / data->f;
+			element.x_complete = MIN (element.x_complete, element.x2);
+		}
+		else if (start < t1 && finish > t2) {
+			/* Middle */
+			if (is_summary) {
+				element.type = SUMMARY_MIDDLE;
+			}
+			else if (type == MRP_TASK_TYPE_MILESTONE) {
+				element.type = MILESTONE;
+			} else {
+				element.type = TASK_MIDDLE;
+			}
+
+			element.x1 = x0;
+			element.x2 = data->job->width;
+
+			if (complete > t1 && complete <= t2) {
+				element.x_complete = x0 + (complete - t1) / data->f;
+				element.x_complete = MIN (element.x_complete, element.x2);
+			}
+		} else {
+			found = FALSE;
+		}
+
+		if (found && !page) {
+			switch (element.type) {
+			case TASK_WHOLE:
+			case TASK_LEFT:
+			case SUMMARY_WHOLE:
+			case SUMMARY_LEFT:
+			case MILESTONE:
+				gantt_print_add_coord (data->task_start_coords,
+						       ptask->task, row, col,
+						       element.x1,
+						       y1 - (y2 - y1) / 2);
+				break;
+			default:
+				break;
+			}
+
+			switch (element.type) {
+			case TASK_WHOLE:
+			case TASK_RIGHT:
+			case SUMMARY_WHOLE:
+			case SUMMARY_RIGHT:
+			case MILESTONE:
+				gantt_print_add_coord (data->task_finish_coords,
+						       ptask->task, row, col,
+						       element.x2,
+						       y1 + (y2 - y1) / 2);
+				break;
+			default:
+				break;
+			}
+		}
+		else if (found && col == page_col) {
+			page->elements = g_list_prepend (page->elements,
+							 g_memdup (&element, sizeof (element)));
+		}
+
+		t1 = t2;
+		col++;
+
+		if (page) {
+			break;
+		}
+	}
+
+	/* The allocated resources go after the last part of the task, that
+	 * is on the page if the task ends before the next column.
+	 */
+	if (!page || page_col != col - 1 || t1 <= finish) {
+		return;
+	}
+
+	task_coord = g_hash_table_lookup (data->task_finish_coords, ptask->task);
+
+	/* FIXME: Remove this check when the scheduler is fixed. We get a
+	 * crash here if tasks get really odd start/finish values. This
+	 * sometimes happens for complex projects now.
+	 */
+	if (!task_coord) {
+		return;
+	}
+
+	if (gantt_print_get_allocated_resources_string (data, ptask->task, &str, NULL)) {
+		memset (&element, 0, sizeof (element));
+		element.type = RESOURCES;
+
+		element.x1 = task_coord->x + data->job->x_pad;
+		element.y1 = y0 + data->row_height * (i + 0.75);
+
+		element.resources = str;
+
+		page->elements = g_list_prepend (page->elements,
+						 g_memdup (&element, sizeof (element)));
+	}
+}
+
+static void
+gantt_print_layout_relations (PlannerGanttPrintData *data,
+			      Page                  *page,
+			      gint                   page_row,
+			      gint                   page_col)
+{
+	GPtrArray   *relations;
+	MrpRelation *relation;
+	TaskCoord   *pre_coord, *suc_coord;
+	Element     *element;
+	gdouble      top;
+	guint        i;
+
+	if (page_row == 0) {
+		top = data->header_height;
+	} else {
+		top = 0;
+	}
+
+	/* Only the relations that pass through this row of pages. */
+	relations = data->relations_by_row[page_row];
+
+	for (i = 0; i < relations->len; i++) {
+		relation = g_ptr_array_index (relations, i);
+
+		pre_coord = g_hash_table_lookup (data->task_finish_coords,
+						 mrp_relation_get_predecessor (relation));
+		suc_coord = g_hash_table_lookup (data->task_start_coords,
+						 mrp_relation_get_successor (relation));
+
+		/* The arrow, with the right direction and position depending
+		 * on the order of the predecessor and successor.
+		 */
+		if (page_row == suc_coord->row && page_col == suc_coord->col) {
+			element = g_new0 (Element, 1);
+			element->x1 = suc_coord->x;
+
+			if ((pre_coord->row == suc_coord->row && pre_coord->y < suc_coord->y) ||
+			    (pre_coord->row < suc_coord->row)) {
+				element->y1 = suc_coord->y + data->row_height * 0.25;
+				element->type = RELATION_ARROW_DOWN;
+			} else {
+				element->y1 = suc_coord->y + data->row_height * 0.75;
+				element->type = RELATION_ARROW_UP;
+			}
+
+			page->elements = g_list_prepend (page->elements, element);
+		}
+
+		if (page_row == pre_coord->row &&
+		    page_col >= pre_coord->col && page_col <= suc_coord->col) {
+			element = g_new0 (Element, 1);
+			element->type = RELATION_HORIZ;
+
+			if (page_col == pre_coord->col) {
+				element->x1 = pre_coord->x;
+			}
+			else if (page_col == 0) {
+				element->x1 = data->tree_x2;
+			} else {
+				element->x1 = 0;
+			}
+
+			if (page_col == suc_coord->col) {
+				element->x2 = suc_coord->x;
+			} else {
+				element->x2 = data->job->width;
+			}
+
+			element->y1 = pre_coord->y;
+
+			page->elements = g_list_prepend (page->elements, element);
+		}
+
+		if (page_col != suc_coord->col) {
+			continue;
+		}
+
+		element = g_new0 (Element, 1);
+		element->type = RELATION_VERT;
+		element->x1 = suc_coord->x;
+
+		if (page_row == pre_coord->row) {
+			element->y1 = pre_coord->y;
+		}
+		else if (pre_coord->row <= suc_coord->row) {
+			element->y1 = top;
+		} else {
+			element->y1 = data->job->height;
+		}
+
+		if (page_row == suc_coord->row) {
+			element->y2 = suc_coord->y + data->row_height / 2;
+		}
+		else if (pre_coord->row <= suc_coord->row) {
+			element->y2 = data->job->height;
+		} else {
+			element->y2 = top;
+		}
+
+		page->elements = g_list_prepend (page->elements, element);
+	}
+}
+
+/* Adds shading for the non-work intervals and the current time line. */
+static void
+gantt_print_layout_background (PlannerGanttPrintData *data,
+			       Page                  *page,
+			       gint                   row,
+			       gint                   col)
+{
+	MrpCalendar *calendar;
+	MrpDay      *day;
+	GList       *ivals;
+	Element     *element;
+	mrptime      t0, t1, t2;
+	mrptime      ival_start, ival_end, ival_prev;
+	gdouble      x0, y0;
+	gint         c;
+
+	calendar = mrp_project_get_calendar (data->project);
+
+	if (row == 0) {
+		/* Top-most row has the header. */
+		y0 = data->header_height;
+	} else {
+		y0 = 0;
+	}
+
+	/* Step to the column, the rounding must match the task layout. */
+	t0 = mrp_time_align_day (data->start);
+	for (c = 0; ; c++) {
+		if (c == 0) {
+			/* Left-most col has the tree. */
+			x0 = data->tree_x2;
+		} else {
+			x0 = 0;
+		}
+
+		t2 = t0 + (data->job->width - x0) * data->f;
+
+		if (c == col) {
+			break;
+		}
+
+		t0 = t2;
+	}
+
+	/* Loop through the days between t0 and t2. */
+	t1 = mrp_time_align_day (t0);
+
+	while (t1 <= t2) {
+		gboolean done = FALSE;
+
+		day = mrp_calendar_get_day (calendar, t1, TRUE);
+
+		ivals = mrp_calendar_day_get_intervals (calendar, day, TRUE);
+
+		ival_prev = t1;
+
+		/* Loop through the non-work intervals for this day */
+		while (!done) {
+			/* The number of non-work intervals is one for each
+			 * work interval and one more for the remaining period
+			 * after the last work interval.
+			 */
+			if (ivals != NULL) {
+				mrp_interval_get_absolute (ivals->data,
+							   t1,
+							   &ival_start,
+							   &ival_end);
+
+				ivals = ivals->next;
+			} else {
+				ival_start = t1 + 60*60*24;
+				done = TRUE;
+			}
+
+			/* Only consider non-work intervals that are large
+			 * enough and lie (partially) within [t0...t2].
+			 */
+			if (ival_prev < t2 && ival_start > t0 &&
+			    planner_scale_conf[data->level].nonworking_limit <= ival_start - ival_prev) {
+
+				/* Only draw the part within [t0...t2] */
+				element = g_new0 (Element, 1);
+				element->type = SHADE;
+				element->y1 = y0;
+				element->y2 = data->job->height;
+
+				element->x1 = x0 + (MAX(t0, ival_prev) - t0) / data->f;
+				element->x2 = x0 + (MIN(t2, ival_start) - t0) / data->f;
+
+				page->background_elements = g_list_prepend (page->background_elements, element);
+			}
+
+			ival_prev = ival_end;
+		}
+
+		/* Set t1 to the start of the next day */
+		t1 = ival_start;
+	}
+
+	/* Print the current time. */
+	if (data->current_time >= t0 && data->current_time <= t2) {
+		element = g_new0 (Element, 1);
+		element->type = TIMELINE;
+		element->y1 = data->header_height;
+		element->y2 = data->job->height;
+		element->x1 = x0 + (data->current_time - t0) / data->f;
+		element->x2 = element->x1;
+
+		page->background_elements = g_list_prepend (page->background_elements, element);
+	}
+}
+
+static void
+gantt_print_layout_page (PlannerGanttPrintData *data,
+			 Page                  *page,
+			 gint                   row,
+			 gint                   col)
+{
+	gint first, n, i;
+
+	first = gantt_print_get_first_task (data, row);
+	n = gantt_print_get_n_tasks (data, row);
+
+	for (i = 0; i < n; i++) {
+		gantt_print_layout_task (data, page, col,
+					 g_ptr_array_index (data->tasks, first + i),
+					 row, i);
+	}
+
+	gantt_print_layout_relations (data, page, row, col);
+	gantt_print_layout_background (data, page, row, col);
+}
+
+static void
+free_page (Page *page)
+{
+	GList   *l;
+	Element *element;
+
+	for (l = page->elements; l; l = l->next) {
+		element = l->data;
+		g_free (element->resources);
+		g_free (element);
+	}
+
+	for (l = page->background_elements; l; l = l->next) {
+		g_free (l->data);
+	}
+
+	g_list_free (page->elements);
+	g_list_free (page->background_elements);
+}
+
 void
 planner_gantt_print_do (PlannerGanttPrintData *data, gint page_nr)
 {
@@ -591,23 +1142,18 @@ planner_gantt_print_do (PlannerGanttPrintData *data, gint page_nr)
 	gdouble      x1, x2;
 	mrptime      t1, t2;
 	Element     *element;
-	gint         row, col, first_task;
-	Page        *page;
+	gint         row, col;
+	Page         page = { NULL, NULL };
 
-	/* Fourth pass, generate pages. */
+	/* Lay out this page only, and print it. */
 	col = page_nr % data->cols_of_pages;
 	row = page_nr / data->cols_of_pages;
 
 	x2 = data->job->width;
 
-	planner_print_job_begin_next_page (data->job);
+	gantt_print_layout_page (data, &page, row, col);
 
-	if (row == 0) {
-		first_task = 0;
-	} else {
-		first_task = data->tasks_per_page_with_header +
-			     data->tasks_per_page_without_header * (row - 1);
-	}
+	planner_print_job_begin_next_page (data->job);
 
 	if (col == 0) {
 		x1 = data->tree_x2;
@@ -632,18 +1178,14 @@ planner_gantt_print_do (PlannerGanttPrintData *data, gint page_nr)
 					  data->job->height);
 		cairo_stroke (data->job->cr);
 
-		print_table_tasks (data,
-				   row == 0,
-				   data->tasks,
-				   first_task);
+		print_table_tasks (data, row);
 	} else {
 		x1 = 0;
 		t1 = data->second_column_start + (col - 1) * data->job->width * data->f;
 		t2 = t1 + data->job->width * data->f;
 	}
 
-	page = GET_PAGE (data, row, col);
-	for (l = page->background_elements; l; l = l->next) {
+	for (l = page.background_elements; l; l = l->next) {
 		gdouble dashes[] = { 4, 4 };
 
 		element = l->data;
@@ -694,7 +1236,7 @@ planner_gantt_print_do (PlannerGanttPrintData *data, gint page_nr)
 		}
 	}
 
-	for (l = page->elements; l; l = l->next) {
+	for (l = page.elements; l; l = l->next) {
 		element = l->data;
 
 		cairo_set_source_rgb (data->job->cr, 0, 0, 0);
@@ -885,6 +1427,8 @@ planner_gantt_print_do (PlannerGanttPrintData *data, gint page_nr)
 	}
 
 	planner_print_job_finish_page (data->job, TRUE);
+
+	free_page (&page);
 }
 
 PlannerGanttPrintData *
@@ -895,31 +1439,11 @@ planner_gantt_print_data_new (PlannerView     *view,
 			      gboolean         show_critical)
 {
 	PlannerGanttPrintData *data;
-	GList                 *tasks = NULL, *l;
 	gint                   num_tasks;
 	gdouble                max_name_width = 0.0;
 	gdouble                ext;
-	GList       *relations;
-	gdouble      y1, y2;
-	mrptime      t1, t2, t0;
-	mrptime      current_time;
-	mrptime      start, finish;
-	mrptime      complete;
-	gboolean     is_summary;
-	gboolean     is_critical;
-	MrpTaskType  type;
-	PrintTask   *ptask;
-	TaskCoord   *task_coord;
-	Element     *element;
-	gdouble      x0, y0;
-	gint         i, row, col;
-	gint         tasks_on_this_page;
-	gchar       *name;
-	Page        *page;
-	gchar       *str;
-	MrpCalendar *calendar;
-	MrpDay      *day;
-	GList       *ivals;
+	gint                   row, i, n;
+	guint                  index;
 
 	data = g_new0 (PlannerGanttPrintData, 1);
 
@@ -950,21 +1474,19 @@ planner_gantt_print_data_new (PlannerView     *view,
 	/* Start and finish of the project. */
 	data->start = mrp_project_get_project_start (data->project);
 
-	tasks = gantt_print_get_visible_tasks (data);
-	data->tasks = tasks;
-	num_tasks = g_list_length (tasks);
+	data->tasks = gantt_print_get_visible_tasks (data);
+	num_tasks = data->tasks->len;
 
 	data->finish = data->start;
 
 	/* Go through the tasks and get the end time by checking the right-most
 	 * resource label we will print.
 	 */
-	for (l = tasks; l; l = l->next) {
-		PrintTask *ptask = l->data;
+	for (index = 0; index < data->tasks->len; index++) {
+		PrintTask *ptask = g_ptr_array_index (data->tasks, index);
 		MrpTask   *task  = ptask->task;
 		gchar     *name;
 		mrptime    finish;
-		gdouble    width;
 		gdouble    name_width;
 
 		g_object_get (task,
@@ -979,9 +1501,7 @@ planner_gantt_print_data_new (PlannerView     *view,
 			max_name_width = name_width;
 		}
 
-		gantt_print_get_allocated_resources_string (data, task, NULL, &width);
-
-		data->finish = MAX (data->finish, finish);/* + width * data->f);*/
+		data->finish = MAX (data->finish, finish);
 
 		g_free (name);
 	}
@@ -1013,9 +1533,10 @@ planner_gantt_print_data_new (PlannerView     *view,
 	data->arrow_width    = 0.11 * data->row_height;
 
 	if (num_tasks > 0) {
-		data->tasks_per_page_without_header = data->job->height / data->row_height;
-		data->tasks_per_page_with_header = (data->job->height - data->header_height) /
-			data->row_height;
+		/* Always at least one task per page, or we never get done. */
+		data->tasks_per_page_without_header = MAX (1, data->job->height / data->row_height);
+		data->tasks_per_page_with_header = MAX (1, (data->job->height - data->header_height) /
+							data->row_height);
 
 		data->cols_of_pages = ceil (((data->finish - data->start) /
 					     data->f + data->tree_x2 - data->tree_x1) /
@@ -1031,487 +1552,33 @@ planner_gantt_print_data_new (PlannerView     *view,
 
 		data->cols_of_pages = MAX (1, data->cols_of_pages);
 		data->rows_of_pages = MAX (1, data->rows_of_pages);
-
- 		data->pages = g_new0 (Page, data->cols_of_pages * data->rows_of_pages);
-
-
 	}
 
-	calendar = mrp_project_get_calendar (data->project);
-
-	num_tasks = g_list_length (data->tasks);
-
-	current_time = mrp_time_current_time();
+	data->current_time = mrp_time_current_time ();
 
-	/* Go through all tasks in a first pass and layout them so that we know
-	 * where to draw relation arrows.
+	/* Only find where each task starts and finishes here, which the
+	 * relation arrows need. The pages are laid out one at a time when
+	 * they are printed, see planner_gantt_print_do().
 	 */
+	for (row = 0, index = 0; index < data->tasks->len; row++) {
+		n = gantt_print_get_n_tasks (data, row);
 
-	l = data->tasks;
-	row = 0;
-	col = 0;
-	while (l) {
-		if (row == 0) {
-			/* Top-most row has the header. */
-			y0 = data->header_height;
-			tasks_on_this_page = data->tasks_per_page_with_header;
-		} else {
-			y0 = 0;
-			tasks_on_this_page = data->tasks_per_page_without_header;
-		}
-
-		/* Loop through the tasks on this row of pages. */
-		for (i = 0; i < tasks_on_this_page; i++) {
-			ptask = l->data;
-
-			start = mrp_task_get_work_start (ptask->task);
-			finish = mrp_task_get_finish (ptask->task);
-			complete = start + (finish - start) *
-				mrp_task_get_percent_complete (ptask->task) / 100.0;
-
-			is_summary = mrp_task_get_n_children (ptask->task) > 0;
-
-			g_object_get (ptask->task,
-				      "name", &name,
-				      "type", &type,
-				      "critical", &is_critical,
-				      NULL);
-
-			if (!is_summary && type == MRP_TASK_TYPE_MILESTONE) {
-				finish = start;
-			}
-
-			d(g_print ("%s: ", name));
-			g_free (name);
-
-			col = 0;
-			t1 = data->start;
-
-			y1 = y0 + data->row_height * (i + 0.25);
-			y2 = y1 + 0.5 * data->row_height;
-
-
-			/* Loop through the columns that this task covers. */
-			while (t1 <= finish) {
-				if (col == 0) {
-					/* Left-most column has the task tree. */
-					x0 = data->tree_x2;
-					t2 = data->second_column_start;
-				} else {
-					x0 = 0;
-					t2 = t1 + data->job->width * data->f;
-				}
-
-				element = g_new0 (Element, 1);
-
-				element->y1 = y1;
-				element->y2 = y2;
-				element->is_critical = is_critical;
-
-				/* Identify the cases: only left-most part on
-				 * page, only right-most part, the whole task,
-				 * or only the mid-section.
-				 */
-				if (start >= t1 && start <= t2 && finish > t2) {
-					/* Left */
-					d(g_print ("left "));
-
-					if (is_summary) {
-						element->type = SUMMARY_LEFT;
-					}
-					else if (type == MRP_TASK_TYPE_MILESTONE) {
-						element->type = MILESTONE;
-					} else {
-						element->type = TASK_LEFT;
-					}
-
-					element->x1 = x0 + (start - t1) / data->f;
-					element->x2 = data->job->width;
-					element->x_complete = x0 + (complete - t1) / data->f;
-					element->x_complete = MIN (element->x_complete, element->x2);
-				}
-				else if (start < t1 && finish >= t1 && finish <= t2) {
-					/* Right */
-					d(g_print ("right "));
-
-					if (is_summary) {
-						element->type = SUMMARY_RIGHT;
-					}
-					else if (type == MRP_TASK_TYPE_MILESTONE) {
-						element->type = MILESTONE;
-					} else {
-						element->type = TASK_RIGHT;
-					}
-
-					element->x1 = x0;
-					element->x2 = x0 + (finish - t1) / data->f;
-					element->x_complete = x0 + (complete - t1) / data->f;
-					element->x_complete = MIN (element->x_complete, element->x2);
-				}
-				else if (start >= t1 && finish <= t2) {
-					/* Whole */
-					d(g_print ("whole "));
-
-					if (is_summary) {
-						element->type = SUMMARY_WHOLE;
-					}
-					else if (type == MRP_TASK_TYPE_MILESTONE) {
-						element->type = MILESTONE;
-					} else {
-						element->type = TASK_WHOLE;
-					}
-
-					element->x1 = x0 + (start - t1) / data->f;
-					element->x2 = x0 + (finish - t1) / data->f;
-					element->x_complete = x0 + (complete - t1) / data->f;
-					element->x_complete = MIN (element->x_complete, element->x2);
-				}
-				else if (start < t1 && finish > t2) {
-					/* Middle */
-					d(g_print ("middle "));
-
-					if (is_summary) {
-						element->type = SUMMARY_MIDDLE;
-					}
-					else if (type == MRP_TASK_TYPE_MILESTONE) {
-						element->type = MILESTONE;
-					} else {
-						element->type = TASK_MIDDLE;
-					}
-
-					element->x1 = x0;
-					element->x2 = data->job->width;
-
-					if (complete > t1 && complete <= t2) {
-						element->x_complete = x0 + (complete - t1) / data->f;
-						element->x_complete = MIN (element->x_complete, element->x2);
-					}
-				} else {
-					d(g_print ("nothing"));
-					g_free (element);
-					element = NULL;
-				}
-
-				if (element) {
-					switch (element->type) {
-					case TASK_WHOLE:
-					case TASK_LEFT:
-					case SUMMARY_WHOLE:
-					case SUMMARY_LEFT:
-					case MILESTONE:
-						task_coord = g_new0 (TaskCoord, 1);
-						task_coord->row = row;
-						task_coord->col = col;
-
-						task_coord->x = element->x1;
-						task_coord->y = y1 - (y2 - y1) / 2;
-
-						g_hash_table_insert (data->task_start_coords,
-								     ptask->task,
-								     task_coord);
-						break;
-					default:
-						break;
-					}
-
-					switch (element->type) {
-					case TASK_WHOLE:
-					case TASK_RIGHT:
-					case SUMMARY_WHOLE:
-					case SUMMARY_RIGHT:
-					case MILESTONE:
-						task_coord = g_new0 (TaskCoord, 1);
-						task_coord->row = row;
-						task_coord->col = col;
-
-						task_coord->x = element->x2;
-						task_coord->y = y1 + (y2 - y1) / 2;
-
-						g_hash_table_insert (data->task_finish_coords,
-								     ptask->task,
-								     task_coord);
-						break;
-					default:
-						break;
-					}
-
-					page = GET_PAGE (data, row, col);
-					page->elements = g_list_prepend (page->elements, element);
-				}
-
-				t1 = t2;
-				col++;
-			}
-
-			d(g_print ("\n"));
-
-			/* Handle the allocated resources. */
-			if (gantt_print_get_allocated_resources_string (data, ptask->task, &str, NULL)) {
-				task_coord = g_hash_table_lookup (data->task_finish_coords,
-								  ptask->task);
-
-				/* FIXME: Remove this check when the scheduler
-				 * is fixed. We get a crash here if tasks get
-				 * really odd start/finish values. This
-				 * sometimes happens for complex projects now.
-				 */
-				if (!task_coord) {
-					goto fail;
-				}
-
-				element = g_new0 (Element, 1);
-				element->type = RESOURCES;
-
-				element->x1 = task_coord->x + data->job->x_pad;
-				element->y1 = y0 + data->row_height * (i + 0.75);
-
-				element->resources = str;
-
-				page = GET_PAGE (data, row, col - 1);
-				page->elements = g_list_prepend (page->elements, element);
-			}
-
-		fail:
-
-			l = l->next;
-			if (!l) {
-				break;
-			}
-		}
-
-		row++;
-		col = 0;
-	}
-
-	/* Second pass, go through all relations and add elements for them. */
-	relations = gantt_print_get_relations (data);
-	for (l = relations; l; l = l->next) {
-		MrpTask     *predecessor, *successor;
-		TaskCoord   *pre_coord, *suc_coord;
-		Page        *page;
-		MrpRelation *relation = l->data;
-		gint         from_row, to_row;
-		gdouble      top;
-
-		predecessor = mrp_relation_get_predecessor (relation);
-		successor = mrp_relation_get_successor (relation);
-
-		pre_coord = g_hash_table_lookup (data->task_finish_coords, predecessor);
-		suc_coord = g_hash_table_lookup (data->task_start_coords, successor);
-
-		/* One of the tasks might not be visible. */
-		if (!pre_coord || !suc_coord) {
-			continue;
-		}
-
-		element = g_new0 (Element, 1);
-		element->x1 = suc_coord->x;
-
-		from_row = MIN (pre_coord->row, suc_coord->row);
-		to_row = MAX (pre_coord->row, suc_coord->row);
-
-		/* Get the right direction and position of the arrow depending on
-		 * the order of the predecessor and successor.
-		 */
-		if ((pre_coord->row == suc_coord->row && pre_coord->y < suc_coord->y) ||
-		    (pre_coord->row < suc_coord->row)) {
-			element->y1 = suc_coord->y + data->row_height * 0.25;
-			element->type = RELATION_ARROW_DOWN;
-		} else {
-			element->y1 = suc_coord->y + data->row_height * 0.75;
-			element->type = RELATION_ARROW_UP;
-		}
-
-		page = GET_PAGE (data, suc_coord->row, suc_coord->col);
-		page->elements = g_list_prepend (page->elements, element);
-
-		for (row = from_row; row <= to_row; row++) {
-			if (row == pre_coord->row) {
-				for (col = pre_coord->col; col <= suc_coord->col; col++) {
-					element = g_new0 (Element, 1);
-					element->type = RELATION_HORIZ;
-
-					if (col == pre_coord->col) {
-						element->x1 = pre_coord->x;
-					} else {
-						if (col == 0) {
-							element->x1 = data->tree_x2;
-						} else {
-							element->x1 = 0;
-						}
-					}
-
-					if (col == suc_coord->col) {
-						element->x2 = suc_coord->x;
-					} else {
-						element->x2 = data->job->width;
-					}
-
-					element->y1 = pre_coord->y;
-
-					page = GET_PAGE (data, row, col);
-					page->elements = g_list_prepend (page->elements, element);
-				}
-			}
-
-			element = g_new0 (Element, 1);
-			element->type = RELATION_VERT;
-			element->x1 = suc_coord->x;
-
-			if (row == 0) {
-				top = data->header_height;
-			} else {
-				top = 0;
-			}
-
-			if (row == pre_coord->row) {
-				element->y1 = pre_coord->y;
-			} else {
-				if (pre_coord->row <= suc_coord->row) {
-					element->y1 = top;
-				} else {
-					element->y1 = data->job->height;
-				}
-			}
-
-			if (row == suc_coord->row) {
-				element->y2 = suc_coord->y + data->row_height / 2;
-			} else {
-				if (pre_coord->row <= suc_coord->row) {
-					element->y2 = data->job->height;
-				} else {
-					element->y2 = top;
-				}
-			}
-
-			page = GET_PAGE (data, row, suc_coord->col);
-			page->elements = g_list_prepend (page->elements, element);
+		for (i = 0; i < n; i++, index++) {
+			gantt_print_layout_task (data, NULL, 0,
+						 g_ptr_array_index (data->tasks, index),
+						 row, i);
 		}
 	}
 
-	g_list_free (relations);
-
-	/* Third pass, add background shading for non-work intervals. */
-	for (row = 0; row < data->rows_of_pages; row++) {
-		t0 = mrp_time_align_day (data->start);
-
-		if (row == 0) {
-			/* Top-most row has the header. */
-			y0 = data->header_height;
-		} else {
-			y0 = 0;
-		}
-
-		for (col = 0; col < data->cols_of_pages; col++) {
-			mrptime ival_start, ival_end, ival_prev;
-
-			if (col == 0) {
-				/* Left-most col has the tree. */
-				x0 = data->tree_x2;
-			} else {
-				x0 = 0;
-			}
-
-			t2 = t0 + (data->job->width - x0) * data->f;
-
-			/* Loop through the days between t0 and t2. */
-			t1 = mrp_time_align_day(t0);
-
-			while (t1 <= t2) {
-				gboolean done = FALSE;
-
-				day = mrp_calendar_get_day (calendar, t1, TRUE);
-
-				ivals = mrp_calendar_day_get_intervals (calendar, day, TRUE);
-
-				ival_prev = t1;
-
-				/* Loop through the non-work intervals for this day */
-				while (!done)
-				{
-					/* The number of non-work intervals is one for each work interval and one
-					 * more for the remaining period after the last work interval */
-					if (ivals != NULL) {
-						mrp_interval_get_absolute (ivals->data,
-									   t1,
-									   &ival_start,
-									   &ival_end);
-
-						ivals = ivals->next;
-					} else {
-						ival_start = t1 + 60*60*24;
-						done = TRUE;
-					}
-
-					/* Only consider non-work intervals that are large enough and
-					 * lie (partially) within [t0...t2] */
-					if (ival_prev < t2 && ival_start > t0 &&
-					    planner_scale_conf[data->level].nonworking_limit <= ival_start - ival_prev) {
-
-						/* Only draw the part within [t0...t2] */
-
-						element = g_new0 (Element, 1);
-						element->type = SHADE;
-						element->y1 = y0;
-						element->y2 = data->job->height;
-
-						element->x1 = x0 + (MAX(t0, ival_prev) - t0) / data->f;
-						element->x2 = x0 + (MIN(t2, ival_start) - t0) / data->f;
-
-						page = GET_PAGE (data, row, col);
-						page->background_elements = g_list_prepend (page->background_elements, element);
-
-					}
-
-					ival_prev = ival_end;
-				}
-				/* Set t1 to the start of the next day */
-				t1 = ival_start;
-			}
-
-			/* Print the current time. */
-			if (current_time >= t0 && current_time <= t2) {
-				element = g_new0 (Element, 1);
-				element->type = TIMELINE;
-				element->y1 = data->header_height;
-				element->y2 = data->job->height;
-				element->x1 = x0 + (current_time - t0) / data->f;
-				element->x2 = element->x1;
-				page = GET_PAGE (data, row, col);
-				page->background_elements = g_list_prepend (page->background_elements, element);
-			}
-
-			t0 = t2;
-		}
-	}
+	data->relations_by_row = gantt_print_get_relations (data);
 
 	return data;
 }
 
-static void
-free_page (Page *page)
-{
-	GList   *l;
-	Element *element;
-
-	for (l = page->elements; l; l = l->next) {
-		element = l->data;
-		g_free (element->resources);
-	}
-
-	for (l = page->background_elements; l; l = l->next) {
-		element = l->data;
-		g_free (element->resources);
-	}
-
-	g_list_free (page->elements);
-	g_list_free (page->background_elements);
-}
-
 void
 planner_gantt_print_data_free (PlannerGanttPrintData *data)
 {
-	gint i, num_pages;
+	gint row;
 
 	g_return_if_fail (data != NULL);
 
@@ -1521,14 +1588,11 @@ planner_gantt_print_data_free (PlannerGanttPrintData *data)
 	gantt_print_free_print_tasks (data->tasks);
 	data->tasks = NULL;
 
-	num_pages = data->cols_of_pages * data->rows_of_pages;
-
-	for (i = 0; i < num_pages; i++) {
-		free_page (&data->pages[i]);
+	for (row = 0; row < data->rows_of_pages; row++) {
+		g_ptr_array_free (data->relations_by_row[row], TRUE);
 	}
-
-	g_free (data->pages);
-	data->pages = NULL;
+	g_free (data->relations_by_row);
+	data->relations_by_row = NULL;
 
 	g_free (data);
 }
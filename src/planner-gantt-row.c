@@ -29,6 +29,7 @@
 #include <libplanner/mrp-resource.h>
 #include <libplanner/mrp-task.h>
 #include <libplanner/mrp-calendar.h>
+#include <libplanner/mrp-trace.h>
 #include <glib/gi18n.h>
 #include <libgnomecanvas/gnome-canvas.h>
 #include "planner-marshal.h"
@@ -42,6 +43,7 @@
 #include "planner-task-tree.h"
 #include "planner-task-popup.h"
 #include "planner-task-cmd.h"
+#include "planner-text-cache.h"
 
 /* The padding between the gantt bar and the text. */
 #define TEXT_PADDING 10.0
@@ -61,6 +63,11 @@
 /* Minimum width for a task to keep it visible. */
 #define MIN_WIDTH 2
 
+/* Bars narrower than this (pixels) are drawn as a plain block, there is no
+ * room for slices, progress or the 3D frame anyway.
+ */
+#define MIN_DETAIL_WIDTH 4
+
 /* Trim the value to short int work space. */
 #define TRSH(a) ((int)((a) < SHRT_MIN ? (short int)SHRT_MIN : ((a) > SHRT_MAX ? (short int)SHRT_MAX : (a))))
 
@@ -165,6 +172,10 @@ struct _PlannerGanttRowPriv {
 	gdouble      text_width;
 	gdouble      text_height;
 
+	/* Size of the resource label, from the text cache. */
+	gint         label_width;
+	gint         label_height;
+
 	/* Cached positions of each assigned resource. */
 	GArray      *resource_widths;
 
@@ -436,6 +447,7 @@ gantt_row_init (PlannerGanttRow *row)
 	priv->bar_top = 0.0;
 	priv->bar_bot = 0.0;
 	priv->scale = 1.0;
+	priv->zoom = 7.0;
 	priv->visible = TRUE;
 	priv->highlight = FALSE;
 	priv->mouse_over_index = -1;
@@ -503,6 +515,12 @@ gantt_row_get_bounds (PlannerGanttRow *row,
 	*py2 = cy2 + 1;
 }
 
+static PlannerScaleDetail
+gantt_row_get_detail (PlannerGanttRow *row)
+{
+	return planner_scale_conf[planner_scale_clamp_zoom (row->priv->zoom)].detail;
+}
+
 static gboolean
 recalc_bounds (PlannerGanttRow *row)
 {
@@ -519,14 +537,19 @@ recalc_bounds (PlannerGanttRow *row)
 	old_x_start = priv->x_start;
 	old_width = priv->width;
 
-	gantt_row_ensure_layout (row);
+	/* Don't lay out labels we're not going to draw at this zoom level. */
+	if (gantt_row_get_detail (row) != PLANNER_SCALE_DETAIL_OVERVIEW) {
+		gantt_row_ensure_layout (row);
 
-	pango_layout_get_pixel_size (priv->layout,
-				     &width,
-				     &height);
+		width = priv->label_width;
+		height = priv->label_height;
 
-	if (width > 0) {
-		width += TEXT_PADDING;
+		if (width > 0) {
+			width += TEXT_PADDING;
+		}
+	} else {
+		width = 0;
+		height = 0;
 	}
 
 	priv->text_width = width;
@@ -583,7 +606,13 @@ gantt_row_set_property (GObject      *object,
 		break;
 
 	case PROP_ZOOM:
-		priv->zoom = g_value_get_double (value);
+		tmp_dbl = g_value_get_double (value);
+		if (planner_scale_conf[planner_scale_clamp_zoom (tmp_dbl)].detail !=
+		    gantt_row_get_detail (row)) {
+			/* Labels appear or disappear. */
+			changed = TRUE;
+		}
+		priv->zoom = tmp_dbl;
 		break;
 
 	case PROP_Y:
@@ -727,6 +756,7 @@ static void
 gantt_row_update_resources (PlannerGanttRow *row)
 {
 	PlannerGanttRowPriv *priv;
+	GtkWidget      *widget;
 	GList          *l;
 	GList          *resources;
 	MrpTask        *task;
@@ -734,24 +764,22 @@ gantt_row_update_resources (PlannerGanttRow *row)
 	MrpResource    *resource;
 	const gchar    *name;
 	gchar          *name_unit;
-	gchar          *tmp_str;
-	gchar          *text = NULL;
-	PangoRectangle  rect;
-	gint            spacing, x;
+	GString        *text;
+	gint            spacing, x, width;
 	gint            units;
 
 	priv = row->priv;
 
 	task = priv->task;
+	widget = GTK_WIDGET (GNOME_CANVAS_ITEM (row)->canvas);
 
 	g_array_set_size (priv->resource_widths, 0);
 
 	/* Measure the spacing between resource names. */
-	pango_layout_set_text (priv->layout, ", ", 2);
-	pango_layout_get_extents (priv->layout, NULL, &rect);
-	spacing = rect.width / PANGO_SCALE;
+	planner_text_cache_get_pixel_size (widget, ", ", &spacing, NULL);
 
 	x = 0;
+	text = g_string_new (NULL);
 	resources = mrp_task_get_assigned_resources (priv->task);
 
 	for (l = resources; l; l = l->next) {
@@ -760,55 +788,45 @@ gantt_row_update_resources (PlannerGanttRow *row)
 		assignment = mrp_task_get_assignment (task, resource);
 		units = mrp_assignment_get_units (assignment);
 
-		/* Try short name first. */
-		name = mrp_resource_get_short_name (resource);
-
-		if (!name || name[0] == 0) {
-			name = mrp_resource_get_name (resource);
-		}
-
-		if (!name || name[0] == 0) {
-				name = _("Unnamed");
-		}
+		name = planner_text_cache_get_resource_label (resource);
 
 		g_array_append_val (priv->resource_widths, x);
 
 		if (units != 100) {
 			name_unit = g_strdup_printf ("%s [%i]", name, units);
 		} else {
-			name_unit = g_strdup_printf ("%s", name);
+			name_unit = g_strdup (name);
 		}
 
-		pango_layout_set_text (priv->layout, name_unit, -1);
-		pango_layout_get_extents (priv->layout, NULL, &rect);
-		x += rect.width / PANGO_SCALE;
+		planner_text_cache_get_pixel_size (widget, name_unit,
+						   &width, NULL);
+		x += width;
 		g_array_append_val (priv->resource_widths, x);
 
 		x += spacing;
 
-		if (text == NULL) { /* First resource */
-			text = g_strdup_printf ("%s", name_unit);
-			g_free (name_unit);
-			continue;
+		if (text->len > 0) {
+			g_string_append (text, ", ");
 		}
 
-		tmp_str = g_strdup_printf ("%s, %s", text, name_unit);
-
-		g_free (text);
+		g_string_append (text, name_unit);
 		g_free (name_unit);
-
-		text = tmp_str;
 	}
 
 	g_list_free (resources);
 
-	if (text == NULL) {
-		pango_layout_set_text (priv->layout, "", 0);
-	} else {
-		pango_layout_set_text (priv->layout, text, -1);
+	planner_text_cache_get_pixel_size (widget, text->str,
+					   &priv->label_width,
+					   &priv->label_height);
+
+	/* Setting the text throws away the layout's shaping, only do it when
+	 * the label really changed.
+	 */
+	if (strcmp (pango_layout_get_text (priv->layout), text->str) != 0) {
+		pango_layout_set_text (priv->layout, text->str, text->len);
 	}
 
-	g_free (text);
+	g_string_free (text, TRUE);
 }
 
 static void
@@ -827,7 +845,9 @@ gantt_row_update (GnomeCanvasItem *item,
 							clip_path,
 							flags);
 
-	gantt_row_ensure_layout (row);
+	if (gantt_row_get_detail (row) != PLANNER_SCALE_DETAIL_OVERVIEW) {
+		gantt_row_ensure_layout (row);
+	}
 	gantt_row_get_bounds (row, &x1, &y1, &x2, &y2);
 
 	gnome_canvas_update_bbox (item, x1, y1, x2, y2);
@@ -1225,6 +1245,11 @@ gantt_row_draw (GnomeCanvasItem *item,
 	gint                 topy,  nres, finish;
 	gdouble              delta;
 	GList               *assignments;
+	PlannerScaleDetail   detail;
+
+	if (mrp_trace_is_enabled ()) {
+		mrp_trace_count (MRP_TRACE_COUNTER_ROWS_DRAWN, 1);
+	}
 
 	shadup_start = -1;
 	shadup_end = -1;
@@ -1256,6 +1281,7 @@ gantt_row_draw (GnomeCanvasItem *item,
 	highlight_critical = planner_gantt_chart_get_highlight_critical_tasks (chart);
 	display_nonstandard_days = planner_gantt_chart_get_nonstandard_days (chart);
 	level = planner_scale_clamp_zoom (priv->zoom);
+	detail = planner_scale_conf[level].detail;
 
 
 	/*
@@ -1331,13 +1357,34 @@ gantt_row_draw (GnomeCanvasItem *item,
 
 	gantt_row_setup_frame_gc (row, !summary && priv->highlight);
 
-	if (type == MRP_TASK_TYPE_NORMAL && !summary && rx1 <= rx2) {
+	if (type == MRP_TASK_TYPE_NORMAL && !summary && rx1 <= rx2 &&
+	    cx2 - cx1 < MIN_DETAIL_WIDTH) {
+		/* Too narrow for any detail, just mark the pixel columns the
+		 * task covers.
+		 */
+		if (!highlight_critical || !critical) {
+			gdk_gc_set_foreground (priv->fill_gc, &priv->color_normal_dark);
+		} else {
+			gdk_gc_set_foreground (priv->fill_gc, &priv->color_critical_dark);
+		}
+		draw_cut_rectangle (drawable,
+				    priv->fill_gc,
+				    TRUE,
+				    rx1,
+				    cy1,
+				    rx2 - rx1 + 1,
+				    cy2 - cy1 + 1);
+	}
+	else if (type == MRP_TASK_TYPE_NORMAL && !summary && rx1 <= rx2) {
 		if (complete_width > 0) {
 			gnome_canvas_set_stipple_origin (item->canvas,
 							 priv->complete_gc);
 		}
 
-		if (assignments) {
+		/* The slices need a calendar walk for every day of the task,
+		 * only do that when zoomed in enough to see them.
+		 */
+		if (assignments && detail == PLANNER_SCALE_DETAIL_FULL) {
 			/* #define DRAW_BACKGROUND_CHECK 1 */
 #ifdef DRAW_BACKGROUND_CHECK
 			gnome_canvas_get_color (item->canvas, "indian red", &color);
@@ -1742,7 +1789,7 @@ gantt_row_draw (GnomeCanvasItem *item,
 				}
 			}
 		}
-		else { /* if (assignments) ... */
+		else { /* if (assignments && detail == FULL) ... */
 			if (!highlight_critical || !critical) {
 				gdk_gc_set_foreground (priv->fill_gc, &priv->color_normal);
 			} else {
@@ -1994,25 +2041,18 @@ gantt_row_draw (GnomeCanvasItem *item,
 	}
 }
 
-static double
-gantt_row_point (GnomeCanvasItem  *item,
-		 double            x,
-		 double            y,
-		 gint              cx,
-		 gint              cy,
-		 GnomeCanvasItem **actual_item)
+static gdouble
+gantt_row_get_distance (PlannerGanttRow *row,
+			gdouble          x,
+			gdouble          y)
 {
-	PlannerGanttRow     *row;
 	PlannerGanttRowPriv *priv;
 	gint                 text_width;
 	gdouble              x1, y1, x2, y2;
 	gdouble              dx, dy;
 
-	row = PLANNER_GANTT_ROW (item);
 	priv = row->priv;
 
-	*actual_item = item;
-
 	text_width = priv->text_width;
 	if (text_width > 0) {
 		text_width += TEXT_PADDING;
@@ -2049,6 +2089,19 @@ gantt_row_point (GnomeCanvasItem  *item,
 	return sqrt (dx * dx + dy * dy);
 }
 
+static double
+gantt_row_point (GnomeCanvasItem  *item,
+		 double            x,
+		 double            y,
+		 gint              cx,
+		 gint              cy,
+		 GnomeCanvasItem **actual_item)
+{
+	*actual_item = item;
+
+	return gantt_row_get_distance (PLANNER_GANTT_ROW (item), x, y);
+}
+
 static void
 gantt_row_bounds (GnomeCanvasItem *item,
 		  double          *x1,
@@ -2089,8 +2142,7 @@ gantt_row_notify_cb (MrpTask *task, GParamSpec *pspec, PlannerGanttRow *row)
 static void
 gantt_row_update_assignment_string (PlannerGanttRow *row)
 {
-	gantt_row_update_resources (row);
-
+	/* Updates the resources string if labels are shown. */
 	recalc_bounds (row);
 	gnome_canvas_item_request_update (GNOME_CANVAS_ITEM (row));
 }
@@ -2104,6 +2156,9 @@ gantt_row_assignment_added (MrpTask         *task,
 
 	resource = mrp_assignment_get_resource (assignment);
 
+	/* Before our own handlers, so that they see the new label. */
+	planner_text_cache_watch_resource (resource);
+
 	g_signal_connect_object (resource, "notify::name",
 				 G_CALLBACK (gantt_row_resource_name_changed),
 				 row, 0);
@@ -2199,6 +2254,30 @@ planner_gantt_row_get_geometry (PlannerGanttRow *row,
 	}
 }
 
+/* Returns TRUE if the world coordinate (x, y) is on the bar or its label,
+ * using the same tolerance as the canvas does when picking items.
+ */
+gboolean
+planner_gantt_row_hit_test (PlannerGanttRow *row,
+			    gdouble          x,
+			    gdouble          y)
+{
+	GnomeCanvas *canvas;
+	gdouble      dist;
+
+	g_return_val_if_fail (PLANNER_IS_GANTT_ROW (row), FALSE);
+
+	if (!row->priv->visible) {
+		return FALSE;
+	}
+
+	canvas = GNOME_CANVAS_ITEM (row)->canvas;
+
+	dist = gantt_row_get_distance (row, x, y);
+
+	return (gint) (dist * canvas->pixels_per_unit + 0.5) <= canvas->close_enough;
+}
+
 void
 planner_gantt_row_set_visible (PlannerGanttRow *row,
 			       gboolean         is_visible)
@@ -2249,6 +2328,8 @@ gantt_row_connect_all_resources (MrpTask *task, PlannerGanttRow *row)
 	for (node = resources; node; node = node->next) {
 		resource = MRP_RESOURCE (node->data);
 
+		planner_text_cache_watch_resource (resource);
+
 		g_signal_connect_object (resource, "notify::name",
 					 G_CALLBACK (gantt_row_resource_name_changed),
 					 row, 0);
@@ -2372,7 +2453,7 @@ gantt_row_drag_item_to_pointer (PlannerGanttRow *row, gboolean scroll)
 				       NULL);
 		break;
 	case STATE_DRAG_LINK:
-		target_item = gnome_canvas_get_item_at (canvas, wx2, wy2);
+		target_item = (GnomeCanvasItem *) planner_gantt_chart_get_row_at (chart, wx2, wy2);
 
 		drag_points->coords[0] = drag_wx1;
 		drag_points->coords[1] = drag_wy1;
@@ -2950,9 +3031,10 @@ gantt_row_event (GnomeCanvasItem *item, GdkEvent *event)
 			gtk_object_destroy (GTK_OBJECT (drag_item));
 			drag_item = NULL;
 
-			target_item = gnome_canvas_get_item_at (item->canvas,
-								event->button.x,
-								event->button.y);
+			chart = g_object_get_data (G_OBJECT (item->canvas), "chart");
+			target_item = (GnomeCanvasItem *) planner_gantt_chart_get_row_at (chart,
+											  event->button.x,
+											  event->button.y);
 
 			if (target_item && target_item != item) {
 				GError            *error = NULL;
@@ -3136,6 +3218,11 @@ gantt_row_get_resource_index_at (PlannerGanttRow *row,
 
 	priv = row->priv;
 
+	/* No labels, nothing to click. */
+	if (priv->text_width == 0) {
+		return -1;
+	}
+
 	offset = priv->x + priv->width + TEXT_PADDING;
 	x -= offset;
 
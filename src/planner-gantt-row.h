@@ -57,6 +57,9 @@ void  planner_gantt_row_get_geometry (PlannerGanttRow *row,
 				 gdouble    *y2);
 void  planner_gantt_row_set_visible  (PlannerGanttRow *row,
 				 gboolean    is_visible);
+gboolean planner_gantt_row_hit_test  (PlannerGanttRow *row,
+				 gdouble     x,
+				 gdouble     y);
 
 void planner_gantt_row_init_menu (PlannerGanttRow *row);
 
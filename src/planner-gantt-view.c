@@ -60,6 +60,12 @@ static void          gantt_view_insert_tasks_cb           (GtkAction         *ac
 							   gpointer           data);
 static void          gantt_view_remove_task_cb            (GtkAction         *action,
 							   gpointer           data);
+static void          gantt_view_cut_task_cb               (GtkAction         *action,
+							   gpointer           data);
+static void          gantt_view_copy_task_cb              (GtkAction         *action,
+							   gpointer           data);
+static void          gantt_view_paste_task_cb             (GtkAction         *action,
+							   gpointer           data);
 static void          gantt_view_edit_task_cb              (GtkAction         *action,
 							   gpointer           data);
 static void          gantt_view_select_all_cb             (GtkAction         *action,
@@ -144,6 +150,15 @@ static const GtkActionEntry entries[] = {
 	{ "RemoveTask",      "planner-stock-remove-task",    N_("_Remove Task"),
 	  "Delete",           N_("Remove the selected tasks"),
 	  G_CALLBACK (gantt_view_remove_task_cb) },
+	{ "CutTask",         GTK_STOCK_CUT,                  N_("Cu_t Tasks"),
+	  "",                  N_("Cut the selected tasks"),
+	  G_CALLBACK (gantt_view_cut_task_cb) },
+	{ "CopyTask",        GTK_STOCK_COPY,                 N_("_Copy Tasks"),
+	  "",                  N_("Copy the selected tasks"),
+	  G_CALLBACK (gantt_view_copy_task_cb) },
+	{ "PasteTask",       GTK_STOCK_PASTE,                N_("_Paste Tasks"),
+	  "",                  N_("Paste the copied tasks"),
+	  G_CALLBACK (gantt_view_paste_task_cb) },
 	{ "EditTask",        NULL,                           N_("_Edit Task Properties..."),
 	  "<control>e",       NULL,
 	  G_CALLBACK (gantt_view_edit_task_cb) },
@@ -786,6 +801,39 @@ gantt_view_remove_task_cb (GtkAction *action,
 	planner_task_tree_remove_task (PLANNER_TASK_TREE (view->priv->tree));
 }
 
+static void
+gantt_view_cut_task_cb (GtkAction *action,
+			gpointer   data)
+{
+	PlannerGanttView *view;
+
+	view = PLANNER_GANTT_VIEW (data);
+
+	planner_task_tree_cut_task (PLANNER_TASK_TREE (view->priv->tree));
+}
+
+static void
+gantt_view_copy_task_cb (GtkAction *action,
+			 gpointer   data)
+{
+	PlannerGanttView *view;
+
+	view = PLANNER_GANTT_VIEW (data);
+
+	planner_task_tree_copy_task (PLANNER_TASK_TREE (view->priv->tree));
+}
+
+static void
+gantt_view_paste_task_cb (GtkAction *action,
+			  gpointer   data)
+{
+	PlannerGanttView *view;
+
+	view = PLANNER_GANTT_VIEW (data);
+
+	planner_task_tree_paste_task (PLANNER_TASK_TREE (view->priv->tree));
+}
+
 static void
 gantt_view_select_all_cb (GtkAction *action,
 			  gpointer   data)
@@ -1156,6 +1204,14 @@ gantt_view_update_ui (PlannerGanttView *view)
 		      "sensitive", value,
 		      NULL);
 
+	g_object_set (gtk_action_group_get_action (priv->actions, "CutTask"),
+		      "sensitive", value,
+		      NULL);
+
+	g_object_set (gtk_action_group_get_action (priv->actions, "CopyTask"),
+		      "sensitive", value,
+		      NULL);
+
 	g_object_set (gtk_action_group_get_action (priv->actions, "UnlinkTask"),
 		      "sensitive", rel_value,
 		      NULL);
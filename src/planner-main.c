@@ -38,10 +38,12 @@ static PlannerApplication *application;
 
 /* Command line options */
 static gchar *geometry = NULL;
+static gchar *export_pdf = NULL;
 static gchar **args_remaining = NULL;
 
 static GOptionEntry options[] = {
 		{ "geometry", 'g', 0, G_OPTION_ARG_STRING, &geometry, N_("Create the initial window with the given geometry."), N_("GEOMETRY")},
+		{ "export-pdf", 0, 0, G_OPTION_ARG_FILENAME, &export_pdf, N_("Print the project to a PDF file and exit."), N_("FILE")},
 		{ G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &args_remaining, NULL, N_("FILES|URIs") },
 		{ NULL }
 	};
@@ -95,6 +97,34 @@ main (int argc, char **argv)
 	application = planner_application_new ();
 	main_window = planner_application_new_window (application);
 
+	if (export_pdf) {
+		gchar    *uri = NULL;
+		gboolean  success = FALSE;
+
+		if (args_remaining != NULL && args_remaining[0] != NULL) {
+			uri = mrp_project_make_uri (args_remaining[0]);
+		}
+
+		if (!uri) {
+			g_printerr (_("No project to export.\n"));
+		}
+		else if (planner_window_open (PLANNER_WINDOW (main_window), uri, TRUE)) {
+			success = planner_window_export_pdf (PLANNER_WINDOW (main_window),
+							     export_pdf,
+							     &error);
+			if (!success) {
+				g_printerr ("%s\n", error->message);
+				g_error_free (error);
+			}
+		}
+
+		g_free (uri);
+		gtk_widget_destroy (main_window);
+		g_object_unref (application);
+
+		return success ? 0 : 1;
+	}
+
 	if ((geometry) && !gtk_window_parse_geometry (GTK_WINDOW (main_window), geometry))
 		g_warning(_("Invalid geometry string \"%s\"\n"), geometry);
 
@@ -102,32 +132,12 @@ main (int argc, char **argv)
 
 	if (args_remaining != NULL) {
 		for (i = 0; args_remaining[i]; i++) {
-			gchar *scheme = g_uri_parse_scheme(args_remaining[i]);
-			if (scheme != NULL) {
+			gchar *uri = mrp_project_make_uri (args_remaining[i]);
+
+			if (uri) {
 				planner_window_open_in_existing_or_new (
-					PLANNER_WINDOW (main_window), args_remaining[i], FALSE);
-				g_free(scheme);
-			} else {
-				gchar *uri;
-
-				if (!g_path_is_absolute (args_remaining[i])) {
-					/* Relative path. */
-					gchar *cwd, *tmp;
-
-					cwd = g_get_current_dir ();
-					tmp = g_build_filename (cwd, args_remaining[i], NULL);
-					uri = g_filename_to_uri (tmp, NULL, NULL);
-					g_free (tmp);
-					g_free (cwd);
-				} else {
-					uri = g_filename_to_uri (args_remaining[i], NULL, NULL);
-				}
-
-				if (uri) {
-					planner_window_open_in_existing_or_new (
-						PLANNER_WINDOW (main_window), uri, FALSE);
-					g_free (uri);
-				}
+					PLANNER_WINDOW (main_window), uri, FALSE);
+				g_free (uri);
 			}
 		}
 	}
@@ -0,0 +1,239 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <config.h>
+#include <libplanner/mrp-trace.h>
+#include "planner-perf-hud.h"
+
+/* Times the exposes of a chart canvas and, with PLANNER_DEBUG_PERF_HUD set,
+ * draws the latest expose, reflow and recalc numbers in the top left corner
+ * of the canvas. Does nothing unless tracing is enabled, see mrp-trace.h.
+ */
+
+#define HUD_PADDING 4
+#define HUD_REFRESH_TIMEOUT 250
+
+typedef struct {
+	GnomeCanvas  *canvas;
+	gchar        *expose_name;
+	gchar        *reflow_name;
+
+	gint64        expose_start;
+
+	PangoLayout  *layout;
+	GdkRectangle  area;
+	guint         refresh_id;
+} PerfHud;
+
+static void
+perf_hud_free (PerfHud *hud)
+{
+	if (hud->refresh_id) {
+		g_source_remove (hud->refresh_id);
+	}
+
+	if (hud->layout) {
+		g_object_unref (hud->layout);
+	}
+
+	g_free (hud->expose_name);
+	g_free (hud->reflow_name);
+	g_free (hud);
+}
+
+static gboolean
+perf_hud_refresh_timeout (PerfHud *hud)
+{
+	hud->refresh_id = 0;
+
+	gdk_window_invalidate_rect (GTK_LAYOUT (hud->canvas)->bin_window,
+				    &hud->area,
+				    FALSE);
+
+	return FALSE;
+}
+
+static gdouble
+perf_hud_last_ms (const gchar *name)
+{
+	gint64 duration;
+
+	duration = mrp_trace_get_last_duration (name);
+	if (duration < 0) {
+		return 0.0;
+	}
+
+	return duration / 1000.0;
+}
+
+static void
+perf_hud_draw (PerfHud        *hud,
+	       GdkEventExpose *event,
+	       gint            rows,
+	       gint            lookups)
+{
+	GtkWidget    *widget;
+	GdkRectangle  area;
+	gchar        *text;
+	gint          x, y;
+	gint          width, height;
+
+	widget = GTK_WIDGET (hud->canvas);
+
+	if (!hud->layout) {
+		hud->layout = gtk_widget_create_pango_layout (widget, NULL);
+	}
+
+	text = g_strdup_printf ("expose %.1f ms, %d rows, %d calendar lookups\n"
+				"reflow %.1f ms\n"
+				"recalc %.1f ms",
+				perf_hud_last_ms (hud->expose_name),
+				rows,
+				lookups,
+				perf_hud_last_ms (hud->reflow_name),
+				perf_hud_last_ms ("recalc"));
+
+	pango_layout_set_text (hud->layout, text, -1);
+	g_free (text);
+
+	pango_layout_get_pixel_size (hud->layout, &width, &height);
+
+	gnome_canvas_get_scroll_offsets (hud->canvas, &x, &y);
+
+	area.x = x + HUD_PADDING;
+	area.y = y + HUD_PADDING;
+	area.width = width + 2 * HUD_PADDING;
+	area.height = height + 2 * HUD_PADDING;
+
+	gdk_draw_rectangle (event->window,
+			    widget->style->base_gc[GTK_STATE_NORMAL],
+			    TRUE,
+			    area.x, area.y,
+			    area.width, area.height);
+
+	gdk_draw_rectangle (event->window,
+			    widget->style->fg_gc[GTK_STATE_NORMAL],
+			    FALSE,
+			    area.x, area.y,
+			    area.width - 1, area.height - 1);
+
+	gdk_draw_layout (event->window,
+			 widget->style->text_gc[GTK_STATE_NORMAL],
+			 area.x + HUD_PADDING,
+			 area.y + HUD_PADDING,
+			 hud->layout);
+
+	hud->area = area;
+
+	/* Drawing is clipped to the exposed area, so if this expose didn't
+	 * cover the whole HUD, repaint it a bit later. The repaint covers it,
+	 * so this doesn't loop.
+	 */
+	gdk_rectangle_intersect (&event->area, &area, &area);
+	if ((area.width != hud->area.width || area.height != hud->area.height) &&
+	    hud->refresh_id == 0) {
+		hud->refresh_id = g_timeout_add (HUD_REFRESH_TIMEOUT,
+						 (GSourceFunc) perf_hud_refresh_timeout,
+						 hud);
+	}
+}
+
+static gboolean
+perf_hud_expose_event_cb (GtkWidget      *widget,
+			  GdkEventExpose *event,
+			  PerfHud        *hud)
+{
+	if (event->window != GTK_LAYOUT (widget)->bin_window) {
+		return FALSE;
+	}
+
+	/* Only count what this expose does. */
+	mrp_trace_take_count (MRP_TRACE_COUNTER_ROWS_DRAWN);
+	mrp_trace_take_count (MRP_TRACE_COUNTER_CALENDAR_LOOKUPS);
+
+	hud->expose_start = mrp_trace_now ();
+
+	return FALSE;
+}
+
+static gboolean
+perf_hud_expose_event_after_cb (GtkWidget      *widget,
+				GdkEventExpose *event,
+				PerfHud        *hud)
+{
+	gint rows, lookups;
+
+	if (event->window != GTK_LAYOUT (widget)->bin_window) {
+		return FALSE;
+	}
+
+	rows = mrp_trace_take_count (MRP_TRACE_COUNTER_ROWS_DRAWN);
+	lookups = mrp_trace_take_count (MRP_TRACE_COUNTER_CALENDAR_LOOKUPS);
+
+	mrp_trace_complete (hud->expose_name, hud->expose_start,
+			    "rows", rows,
+			    "calendar_lookups", lookups,
+			    "width", event->area.width,
+			    "height", event->area.height,
+			    NULL);
+
+	if (mrp_trace_hud_is_enabled ()) {
+		perf_hud_draw (hud, event, rows, lookups);
+	}
+
+	return FALSE;
+}
+
+/* Starts timing the canvas exposes. The events are recorded as
+ * "<name>-expose", and the HUD also shows the latest "<name>-reflow".
+ */
+void
+planner_perf_hud_attach (GnomeCanvas *canvas,
+			 const gchar *name)
+{
+	PerfHud *hud;
+
+	g_return_if_fail (GNOME_IS_CANVAS (canvas));
+	g_return_if_fail (name != NULL);
+
+	if (!mrp_trace_is_enabled ()) {
+		return;
+	}
+
+	hud = g_new0 (PerfHud, 1);
+	hud->canvas = canvas;
+	hud->expose_name = g_strconcat (name, "-expose", NULL);
+	hud->reflow_name = g_strconcat (name, "-reflow", NULL);
+
+	g_object_set_data_full (G_OBJECT (canvas),
+				"perf-hud",
+				hud,
+				(GDestroyNotify) perf_hud_free);
+
+	g_signal_connect (canvas,
+			  "expose_event",
+			  G_CALLBACK (perf_hud_expose_event_cb),
+			  hud);
+
+	g_signal_connect_after (canvas,
+				"expose_event",
+				G_CALLBACK (perf_hud_expose_event_after_cb),
+				hud);
+}
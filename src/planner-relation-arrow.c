@@ -22,11 +22,13 @@
 
 #include <config.h>
 #include <math.h>
+#include <string.h>
 #include <libgnomecanvas/gnome-canvas.h>
 #include <libgnomecanvas/gnome-canvas-util.h>
 #include <libgnomecanvas/gnome-canvas-line.h>
 #include <libplanner/mrp-relation.h>
 #include "planner-gantt-row.h"
+#include "planner-gantt-chart.h"
 #include "planner-relation-arrow.h"
 
 #undef USE_AFFINE
@@ -138,12 +140,6 @@ static void    relation_arrow_draw         (GnomeCanvasItem       *item,
 					    gint                   y,
 					    gint                   width,
 					    gint                   height);
-static gdouble relation_arrow_point        (GnomeCanvasItem       *item,
-					    gdouble                x,
-					    gdouble                y,
-					    gint                   cx,
-					    gint                   cy,
-					    GnomeCanvasItem      **actual_item);
 
 /* Properties */
 enum {
@@ -200,7 +196,11 @@ relation_arrow_class_init (PlannerRelationArrowClass *klass)
 	item_class->update = relation_arrow_update;
 	item_class->draw = relation_arrow_draw;
 	item_class->bounds = NULL;
-	item_class->point = relation_arrow_point;
+
+	/* Arrows are never picked, leaving out ::point makes the canvas skip
+	 * them when it looks for the item under the pointer.
+	 */
+	item_class->point = NULL;
 
 	/* Properties. */
 	g_object_class_install_property (o_class,
@@ -274,18 +274,34 @@ relation_arrow_set_property (GObject      *object,
 	}
 }
 
-static void
-relation_arrow_update_line_segments (PlannerRelationArrow *arrow)
+/* Routes the arrow from the current geometry of its rows. Called from the
+ * chart's batched arrow layout pass, see planner_gantt_chart_queue_arrow().
+ */
+void
+planner_relation_arrow_update (PlannerRelationArrow *arrow)
 {
 	PlannerRelationArrowPriv *priv;
 	gdouble                   px1, py1, px2, py2;
 	gdouble                   sx1, sy1, sx2, sy2;
 	gdouble                   y;
 	MrpRelationType           type;
+	PlannerPoint              old_points[6];
+	guint                     old_num_points;
+	PlannerArrowDir           old_arrow_dir;
+
+	g_return_if_fail (PLANNER_IS_RELATION_ARROW (arrow));
 
 	priv = arrow->priv;
 	type = priv->type;
 
+	if (priv->predecessor == NULL || priv->successor == NULL) {
+		return;
+	}
+
+	old_num_points = priv->num_points;
+	old_arrow_dir = priv->arrow_dir;
+	memcpy (old_points, priv->points, sizeof (old_points));
+
 	planner_gantt_row_get_geometry (priv->predecessor,
 					&px1,
 					&py1,
@@ -449,9 +465,75 @@ relation_arrow_update_line_segments (PlannerRelationArrow *arrow)
 	}
 	}
 
+	/* Rows emit geometry-changed for every reflow, only redraw the arrows
+	 * whose route actually moved.
+	 */
+	if (old_num_points == priv->num_points &&
+	    old_arrow_dir == priv->arrow_dir &&
+	    memcmp (old_points, priv->points,
+		    sizeof (PlannerPoint) * priv->num_points) == 0) {
+		return;
+	}
+
 	gnome_canvas_item_request_update (GNOME_CANVAS_ITEM (arrow));
 }
 
+/* Returns the area the arrow will cover once routed, in world coordinates.
+ * Returns FALSE if the arrow is hidden or lost one of its rows, in which
+ * case there is nothing to route.
+ */
+gboolean
+planner_relation_arrow_get_extents (PlannerRelationArrow *arrow,
+				    gdouble              *x1,
+				    gdouble              *y1,
+				    gdouble              *x2,
+				    gdouble              *y2)
+{
+	PlannerRelationArrowPriv *priv;
+	gdouble                   px1, py1, px2, py2;
+	gdouble                   sx1, sy1, sx2, sy2;
+
+	g_return_val_if_fail (PLANNER_IS_RELATION_ARROW (arrow), FALSE);
+
+	priv = arrow->priv;
+
+	if (priv->predecessor == NULL || priv->successor == NULL ||
+	    !priv->predecessor_visible || !priv->successor_visible) {
+		return FALSE;
+	}
+
+	planner_gantt_row_get_geometry (priv->predecessor,
+					&px1, &py1, &px2, &py2);
+	planner_gantt_row_get_geometry (priv->successor,
+					&sx1, &sy1, &sx2, &sy2);
+
+	/* The routes never leave the rows by more than this, see the
+	 * drawings at the top of the file.
+	 */
+	*x1 = MIN (px1, sx1) - MIN_SPACING - ARROW_SIZE;
+	*x2 = MAX (px2, sx2) + MIN_SPACING + ARROW_SIZE;
+	*y1 = MIN (py1, sy1) - (py2 - py1) / 2;
+	*y2 = MAX (py2, sy2) + (py2 - py1) / 2;
+
+	return TRUE;
+}
+
+static void
+relation_arrow_queue_update (PlannerRelationArrow *arrow)
+{
+	GnomeCanvasItem   *item;
+	PlannerGanttChart *chart;
+
+	item = GNOME_CANVAS_ITEM (arrow);
+
+	chart = g_object_get_data (G_OBJECT (item->canvas), "chart");
+	if (chart) {
+		planner_gantt_chart_queue_arrow (chart, arrow);
+	} else {
+		planner_relation_arrow_update (arrow);
+	}
+}
+
 static void
 relation_arrow_geometry_changed (PlannerGanttRow      *row,
 				 gdouble               x1,
@@ -460,7 +542,7 @@ relation_arrow_geometry_changed (PlannerGanttRow      *row,
 				 gdouble               y2,
 				 PlannerRelationArrow *arrow)
 {
-	relation_arrow_update_line_segments (arrow);
+	relation_arrow_queue_update (arrow);
 }
 
 static void
@@ -473,6 +555,8 @@ relation_arrow_successor_visibility_changed (PlannerGanttRow      *row,
 	if (!visible) {
 		gnome_canvas_item_hide (GNOME_CANVAS_ITEM (arrow));
 	} else if (arrow->priv->predecessor_visible) {
+		/* Hidden arrows are not routed, catch up before showing. */
+		relation_arrow_queue_update (arrow);
 		gnome_canvas_item_show (GNOME_CANVAS_ITEM (arrow));
 	}
 }
@@ -487,6 +571,7 @@ relation_arrow_predecessor_visibility_changed (PlannerGanttRow      *row,
 	if (!visible) {
 		gnome_canvas_item_hide (GNOME_CANVAS_ITEM (arrow));
 	} else if (arrow->priv->successor_visible) {
+		relation_arrow_queue_update (arrow);
 		gnome_canvas_item_show (GNOME_CANVAS_ITEM (arrow));
 	}
 }
@@ -525,7 +610,7 @@ planner_relation_arrow_set_predecessor (PlannerRelationArrow *arrow,
 				 0);
 
 	if (priv->predecessor != NULL && priv->successor != NULL) {
-		relation_arrow_update_line_segments (arrow);
+		relation_arrow_queue_update (arrow);
 	}
 }
 
@@ -562,7 +647,7 @@ planner_relation_arrow_set_successor (PlannerRelationArrow *arrow,
 				 0);
 
 	if (priv->predecessor != NULL && priv->successor != NULL) {
-		relation_arrow_update_line_segments (arrow);
+		relation_arrow_queue_update (arrow);
 	}
 }
 
@@ -821,16 +906,4 @@ relation_arrow_draw (GnomeCanvasItem *item,
 	g_object_unref (gc);
 }
 
-static double
-relation_arrow_point (GnomeCanvasItem  *item,
-		      gdouble           x,
-		      gdouble           y,
-		      gint              cx,
-		      gint              cy,
-		      GnomeCanvasItem **actual_item)
-{
-	*actual_item = item;
-
-	return 10.0;
-}
 
@@ -60,6 +60,14 @@ planner_relation_arrow_set_successor             (PlannerRelationArrow *arrow,
 void
 planner_relation_arrow_set_predecessor           (PlannerRelationArrow *arrow,
 					     PlannerGanttRow      *predecessor);
+void
+planner_relation_arrow_update                    (PlannerRelationArrow *arrow);
+gboolean
+planner_relation_arrow_get_extents               (PlannerRelationArrow *arrow,
+					     gdouble              *x1,
+					     gdouble              *y1,
+					     gdouble              *x2,
+					     gdouble              *y2);
 
 
 #endif /* __PLANNER_RELATION_ARROW_H__ */
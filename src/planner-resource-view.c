@@ -2196,14 +2196,10 @@ resource_view_name_data_func (GtkTreeViewColumn    *tree_column,
 			      gpointer              data)
 {
 	MrpResource *resource;
-	gchar       *name;
 
 	gtk_tree_model_get (tree_model, iter, COL_RESOURCE, &resource, -1);
 
-	g_object_get (resource, "name", &name, NULL);
-
-	g_object_set (cell, "text", name, NULL);
-	g_free (name);
+	g_object_set (cell, "text", mrp_resource_get_name (resource), NULL);
 }
 
 static void
@@ -2218,7 +2214,7 @@ resource_view_type_data_func (GtkTreeViewColumn    *tree_column,
 
 	gtk_tree_model_get (tree_model, iter, COL_RESOURCE, &resource, -1);
 
-	g_object_get (resource, "type", &type, NULL);
+	type = mrp_resource_get_resource_type (resource);
 
 	g_object_set (cell,
 		      "text", resource_view_get_type_string (type),
@@ -2234,21 +2230,17 @@ resource_view_group_data_func (GtkTreeViewColumn    *tree_column,
 {
 	MrpResource *resource;
 	MrpGroup    *group;
-	gchar       *name;
 
 	gtk_tree_model_get (tree_model, iter, COL_RESOURCE, &resource, -1);
 
-	g_object_get (resource, "group", &group, NULL);
+	group = mrp_resource_get_group (resource);
 
 	if (!group) {
 		g_object_set (cell, "text", "", NULL);
 		return;
 	}
 
-	g_object_get (group, "name", &name, NULL);
-	g_object_set (cell, "text", name, NULL);
-
-	g_free (name);
+	g_object_set (cell, "text", mrp_group_get_name (group), NULL);
 }
 
 static void
@@ -2259,14 +2251,10 @@ resource_view_short_name_data_func (GtkTreeViewColumn    *tree_column,
 			       gpointer              data)
 {
 	MrpResource *resource;
-	gchar       *short_name;
 
 	gtk_tree_model_get (tree_model, iter, COL_RESOURCE, &resource, -1);
 
-	g_object_get (resource, "short_name", &short_name, NULL);
-
-	g_object_set (cell, "text", short_name, NULL);
-	g_free (short_name);
+	g_object_set (cell, "text", mrp_resource_get_short_name (resource), NULL);
 }
 
 static void
@@ -2277,14 +2265,10 @@ resource_view_email_data_func (GtkTreeViewColumn    *tree_column,
 			       gpointer              data)
 {
 	MrpResource *resource;
-	gchar       *email;
 
 	gtk_tree_model_get (tree_model, iter, COL_RESOURCE, &resource, -1);
 
-	g_object_get (resource, "email", &email, NULL);
-
-	g_object_set (cell, "text", email, NULL);
-	g_free (email);
+	g_object_set (cell, "text", mrp_resource_get_email (resource), NULL);
 }
 
 static void
@@ -2300,7 +2284,7 @@ resource_view_cost_data_func (GtkTreeViewColumn    *tree_column,
 
 	gtk_tree_model_get (tree_model, iter, COL_RESOURCE, &resource, -1);
 
-	g_object_get (resource, "cost", &cost, NULL);
+	cost = mrp_resource_get_cost (resource);
 	cost_text = planner_format_float (cost, 2, FALSE);
 
 	g_object_set (cell, "text", cost_text, NULL);
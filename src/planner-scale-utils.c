@@ -32,93 +32,135 @@
 #define HOUR    (60*60)
 
 static const PlannerScaleConf scale_conf[] = {
-	/* Major unit                  Major format                   Minor unit                     Minor format */
+	/* Major unit                  Major format                   Minor unit                     Minor format                 Nonworking  Detail */
 
-	{ MRP_TIME_UNIT_YEAR,     PLANNER_SCALE_FORMAT_MEDIUM,   MRP_TIME_UNIT_HALFYEAR,   PLANNER_SCALE_FORMAT_SHORT,  WEEK },
+	{ MRP_TIME_UNIT_YEAR,     PLANNER_SCALE_FORMAT_MEDIUM,   MRP_TIME_UNIT_HALFYEAR,   PLANNER_SCALE_FORMAT_SHORT,  WEEK,    PLANNER_SCALE_DETAIL_OVERVIEW },
 
-	{ MRP_TIME_UNIT_YEAR,     PLANNER_SCALE_FORMAT_MEDIUM,   MRP_TIME_UNIT_HALFYEAR,   PLANNER_SCALE_FORMAT_SHORT,  WEEK },
-	{ MRP_TIME_UNIT_YEAR,     PLANNER_SCALE_FORMAT_MEDIUM,   MRP_TIME_UNIT_QUARTER,    PLANNER_SCALE_FORMAT_SHORT,  WEEK },
-	{ MRP_TIME_UNIT_YEAR,     PLANNER_SCALE_FORMAT_MEDIUM,   MRP_TIME_UNIT_QUARTER,    PLANNER_SCALE_FORMAT_MEDIUM, WEEK },
+	{ MRP_TIME_UNIT_YEAR,     PLANNER_SCALE_FORMAT_MEDIUM,   MRP_TIME_UNIT_HALFYEAR,   PLANNER_SCALE_FORMAT_SHORT,  WEEK,    PLANNER_SCALE_DETAIL_OVERVIEW },
+	{ MRP_TIME_UNIT_YEAR,     PLANNER_SCALE_FORMAT_MEDIUM,   MRP_TIME_UNIT_QUARTER,    PLANNER_SCALE_FORMAT_SHORT,  WEEK,    PLANNER_SCALE_DETAIL_OVERVIEW },
+	{ MRP_TIME_UNIT_YEAR,     PLANNER_SCALE_FORMAT_MEDIUM,   MRP_TIME_UNIT_QUARTER,    PLANNER_SCALE_FORMAT_MEDIUM, WEEK,    PLANNER_SCALE_DETAIL_OVERVIEW },
 
-	{ MRP_TIME_UNIT_HALFYEAR, PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_MONTH,      PLANNER_SCALE_FORMAT_LONG,   WEEK },
+	{ MRP_TIME_UNIT_HALFYEAR, PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_MONTH,      PLANNER_SCALE_FORMAT_LONG,   WEEK,    PLANNER_SCALE_DETAIL_BARS },
 
-	{ MRP_TIME_UNIT_QUARTER,  PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_MONTH,      PLANNER_SCALE_FORMAT_MEDIUM, DAY },
+	{ MRP_TIME_UNIT_QUARTER,  PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_MONTH,      PLANNER_SCALE_FORMAT_MEDIUM, DAY,     PLANNER_SCALE_DETAIL_BARS },
 
-	{ MRP_TIME_UNIT_MONTH,    PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_WEEK,       PLANNER_SCALE_FORMAT_MEDIUM, DAY },
+	{ MRP_TIME_UNIT_MONTH,    PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_WEEK,       PLANNER_SCALE_FORMAT_MEDIUM, DAY,     PLANNER_SCALE_DETAIL_FULL },
 
-	{ MRP_TIME_UNIT_WEEK,     PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_DAY,        PLANNER_SCALE_FORMAT_SHORT,  DAY },
-	{ MRP_TIME_UNIT_WEEK,     PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_DAY,        PLANNER_SCALE_FORMAT_MEDIUM, HALFDAY },
+	{ MRP_TIME_UNIT_WEEK,     PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_DAY,        PLANNER_SCALE_FORMAT_SHORT,  DAY,     PLANNER_SCALE_DETAIL_FULL },
+	{ MRP_TIME_UNIT_WEEK,     PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_DAY,        PLANNER_SCALE_FORMAT_MEDIUM, HALFDAY, PLANNER_SCALE_DETAIL_FULL },
 
-	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_HALFDAY,    PLANNER_SCALE_FORMAT_MEDIUM, HALFDAY },
-	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_HALFDAY,    PLANNER_SCALE_FORMAT_MEDIUM, HOUR },
+	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_HALFDAY,    PLANNER_SCALE_FORMAT_MEDIUM, HALFDAY, PLANNER_SCALE_DETAIL_FULL },
+	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_HALFDAY,    PLANNER_SCALE_FORMAT_MEDIUM, HOUR,    PLANNER_SCALE_DETAIL_FULL },
 
-	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_TWO_HOURS,  PLANNER_SCALE_FORMAT_MEDIUM, HOUR },
+	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_TWO_HOURS,  PLANNER_SCALE_FORMAT_MEDIUM, HOUR,    PLANNER_SCALE_DETAIL_FULL },
 
-	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_HOUR,       PLANNER_SCALE_FORMAT_MEDIUM, HOUR },
-	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_HOUR,       PLANNER_SCALE_FORMAT_MEDIUM, HOUR }
+	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_HOUR,       PLANNER_SCALE_FORMAT_MEDIUM, HOUR,    PLANNER_SCALE_DETAIL_FULL },
+	{ MRP_TIME_UNIT_DAY,      PLANNER_SCALE_FORMAT_LONG,     MRP_TIME_UNIT_HOUR,       PLANNER_SCALE_FORMAT_MEDIUM, HOUR,    PLANNER_SCALE_DETAIL_FULL }
 };
 
 const PlannerScaleConf *planner_scale_conf = scale_conf;
 
 
-gchar *
-planner_scale_format_time (mrptime            t,
-			   MrpTimeUnit        unit,
-			   PlannerScaleFormat format)
+/* The labels that don't need translating are rendered from formats
+ * that are compiled once, see mrp_time_format_new().
+ */
+enum {
+	SCALE_TEMPLATE_HOUR,
+	SCALE_TEMPLATE_DAY_SHORT,
+	SCALE_TEMPLATE_DAY_MEDIUM,
+	SCALE_TEMPLATE_DAY_LONG,
+	SCALE_TEMPLATE_MONTH_MEDIUM,
+	SCALE_TEMPLATE_MONTH_LONG,
+	SCALE_TEMPLATE_YEAR,
+	SCALE_NUM_TEMPLATES
+};
+
+static const gchar *scale_templates[SCALE_NUM_TEMPLATES] = {
+	"%k",
+	"%e",
+	"%a %e",
+	"%a, %b %e",
+	"%b",
+	"%b %Y",
+	"%Y"
+};
+
+static MrpTimeFormat *scale_formats[SCALE_NUM_TEMPLATES];
+
+static gint
+scale_render (gint    which,
+	      mrptime t,
+	      gchar  *buf,
+	      gint    size)
+{
+	if (!scale_formats[which]) {
+		scale_formats[which] = mrp_time_format_new (scale_templates[which]);
+	}
+
+	return mrp_time_format_render (scale_formats[which], t, buf, size);
+}
+
+/* The ISO 8601 week and the year it belongs to, which is the year of its
+ * Thursday.
+ */
+static gint
+scale_get_week (mrptime t, gint *year)
+{
+	mrptime thursday;
+	gint    dow;
+
+	if (year) {
+		/* Days since Monday. */
+		dow = (mrp_time_day_of_week (t) + 6) % 7;
+		thursday = t + (3 - dow) * DAY;
+
+		mrp_time_decompose (thursday, year, NULL, NULL, NULL, NULL, NULL);
+	}
+
+	return mrp_time_week_number (t);
+}
+
+/**
+ * planner_scale_format_time_buf:
+ * @t: the start of the scale interval
+ * @unit: the scale unit
+ * @format: how long the label may be
+ * @buf: buffer to write the label to
+ * @size: size of @buf
+ *
+ * Like planner_scale_format_time() but writes the label into @buf, which
+ * is always nul-terminated, instead of allocating it.
+ *
+ * Return value: The length of the label, like snprintf().
+ **/
+gint
+planner_scale_format_time_buf (mrptime            t,
+			       MrpTimeUnit        unit,
+			       PlannerScaleFormat format,
+			       gchar             *buf,
+			       gint               size)
 {
-	MrpTime *t2;
-	gchar   *str = NULL;
-	gint     num;
-	gint     year, month, week, day;
-	gint     hour, min, sec;
+	gint num;
+	gint year, month, week;
 
-	t2 = mrp_time2_new ();
-	mrp_time2_set_epoch (t2, t);
+	g_return_val_if_fail (buf != NULL && size > 0, 0);
 
-	mrp_time2_get_date (t2, &year, &month, &day);
-	mrp_time2_get_time (t2, &hour, &min, &sec);
+	buf[0] = '\0';
 
 	switch (unit) {
 	case MRP_TIME_UNIT_HOUR:
-		switch (format) {
-		default:
-			str = g_strdup_printf ("%d", hour);
-			break;
-		}
-		break;
-
 	case MRP_TIME_UNIT_TWO_HOURS:
-		switch (format) {
-		default:
-			str = g_strdup_printf ("%d", hour);
-			break;
-		}
-		break;
-
 	case MRP_TIME_UNIT_HALFDAY:
-		switch (format) {
-		default:
-			str = g_strdup_printf ("%d", hour);
-			break;
-		}
-		break;
+		return scale_render (SCALE_TEMPLATE_HOUR, t, buf, size);
 
 	case MRP_TIME_UNIT_DAY:
 		switch (format) {
 		case PLANNER_SCALE_FORMAT_SHORT:
-			str = g_strdup_printf ("%d", day);
-			break;
+			return scale_render (SCALE_TEMPLATE_DAY_SHORT, t, buf, size);
 		case PLANNER_SCALE_FORMAT_MEDIUM:
-			str = g_strdup_printf ("%s %d",
-					       mrp_time2_get_day_name (t2),
-					       day);
-			break;
+			return scale_render (SCALE_TEMPLATE_DAY_MEDIUM, t, buf, size);
 		case PLANNER_SCALE_FORMAT_LONG:
-			str = g_strdup_printf ("%s, %s %d",
-					       mrp_time2_get_day_name (t2),
-					       mrp_time2_get_month_name (t2),
-					       day);
-			break;
+			return scale_render (SCALE_TEMPLATE_DAY_LONG, t, buf, size);
 		}
 		break;
 
@@ -126,90 +168,72 @@ planner_scale_format_time (mrptime            t,
 		switch (format) {
 		case PLANNER_SCALE_FORMAT_SHORT:
 			/* i18n: Short "Week", preferably 2 letters. */
-			str = g_strdup_printf (_("Wk %d"),
-					       mrp_time2_get_week_number (t2, NULL));
-			break;
+			return g_snprintf (buf, size, _("Wk %d"),
+					   scale_get_week (t, NULL));
 		case PLANNER_SCALE_FORMAT_MEDIUM:
-			str = g_strdup_printf (_("Week %d"),
-					       mrp_time2_get_week_number (t2, NULL));
-			break;
+			return g_snprintf (buf, size, _("Week %d"),
+					   scale_get_week (t, NULL));
 		case PLANNER_SCALE_FORMAT_LONG:
 			/* i18n: Week, year. */
-			week = mrp_time2_get_week_number (t2, &year),
-			str = g_strdup_printf (_("Week %d, %d"),
-					       week,
-					       year);
-			break;
+			week = scale_get_week (t, &year);
+			return g_snprintf (buf, size, _("Week %d, %d"),
+					   week,
+					   year);
 		}
 		break;
 
 	case MRP_TIME_UNIT_MONTH:
 		switch (format) {
 		case PLANNER_SCALE_FORMAT_SHORT:
-			str = g_strdup_printf ("%s",
-					       mrp_time2_get_month_initial (t2));
-			break;
+			return g_snprintf (buf, size, "%s",
+					   mrp_time_month_name_initial (t));
 		case PLANNER_SCALE_FORMAT_MEDIUM:
-			str = g_strdup_printf ("%s",
-					       mrp_time2_get_month_name (t2));
-			break;
+			return scale_render (SCALE_TEMPLATE_MONTH_MEDIUM, t, buf, size);
 		case PLANNER_SCALE_FORMAT_LONG:
-			str = g_strdup_printf ("%s %d",
-					       mrp_time2_get_month_name (t2),
-					       year);
-			break;
+			return scale_render (SCALE_TEMPLATE_MONTH_LONG, t, buf, size);
 		}
 		break;
 
 	case MRP_TIME_UNIT_QUARTER:
+		mrp_time_decompose (t, &year, &month, NULL, NULL, NULL, NULL);
 		num = 1 + floor (month / 3);
 
 		switch (format) {
 		case PLANNER_SCALE_FORMAT_SHORT:
 			/* i18n: Short "Quarter", preferably 1 letter. */
-			str = g_strdup_printf (_("Q%d"), num);
-			break;
+			return g_snprintf (buf, size, _("Q%d"), num);
 		case PLANNER_SCALE_FORMAT_MEDIUM:
 			/* i18n: Short "Quarter", preferably 2-3 letters. */
-			str = g_strdup_printf (_("Qtr %d"), num);
-			break;
+			return g_snprintf (buf, size, _("Qtr %d"), num);
 		case PLANNER_SCALE_FORMAT_LONG:
 			/* i18n: Year, short "Quarter", preferably 2-3 letters. */
-			str = g_strdup_printf (_("%d, Qtr %d"),
-					       year,
-					       num);
-			break;
+			return g_snprintf (buf, size, _("%d, Qtr %d"),
+					   year,
+					   num);
 		}
 		break;
 
 	case MRP_TIME_UNIT_HALFYEAR:
+		mrp_time_decompose (t, &year, &month, NULL, NULL, NULL, NULL);
 		num = 1 + floor (month / 6);
 
 		switch (format) {
 		case PLANNER_SCALE_FORMAT_SHORT:
 			/* i18n: Short "Half year", preferably 1 letter. */
-			str = g_strdup_printf (_("H%d"), num);
-			break;
+			return g_snprintf (buf, size, _("H%d"), num);
 		case PLANNER_SCALE_FORMAT_MEDIUM:
 		case PLANNER_SCALE_FORMAT_LONG:
 			/* i18n: Year, short "Half year", preferably 1 letter. */
-			str = g_strdup_printf (_("%04d, H%d"),
-					       year,
-					       num);
-			break;
+			return g_snprintf (buf, size, _("%04d, H%d"),
+					   year,
+					   num);
 		}
 		break;
 
 	case MRP_TIME_UNIT_YEAR:
-		switch (format) {
-		default:
-			str = g_strdup_printf ("%d", year);
-			break;
-		}
-		break;
+		return scale_render (SCALE_TEMPLATE_YEAR, t, buf, size);
 
 	case MRP_TIME_UNIT_NONE:
-		str = NULL;
 		break;
 
 	default:
@@ -217,9 +241,23 @@ planner_scale_format_time (mrptime            t,
 		break;
 	}
 
-	mrp_time2_free (t2);
+	return 0;
+}
+
+gchar *
+planner_scale_format_time (mrptime            t,
+			   MrpTimeUnit        unit,
+			   PlannerScaleFormat format)
+{
+	gchar buf[128];
+
+	if (unit == MRP_TIME_UNIT_NONE) {
+		return NULL;
+	}
+
+	planner_scale_format_time_buf (t, unit, format, buf, sizeof (buf));
 
-	return str;
+	return g_strdup (buf);
 }
 
 gint
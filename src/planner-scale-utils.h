@@ -46,6 +46,13 @@ typedef enum {
 	PLANNER_SCALE_FORMAT_LONG
 } PlannerScaleFormat;
 
+/* How much of a gantt row we draw at a zoom level. */
+typedef enum {
+	PLANNER_SCALE_DETAIL_FULL,     /* Work/units slices, nonstandard days, labels. */
+	PLANNER_SCALE_DETAIL_BARS,     /* Plain bars and labels. */
+	PLANNER_SCALE_DETAIL_OVERVIEW  /* Plain bars only, no labels. */
+} PlannerScaleDetail;
+
 typedef struct {
 	MrpTimeUnit        major_unit;
 	PlannerScaleFormat major_format;
@@ -55,6 +62,8 @@ typedef struct {
 
 	/* Nonworking intervals shorter than this is not drawn (seconds). */
 	gint               nonworking_limit;
+
+	PlannerScaleDetail detail;
 } PlannerScaleConf;
 
 extern const PlannerScaleConf *planner_scale_conf;
@@ -62,6 +71,11 @@ extern const PlannerScaleConf *planner_scale_conf;
 gchar * planner_scale_format_time (mrptime            t,
 				   MrpTimeUnit   unit,
 				   PlannerScaleFormat format);
+gint    planner_scale_format_time_buf (mrptime            t,
+				       MrpTimeUnit        unit,
+				       PlannerScaleFormat format,
+				       gchar             *buf,
+				       gint               size);
 gint    planner_scale_clamp_zoom  (gdouble            zoom);
 
 
@@ -0,0 +1,445 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <config.h>
+#include <string.h>
+#include <libplanner/mrp-assignment.h>
+#include <libplanner/mrp-resource.h>
+#include "planner-task-clipboard.h"
+
+/* A copied set of task subtrees, kept as flat arrays with the tasks in pre
+ * order. Relations and assignments refer to tasks by their index in the
+ * array, so pasting only needs an array of new tasks to remap them, and the
+ * copy doesn't hold on to any tasks of the project it was taken from.
+ */
+
+typedef struct {
+	/* Index of the parent task, -1 for the roots of the copied subtrees. */
+	gint           parent;
+
+	gchar         *name;
+	gchar         *note;
+	MrpTaskType    type;
+	MrpTaskSched   sched;
+	gint           work;
+	gint           duration;
+	gint           percent_complete;
+	gint           priority;
+	MrpConstraint  constraint;
+} ClipboardTask;
+
+typedef struct {
+	gint            predecessor;
+	gint            successor;
+	MrpRelationType type;
+	glong           lag;
+} ClipboardRelation;
+
+typedef struct {
+	gint         task;
+	MrpResource *resource;
+	gint         units;
+} ClipboardAssignment;
+
+struct _PlannerTaskClipboard {
+	gint    ref_count;
+
+	GArray *tasks;
+	GArray *relations;
+	GArray *assignments;
+};
+
+static void
+task_clipboard_copy_subtree (PlannerTaskClipboard *clipboard,
+			     MrpTask              *task,
+			     gint                  parent,
+			     GHashTable           *indices,
+			     GPtrArray            *copied)
+{
+	ClipboardTask  ct;
+	MrpConstraint *constraint;
+	MrpTask       *child;
+	gint           index;
+
+	memset (&ct, 0, sizeof (ct));
+
+	ct.parent = parent;
+
+	g_object_get (task,
+		      "name", &ct.name,
+		      "note", &ct.note,
+		      "type", &ct.type,
+		      "sched", &ct.sched,
+		      "work", &ct.work,
+		      "duration", &ct.duration,
+		      "percent_complete", &ct.percent_complete,
+		      "priority", &ct.priority,
+		      "constraint", &constraint,
+		      NULL);
+
+	ct.constraint = *constraint;
+	g_free (constraint);
+
+	index = clipboard->tasks->len;
+
+	g_array_append_val (clipboard->tasks, ct);
+	g_ptr_array_add (copied, task);
+	g_hash_table_insert (indices, task, GINT_TO_POINTER (index + 1));
+
+	for (child = mrp_task_get_first_child (task); child; child = mrp_task_get_next_sibling (child)) {
+		task_clipboard_copy_subtree (clipboard, child, index, indices, copied);
+	}
+}
+
+static gboolean
+task_clipboard_has_selected_ancestor (MrpTask    *task,
+				      GHashTable *selected)
+{
+	MrpTask *parent;
+
+	for (parent = mrp_task_get_parent (task); parent; parent = mrp_task_get_parent (parent)) {
+		if (g_hash_table_lookup (selected, parent)) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/* Copies the subtrees of @tasks, together with the relations between the
+ * copied tasks and their assignments. Tasks whose ancestor is in the list
+ * are copied with it.
+ */
+PlannerTaskClipboard *
+planner_task_clipboard_new (GList *tasks)
+{
+	PlannerTaskClipboard *clipboard;
+	GHashTable           *selected;
+	GHashTable           *indices;
+	GPtrArray            *copied;
+	GList                *l;
+	guint                 i;
+
+	clipboard = g_new0 (PlannerTaskClipboard, 1);
+	clipboard->ref_count = 1;
+
+	clipboard->tasks = g_array_new (FALSE, FALSE, sizeof (ClipboardTask));
+	clipboard->relations = g_array_new (FALSE, FALSE, sizeof (ClipboardRelation));
+	clipboard->assignments = g_array_new (FALSE, FALSE, sizeof (ClipboardAssignment));
+
+	selected = g_hash_table_new (NULL, NULL);
+	for (l = tasks; l; l = l->next) {
+		g_hash_table_insert (selected, l->data, l->data);
+	}
+
+	/* Task -> index + 1, so that 0 means not copied. */
+	indices = g_hash_table_new (NULL, NULL);
+	copied = g_ptr_array_new ();
+
+	for (l = tasks; l; l = l->next) {
+		if (!task_clipboard_has_selected_ancestor (l->data, selected)) {
+			task_clipboard_copy_subtree (clipboard, l->data, -1, indices, copied);
+		}
+	}
+
+	for (i = 0; i < copied->len; i++) {
+		MrpTask *task = g_ptr_array_index (copied, i);
+		GList   *relations;
+
+		relations = mrp_task_get_predecessor_relations (task);
+		for (l = relations; l; l = l->next) {
+			ClipboardRelation cr;
+			MrpRelation      *relation = l->data;
+			gint              predecessor;
+
+			predecessor = GPOINTER_TO_INT (g_hash_table_lookup (
+				indices, mrp_relation_get_predecessor (relation)));
+
+			/* Relations to tasks outside the copy are left out. */
+			if (predecessor == 0) {
+				continue;
+			}
+
+			cr.predecessor = predecessor - 1;
+			cr.successor = i;
+			cr.type = mrp_relation_get_relation_type (relation);
+			cr.lag = mrp_relation_get_lag (relation);
+
+			g_array_append_val (clipboard->relations, cr);
+		}
+
+		for (l = mrp_task_get_assignments (task); l; l = l->next) {
+			ClipboardAssignment ca;
+
+			ca.task = i;
+			ca.resource = g_object_ref (mrp_assignment_get_resource (l->data));
+			ca.units = mrp_assignment_get_units (l->data);
+
+			g_array_append_val (clipboard->assignments, ca);
+		}
+	}
+
+	g_ptr_array_free (copied, TRUE);
+	g_hash_table_destroy (indices);
+	g_hash_table_destroy (selected);
+
+	return clipboard;
+}
+
+PlannerTaskClipboard *
+planner_task_clipboard_ref (PlannerTaskClipboard *clipboard)
+{
+	g_return_val_if_fail (clipboard != NULL, NULL);
+
+	clipboard->ref_count++;
+
+	return clipboard;
+}
+
+void
+planner_task_clipboard_unref (PlannerTaskClipboard *clipboard)
+{
+	guint i;
+
+	g_return_if_fail (clipboard != NULL);
+
+	if (--clipboard->ref_count > 0) {
+		return;
+	}
+
+	for (i = 0; i < clipboard->tasks->len; i++) {
+		ClipboardTask *ct;
+
+		ct = &g_array_index (clipboard->tasks, ClipboardTask, i);
+
+		g_free (ct->name);
+		g_free (ct->note);
+	}
+
+	for (i = 0; i < clipboard->assignments->len; i++) {
+		ClipboardAssignment *ca;
+
+		ca = &g_array_index (clipboard->assignments, ClipboardAssignment, i);
+
+		g_object_unref (ca->resource);
+	}
+
+	g_array_free (clipboard->tasks, TRUE);
+	g_array_free (clipboard->relations, TRUE);
+	g_array_free (clipboard->assignments, TRUE);
+
+	g_free (clipboard);
+}
+
+gint
+planner_task_clipboard_get_n_tasks (PlannerTaskClipboard *clipboard)
+{
+	g_return_val_if_fail (clipboard != NULL, 0);
+
+	return clipboard->tasks->len;
+}
+
+/* Creates new tasks with the properties of the copied ones, in the same
+ * order. They are not inserted in any project.
+ */
+GPtrArray *
+planner_task_clipboard_create_tasks (PlannerTaskClipboard *clipboard)
+{
+	GPtrArray *tasks;
+	guint      i;
+
+	g_return_val_if_fail (clipboard != NULL, NULL);
+
+	tasks = g_ptr_array_sized_new (clipboard->tasks->len);
+
+	for (i = 0; i < clipboard->tasks->len; i++) {
+		ClipboardTask *ct;
+		MrpTask       *task;
+
+		ct = &g_array_index (clipboard->tasks, ClipboardTask, i);
+
+		/* The type goes first since it resets work and duration. */
+		task = g_object_new (MRP_TYPE_TASK,
+				     "type", ct->type,
+				     "sched", ct->sched,
+				     "name", ct->name ? ct->name : "",
+				     "note", ct->note ? ct->note : "",
+				     "work", ct->work,
+				     "duration", ct->duration,
+				     "percent_complete", ct->percent_complete,
+				     "priority", ct->priority,
+				     "constraint", &ct->constraint,
+				     NULL);
+
+		g_ptr_array_add (tasks, task);
+	}
+
+	return tasks;
+}
+
+/* Finds the resource to assign in @project, the copied one if it belongs to
+ * the project, otherwise one with the same name.
+ */
+static MrpResource *
+task_clipboard_map_resource (MrpProject  *project,
+			     MrpResource *resource,
+			     GHashTable  *resources)
+{
+	gpointer     key;
+	gpointer     value;
+	MrpResource *mapped;
+
+	if (g_hash_table_lookup_extended (resources, resource, &key, &value)) {
+		return value;
+	}
+
+	if (g_list_find (mrp_project_get_resources (project), resource)) {
+		mapped = resource;
+	} else {
+		mapped = mrp_project_get_resource_by_name (project,
+							   mrp_resource_get_name (resource));
+	}
+
+	g_hash_table_insert (resources, resource, mapped);
+
+	return mapped;
+}
+
+/* Inserts @tasks, as created by planner_task_clipboard_create_tasks, with
+ * the copied roots at @position under @parent, and recreates the relations
+ * and assignments between them. Scheduling is blocked meanwhile, so the
+ * dependency graph is only rebuilt once, when done.
+ */
+void
+planner_task_clipboard_insert (PlannerTaskClipboard *clipboard,
+			       MrpProject           *project,
+			       MrpTask              *parent,
+			       gint                  position,
+			       GPtrArray            *tasks)
+{
+	GHashTable *resources;
+	gboolean    blocked;
+	guint       i;
+
+	g_return_if_fail (clipboard != NULL);
+	g_return_if_fail (MRP_IS_PROJECT (project));
+	g_return_if_fail (tasks->len == clipboard->tasks->len);
+
+	blocked = mrp_project_get_block_scheduling (project);
+	if (!blocked) {
+		mrp_project_set_block_scheduling (project, TRUE);
+	}
+
+	for (i = 0; i < tasks->len; i++) {
+		ClipboardTask *ct;
+
+		ct = &g_array_index (clipboard->tasks, ClipboardTask, i);
+
+		if (ct->parent == -1) {
+			mrp_project_insert_task (project,
+						 parent,
+						 position,
+						 g_ptr_array_index (tasks, i));
+			if (position != -1) {
+				position++;
+			}
+		} else {
+			mrp_project_insert_task (project,
+						 g_ptr_array_index (tasks, ct->parent),
+						 -1,
+						 g_ptr_array_index (tasks, i));
+		}
+	}
+
+	for (i = 0; i < clipboard->relations->len; i++) {
+		ClipboardRelation *cr;
+		GError            *error = NULL;
+
+		cr = &g_array_index (clipboard->relations, ClipboardRelation, i);
+
+		/* Relations that can't be made in this project, like start to
+		 * finish ones at the project start, are dropped.
+		 */
+		if (!mrp_task_add_predecessor (g_ptr_array_index (tasks, cr->successor),
+					       g_ptr_array_index (tasks, cr->predecessor),
+					       cr->type,
+					       cr->lag,
+					       &error)) {
+			g_clear_error (&error);
+		}
+	}
+
+	resources = g_hash_table_new (NULL, NULL);
+
+	for (i = 0; i < clipboard->assignments->len; i++) {
+		ClipboardAssignment *ca;
+		MrpResource         *resource;
+
+		ca = &g_array_index (clipboard->assignments, ClipboardAssignment, i);
+
+		resource = task_clipboard_map_resource (project, ca->resource, resources);
+		if (resource) {
+			mrp_resource_assign (resource,
+					     g_ptr_array_index (tasks, ca->task),
+					     ca->units);
+		}
+	}
+
+	g_hash_table_destroy (resources);
+
+	if (!blocked) {
+		mrp_project_set_block_scheduling (project, FALSE);
+	}
+}
+
+/* Removes tasks inserted with planner_task_clipboard_insert again. */
+void
+planner_task_clipboard_remove (PlannerTaskClipboard *clipboard,
+			       MrpProject           *project,
+			       GPtrArray            *tasks)
+{
+	gboolean blocked;
+	gint     i;
+
+	g_return_if_fail (clipboard != NULL);
+	g_return_if_fail (MRP_IS_PROJECT (project));
+	g_return_if_fail (tasks->len == clipboard->tasks->len);
+
+	blocked = mrp_project_get_block_scheduling (project);
+	if (!blocked) {
+		mrp_project_set_block_scheduling (project, TRUE);
+	}
+
+	/* Removing a root takes its subtree with it. */
+	for (i = tasks->len - 1; i >= 0; i--) {
+		ClipboardTask *ct;
+
+		ct = &g_array_index (clipboard->tasks, ClipboardTask, i);
+
+		if (ct->parent == -1) {
+			mrp_project_remove_task (project, g_ptr_array_index (tasks, i));
+		}
+	}
+
+	if (!blocked) {
+		mrp_project_set_block_scheduling (project, FALSE);
+	}
+}
@@ -0,0 +1,45 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __PLANNER_TASK_CLIPBOARD_H__
+#define __PLANNER_TASK_CLIPBOARD_H__
+
+#include <glib.h>
+#include <libplanner/mrp-project.h>
+#include <libplanner/mrp-task.h>
+
+typedef struct _PlannerTaskClipboard PlannerTaskClipboard;
+
+PlannerTaskClipboard *planner_task_clipboard_new          (GList                *tasks);
+PlannerTaskClipboard *planner_task_clipboard_ref          (PlannerTaskClipboard *clipboard);
+void                  planner_task_clipboard_unref        (PlannerTaskClipboard *clipboard);
+gint                  planner_task_clipboard_get_n_tasks  (PlannerTaskClipboard *clipboard);
+GPtrArray *           planner_task_clipboard_create_tasks (PlannerTaskClipboard *clipboard);
+void                  planner_task_clipboard_insert       (PlannerTaskClipboard *clipboard,
+							   MrpProject           *project,
+							   MrpTask              *parent,
+							   gint                  position,
+							   GPtrArray            *tasks);
+void                  planner_task_clipboard_remove       (PlannerTaskClipboard *clipboard,
+							   MrpProject           *project,
+							   GPtrArray            *tasks);
+
+#endif /* __PLANNER_TASK_CLIPBOARD_H__ */
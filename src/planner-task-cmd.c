@@ -21,6 +21,7 @@
 
 #include <config.h>
 #include <glib/gi18n.h>
+#include <libplanner/mrp-private.h>
 #include "planner-task-cmd.h"
 #include "planner-task-tree.h"
 
@@ -289,3 +290,110 @@ planner_task_cmd_insert (PlannerWindow  *main_window,
 	return cmd_base;
 }
 
+
+typedef struct {
+	PlannerCmd            base;
+
+	MrpProject           *project;
+	MrpTask              *parent;
+	gint                  position;
+
+	PlannerTaskClipboard *clipboard;
+	GPtrArray            *tasks;	/* The pasted tasks, in clipboard order */
+} TaskCmdPaste;
+
+static gboolean
+task_cmd_paste_do (PlannerCmd *cmd_base)
+{
+	TaskCmdPaste *cmd;
+	guint         i;
+
+	cmd = (TaskCmdPaste *) cmd_base;
+
+	/* Redo inserts the same tasks again, later commands may refer to
+	 * them.
+	 */
+	if (cmd->tasks == NULL) {
+		cmd->tasks = planner_task_clipboard_create_tasks (cmd->clipboard);
+
+		/* Account for the tasks, kept alive while undone. */
+		for (i = 0; i < cmd->tasks->len; i++) {
+			cmd_base->size += sizeof (gpointer) +
+				imrp_task_get_size (g_ptr_array_index (cmd->tasks, i));
+		}
+	}
+
+	planner_task_clipboard_insert (cmd->clipboard,
+				       cmd->project,
+				       cmd->parent,
+				       cmd->position,
+				       cmd->tasks);
+
+	return TRUE;
+}
+
+static void
+task_cmd_paste_undo (PlannerCmd *cmd_base)
+{
+	TaskCmdPaste *cmd;
+
+	cmd = (TaskCmdPaste *) cmd_base;
+
+	planner_task_clipboard_remove (cmd->clipboard,
+				       cmd->project,
+				       cmd->tasks);
+}
+
+static void
+task_cmd_paste_free (PlannerCmd *cmd_base)
+{
+	TaskCmdPaste *cmd;
+
+	cmd = (TaskCmdPaste *) cmd_base;
+
+	if (cmd->tasks != NULL) {
+		g_ptr_array_foreach (cmd->tasks, (GFunc) g_object_unref, NULL);
+		g_ptr_array_free (cmd->tasks, TRUE);
+	}
+
+	planner_task_clipboard_unref (cmd->clipboard);
+
+	if (cmd->parent != NULL) {
+		g_object_unref (cmd->parent);
+	}
+	g_object_unref (cmd->project);
+}
+
+/* Pastes all the copied tasks as one command, so that they are scheduled
+ * once and undone in one step.
+ */
+PlannerCmd *
+planner_task_cmd_paste (PlannerWindow        *main_window,
+			PlannerTaskClipboard *clipboard,
+			MrpTask              *parent,
+			gint                  position)
+{
+	PlannerCmd   *cmd_base;
+	TaskCmdPaste *cmd;
+
+	cmd_base = planner_cmd_new (TaskCmdPaste,
+				    _("Paste tasks"),
+				    task_cmd_paste_do,
+				    task_cmd_paste_undo,
+				    task_cmd_paste_free);
+
+	cmd = (TaskCmdPaste *) cmd_base;
+
+	if (parent != NULL) {
+		cmd->parent = g_object_ref (parent);
+	}
+	cmd->project = g_object_ref (planner_window_get_project (main_window));
+
+	cmd->position = position;
+	cmd->clipboard = planner_task_clipboard_ref (clipboard);
+
+	planner_cmd_manager_insert_and_do (planner_window_get_cmd_manager (main_window),
+					   cmd_base);
+
+	return cmd_base;
+}
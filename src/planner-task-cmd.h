@@ -23,6 +23,7 @@
 
 #include "planner-window.h"
 #include "planner-task-tree.h"
+#include "planner-task-clipboard.h"
 
 PlannerCmd *planner_task_cmd_link          (PlannerWindow    *main_window,
 					    MrpTask          *before,
@@ -38,5 +39,9 @@ PlannerCmd *planner_task_cmd_insert        (PlannerWindow    *main_window,
 					    gint              work,
 					    gint              duration,
 					    MrpTask          *new_task);
+PlannerCmd *planner_task_cmd_paste         (PlannerWindow        *main_window,
+					    PlannerTaskClipboard *clipboard,
+					    MrpTask              *parent,
+					    gint                  position);
 
 #endif /* __PLANNER_TASK_CMD_H__ */
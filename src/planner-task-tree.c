@@ -29,6 +29,7 @@
 #include <gdk/gdkkeysyms.h>
 #include <gtk/gtk.h>
 #include <glib/gi18n.h>
+#include <libplanner/mrp-private.h>
 #include "planner-format.h"
 #include "planner-marshal.h"
 #include "planner-cell-renderer-date.h"
@@ -69,6 +70,9 @@ struct _PlannerTaskTreePriv {
 	 */
 	GHashTable     *task_dialogs;
 	GtkTreePath    *anchor;
+
+	/* The model we froze for the current transaction, if any. */
+	PlannerGanttModel *frozen_model;
 };
 
 typedef struct {
@@ -170,6 +174,10 @@ static void        task_tree_task_added_cb             (PlannerGanttModel    *mo
 static void        task_tree_task_removed_cb           (PlannerGanttModel    *model,
 							MrpTask              *task,
 							PlannerTaskTree      *tree);
+static void        task_tree_transaction_begin_cb      (PlannerCmdManager    *manager,
+							PlannerTaskTree      *tree);
+static void        task_tree_transaction_end_cb        (PlannerCmdManager    *manager,
+							PlannerTaskTree      *tree);
 static MrpProject *task_tree_get_project               (PlannerTaskTree      *tree);
 static MrpTask *   task_tree_get_task_from_path        (PlannerTaskTree      *tree,
                                                         GtkTreePath          *path);
@@ -461,6 +469,28 @@ task_cmd_restore_children (TaskCmdRemove *cmd)
 	}
 }
 
+/* Computes the memory held by a remove command and its saved children, so
+ * that removing large subtrees counts against the undo budget.
+ */
+static gsize
+task_cmd_remove_get_size (TaskCmdRemove *cmd)
+{
+	gsize  size;
+	GList *l;
+
+	/* The removed task is only kept alive by the command. */
+	size = sizeof (TaskCmdRemove) + imrp_task_get_size (cmd->task);
+	size += sizeof (GList) * (g_list_length (cmd->predecessors) +
+				  g_list_length (cmd->successors) +
+				  g_list_length (cmd->assignments));
+
+	for (l = cmd->children; l; l = l->next) {
+		size += sizeof (GList) + task_cmd_remove_get_size (l->data);
+	}
+
+	return size;
+}
+
 static gboolean
 task_cmd_remove_do (PlannerCmd *cmd_base)
 {
@@ -478,6 +508,8 @@ task_cmd_remove_do (PlannerCmd *cmd_base)
 		task_cmd_save_children (cmd);
 	}
 
+	cmd_base->size = task_cmd_remove_get_size (cmd);
+
 	mrp_project_remove_task (cmd->project, cmd->task);
 
 	return TRUE;
@@ -1072,6 +1104,11 @@ task_tree_finalize (GObject *object)
 
 	planner_task_tree_set_anchor (tree, NULL);
 
+	if (priv->frozen_model) {
+		planner_gantt_model_thaw (priv->frozen_model);
+		g_object_unref (priv->frozen_model);
+	}
+
 	g_free (priv);
 
 	if (G_OBJECT_CLASS (parent_class)->finalize) {
@@ -1203,6 +1240,48 @@ task_tree_task_removed_cb (PlannerGanttModel *model,
 	g_object_unref (task);
 }
 
+/* Hold back row updates while a transaction runs, so that the rows of
+ * tasks changed by several of its commands, and by the reschedule at the
+ * end, are only refreshed once.
+ */
+static void
+task_tree_transaction_begin_cb (PlannerCmdManager *manager,
+				PlannerTaskTree   *tree)
+{
+	PlannerTaskTreePriv *priv;
+	GtkTreeModel        *model;
+
+	priv = tree->priv;
+
+	model = gtk_tree_view_get_model (GTK_TREE_VIEW (tree));
+	if (priv->frozen_model || !PLANNER_IS_GANTT_MODEL (model)) {
+		return;
+	}
+
+	priv->frozen_model = g_object_ref (model);
+	planner_gantt_model_freeze (priv->frozen_model);
+}
+
+static void
+task_tree_transaction_end_cb (PlannerCmdManager *manager,
+			      PlannerTaskTree   *tree)
+{
+	PlannerTaskTreePriv *priv;
+	PlannerGanttModel   *model;
+
+	priv = tree->priv;
+
+	if (!priv->frozen_model) {
+		return;
+	}
+
+	model = priv->frozen_model;
+	priv->frozen_model = NULL;
+
+	planner_gantt_model_thaw (model);
+	g_object_unref (model);
+}
+
 static void
 task_tree_tree_view_popup_menu (GtkWidget       *widget,
 				PlannerTaskTree *tree)
@@ -2591,6 +2670,19 @@ planner_task_tree_new (PlannerWindow     *main_window,
 
 	task_tree_setup_tree_view (GTK_TREE_VIEW (tree), project, model);
 
+	/* The window reschedules once at the end of a transaction, see
+	 * window_transaction_end_cb(). It connected first, so its handler
+	 * runs before ours and the rows are refreshed after the reschedule.
+	 */
+	g_signal_connect_object (planner_window_get_cmd_manager (main_window),
+				 "transaction_begin",
+				 G_CALLBACK (task_tree_transaction_begin_cb),
+				 tree, 0);
+	g_signal_connect_object (planner_window_get_cmd_manager (main_window),
+				 "transaction_end",
+				 G_CALLBACK (task_tree_transaction_end_cb),
+				 tree, 0);
+
 	va_start (args, first_column);
 
 	col = first_column;
@@ -2827,6 +2919,83 @@ planner_task_tree_remove_task (PlannerTaskTree *tree)
 	planner_task_tree_set_anchor (tree, NULL);
 }
 
+/* The copied tasks, shared by all windows so that tasks can be pasted into
+ * another project.
+ */
+static PlannerTaskClipboard *task_clipboard = NULL;
+
+void
+planner_task_tree_copy_task (PlannerTaskTree *tree)
+{
+	GList *list;
+
+	g_return_if_fail (PLANNER_IS_TASK_TREE (tree));
+
+	list = planner_task_tree_get_selected_tasks (tree);
+	if (list == NULL) {
+		return;
+	}
+
+	if (task_clipboard) {
+		planner_task_clipboard_unref (task_clipboard);
+	}
+
+	task_clipboard = planner_task_clipboard_new (list);
+
+	g_list_free (list);
+}
+
+void
+planner_task_tree_cut_task (PlannerTaskTree *tree)
+{
+	g_return_if_fail (PLANNER_IS_TASK_TREE (tree));
+
+	planner_task_tree_copy_task (tree);
+	planner_task_tree_remove_task (tree);
+}
+
+void
+planner_task_tree_paste_task (PlannerTaskTree *tree)
+{
+	PlannerTaskTreePriv *priv;
+	MrpTask             *parent;
+	GList               *list;
+	gint                 position;
+
+	g_return_if_fail (PLANNER_IS_TASK_TREE (tree));
+
+	priv = tree->priv;
+
+	if (task_clipboard == NULL ||
+	    planner_task_clipboard_get_n_tasks (task_clipboard) == 0) {
+		return;
+	}
+
+	/* Paste after the selected task, like inserting does. */
+	list = planner_task_tree_get_selected_tasks (tree);
+	if (list == NULL) {
+		parent = NULL;
+		position = -1;
+	} else {
+		parent = mrp_task_get_parent (list->data);
+		position = mrp_task_get_position (list->data) + 1;
+
+		if (mrp_task_get_parent (parent) == NULL) {
+			parent = NULL;
+		}
+	}
+
+	g_list_free (list);
+
+	planner_task_cmd_paste (priv->main_window, task_clipboard, parent, position);
+
+	if (! gtk_widget_has_focus (GTK_WIDGET (tree))) {
+		gtk_widget_grab_focus (GTK_WIDGET (tree));
+	}
+
+	planner_task_tree_set_anchor (tree, NULL);
+}
+
 void
 planner_task_tree_edit_task (PlannerTaskTree *tree, PlannerTaskDialogPage page)
 {
@@ -64,6 +64,9 @@ void         planner_task_tree_set_model              (PlannerTaskTree       *tr
 void         planner_task_tree_insert_subtask         (PlannerTaskTree       *tree);
 void         planner_task_tree_insert_task            (PlannerTaskTree       *tree);
 void         planner_task_tree_remove_task            (PlannerTaskTree       *tree);
+void         planner_task_tree_copy_task              (PlannerTaskTree       *tree);
+void         planner_task_tree_cut_task               (PlannerTaskTree       *tree);
+void         planner_task_tree_paste_task             (PlannerTaskTree       *tree);
 void         planner_task_tree_edit_task              (PlannerTaskTree       *tree,
 						       PlannerTaskDialogPage  page);
 void         planner_task_tree_insert_tasks           (PlannerTaskTree       *tree);
@@ -76,6 +76,12 @@ static void          task_view_insert_tasks_cb              (GtkAction       *ac
 							     gpointer         data);
 static void          task_view_remove_task_cb               (GtkAction       *action,
 							     gpointer         data);
+static void          task_view_cut_task_cb                  (GtkAction       *action,
+							     gpointer         data);
+static void          task_view_copy_task_cb                 (GtkAction       *action,
+							     gpointer         data);
+static void          task_view_paste_task_cb                (GtkAction       *action,
+							     gpointer         data);
 static void          task_view_edit_task_cb                 (GtkAction       *action,
 							     gpointer         data);
 static void          task_view_select_all_cb                (GtkAction       *action,
@@ -125,6 +131,15 @@ static const GtkActionEntry entries[] = {
 	{ "RemoveTask",      "planner-stock-remove-task",      N_("_Remove Task"),
 	  "Delete",           N_("Remove the selected tasks"),
 	  G_CALLBACK (task_view_remove_task_cb) },
+	{ "CutTask",         GTK_STOCK_CUT,                    N_("Cu_t Tasks"),
+	  "",                  N_("Cut the selected tasks"),
+	  G_CALLBACK (task_view_cut_task_cb) },
+	{ "CopyTask",        GTK_STOCK_COPY,                   N_("_Copy Tasks"),
+	  "",                  N_("Copy the selected tasks"),
+	  G_CALLBACK (task_view_copy_task_cb) },
+	{ "PasteTask",       GTK_STOCK_PASTE,                  N_("_Paste Tasks"),
+	  "",                  N_("Paste the copied tasks"),
+	  G_CALLBACK (task_view_paste_task_cb) },
 	{ "EditTask",        NULL,                             N_("_Edit Task"),
 	  "<Control>e",       NULL,
 	  G_CALLBACK (task_view_edit_task_cb) },
@@ -490,6 +505,39 @@ task_view_remove_task_cb (GtkAction *action,
 	planner_task_tree_remove_task (PLANNER_TASK_TREE (view->priv->tree));
 }
 
+static void
+task_view_cut_task_cb (GtkAction *action,
+		       gpointer   data)
+{
+	PlannerTaskView *view;
+
+	view = PLANNER_TASK_VIEW (data);
+
+	planner_task_tree_cut_task (PLANNER_TASK_TREE (view->priv->tree));
+}
+
+static void
+task_view_copy_task_cb (GtkAction *action,
+			gpointer   data)
+{
+	PlannerTaskView *view;
+
+	view = PLANNER_TASK_VIEW (data);
+
+	planner_task_tree_copy_task (PLANNER_TASK_TREE (view->priv->tree));
+}
+
+static void
+task_view_paste_task_cb (GtkAction *action,
+			 gpointer   data)
+{
+	PlannerTaskView *view;
+
+	view = PLANNER_TASK_VIEW (data);
+
+	planner_task_tree_paste_task (PLANNER_TASK_TREE (view->priv->tree));
+}
+
 static void
 task_view_edit_task_cb (GtkAction *action,
 			gpointer   data)
@@ -762,6 +810,12 @@ task_view_update_ui (PlannerView *view)
 	g_object_set (gtk_action_group_get_action (priv->actions, "RemoveTask"),
 		      "sensitive", value,
 		      NULL);
+	g_object_set (gtk_action_group_get_action (priv->actions, "CutTask"),
+		      "sensitive", value,
+		      NULL);
+	g_object_set (gtk_action_group_get_action (priv->actions, "CopyTask"),
+		      "sensitive", value,
+		      NULL);
 	g_object_set (gtk_action_group_get_action (priv->actions, "UnlinkTask"),
 		      "sensitive", rel_value,
 		      NULL);
@@ -0,0 +1,204 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <config.h>
+#include <glib/gi18n.h>
+#include "planner-text-cache.h"
+
+/* Measuring text with Pango means shaping it, which is slow compared to
+ * everything else we do when laying out a gantt or usage row. The same few
+ * strings (resource names, units) are measured for thousands of rows, so we
+ * keep their pixel sizes around, keyed by font and string. The cache is
+ * shared by all windows.
+ */
+
+/* Drop the strings measured for a font when there are more than this. */
+#define MAX_STRINGS_PER_FONT 4096
+
+typedef struct {
+	gint width;
+	gint height;
+} TextSize;
+
+/* PangoFontDescription -> (string -> TextSize) */
+static GHashTable *fonts = NULL;
+
+static GQuark      label_quark = 0;
+static GQuark      watch_quark = 0;
+
+static gboolean
+text_cache_remove_func (gpointer key,
+			gpointer value,
+			gpointer user_data)
+{
+	return TRUE;
+}
+
+static GHashTable *
+text_cache_get_strings (PangoContext *context)
+{
+	PangoFontDescription *font_desc;
+	GHashTable           *strings;
+
+	if (fonts == NULL) {
+		fonts = g_hash_table_new_full ((GHashFunc) pango_font_description_hash,
+					       (GEqualFunc) pango_font_description_equal,
+					       (GDestroyNotify) pango_font_description_free,
+					       (GDestroyNotify) g_hash_table_destroy);
+	}
+
+	font_desc = pango_context_get_font_description (context);
+
+	strings = g_hash_table_lookup (fonts, font_desc);
+	if (strings == NULL) {
+		strings = g_hash_table_new_full (g_str_hash,
+						 g_str_equal,
+						 g_free,
+						 g_free);
+
+		g_hash_table_insert (fonts,
+				     pango_font_description_copy (font_desc),
+				     strings);
+	}
+
+	return strings;
+}
+
+/* Returns the size in pixels the text gets when drawn in a layout created
+ * with gtk_widget_create_pango_layout() for the widget.
+ */
+void
+planner_text_cache_get_pixel_size (GtkWidget   *widget,
+				   const gchar *text,
+				   gint        *width,
+				   gint        *height)
+{
+	PangoContext *context;
+	PangoLayout  *layout;
+	GHashTable   *strings;
+	TextSize     *size;
+
+	g_return_if_fail (GTK_IS_WIDGET (widget));
+
+	if (text == NULL) {
+		text = "";
+	}
+
+	context = gtk_widget_get_pango_context (widget);
+	strings = text_cache_get_strings (context);
+
+	size = g_hash_table_lookup (strings, text);
+	if (size == NULL) {
+		if (g_hash_table_size (strings) >= MAX_STRINGS_PER_FONT) {
+			g_hash_table_foreach_remove (strings,
+						     text_cache_remove_func,
+						     NULL);
+		}
+
+		layout = pango_layout_new (context);
+		pango_layout_set_text (layout, text, -1);
+
+		size = g_new (TextSize, 1);
+		pango_layout_get_pixel_size (layout, &size->width, &size->height);
+
+		g_object_unref (layout);
+
+		g_hash_table_insert (strings, g_strdup (text), size);
+	}
+
+	if (width) {
+		*width = size->width;
+	}
+	if (height) {
+		*height = size->height;
+	}
+}
+
+static void
+text_cache_resource_notify_cb (MrpResource *resource,
+			       GParamSpec  *pspec,
+			       gpointer     user_data)
+{
+	g_object_set_qdata (G_OBJECT (resource), label_quark, NULL);
+}
+
+/* Makes the cached label of the resource follow renames. Rows that read the
+ * label from their own notify handlers must call this before connecting
+ * them, so that the label is cleared before they run.
+ */
+void
+planner_text_cache_watch_resource (MrpResource *resource)
+{
+	g_return_if_fail (MRP_IS_RESOURCE (resource));
+
+	if (label_quark == 0) {
+		label_quark = g_quark_from_static_string ("planner-text-cache-label");
+		watch_quark = g_quark_from_static_string ("planner-text-cache-watched");
+	}
+
+	if (g_object_get_qdata (G_OBJECT (resource), watch_quark)) {
+		return;
+	}
+
+	g_object_set_qdata (G_OBJECT (resource), watch_quark, GINT_TO_POINTER (TRUE));
+
+	g_signal_connect (resource, "notify::name",
+			  G_CALLBACK (text_cache_resource_notify_cb),
+			  NULL);
+	g_signal_connect (resource, "notify::short-name",
+			  G_CALLBACK (text_cache_resource_notify_cb),
+			  NULL);
+}
+
+/* Returns the name used for the resource in chart labels: the short name if
+ * it has one, else the name. The string is kept on the resource until it is
+ * renamed, so that rows sharing a resource don't each need their own copy.
+ */
+const gchar *
+planner_text_cache_get_resource_label (MrpResource *resource)
+{
+	const gchar *name;
+	gchar       *label;
+
+	g_return_val_if_fail (MRP_IS_RESOURCE (resource), NULL);
+
+	planner_text_cache_watch_resource (resource);
+
+	label = g_object_get_qdata (G_OBJECT (resource), label_quark);
+	if (label != NULL) {
+		return label;
+	}
+
+	name = mrp_resource_get_short_name (resource);
+
+	if (!name || name[0] == 0) {
+		name = mrp_resource_get_name (resource);
+	}
+
+	if (!name || name[0] == 0) {
+		name = _("Unnamed");
+	}
+
+	label = g_strdup (name);
+
+	g_object_set_qdata_full (G_OBJECT (resource), label_quark, label, g_free);
+
+	return label;
+}
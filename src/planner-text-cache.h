@@ -0,0 +1,34 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PLANNER_TEXT_CACHE_H__
+#define __PLANNER_TEXT_CACHE_H__
+
+#include <gtk/gtk.h>
+#include <libplanner/mrp-resource.h>
+
+void         planner_text_cache_get_pixel_size  (GtkWidget   *widget,
+						 const gchar *text,
+						 gint        *width,
+						 gint        *height);
+void         planner_text_cache_watch_resource  (MrpResource *resource);
+const gchar *planner_text_cache_get_resource_label (MrpResource *resource);
+
+#endif /* __PLANNER_TEXT_CACHE_H__ */
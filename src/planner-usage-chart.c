@@ -33,6 +33,7 @@
 #include <libplanner/mrp-task.h>
 #include <libplanner/mrp-resource.h>
 #include <libplanner/mrp-assignment.h>
+#include <libplanner/mrp-trace.h>
 #include "planner-marshal.h"
 #include "planner-usage-chart.h"
 #include "planner-gantt-header.h"
@@ -40,6 +41,7 @@
 #include "planner-usage-model.h"
 #include "planner-usage-row.h"
 #include "planner-scale-utils.h"
+#include "planner-perf-hud.h"
 
 /* Padding to the left and right of the contents of the gantt chart. */
 #define PADDING 100.0
@@ -344,6 +346,7 @@ usage_chart_init (PlannerUsageChart * chart)
 
 	/* Easiest way to get access to the chart from the canvas items. */
 	g_object_set_data (G_OBJECT (priv->canvas), "chart", chart);
+	planner_perf_hud_attach (priv->canvas, "usage");
 	gtk_box_pack_start (GTK_BOX (chart),
 			    GTK_WIDGET (priv->canvas), TRUE, TRUE, 0);
 
@@ -808,9 +811,12 @@ usage_chart_reflow_idle (PlannerUsageChart *chart)
 	gdouble                 height, width;
 	gdouble                 bx1, bx2;
 	GtkAllocation           allocation;
+	gint64                  start;
 
 	priv = chart->priv;
 
+	start = mrp_trace_now ();
+
 	if (priv->height_changed || priv->height == -1) {
 		height = usage_chart_reflow_do (chart, priv->tree, 0);
 		priv->height = height;
@@ -858,6 +864,8 @@ usage_chart_reflow_idle (PlannerUsageChart *chart)
 	priv->height_changed = FALSE;
 	priv->reflow_idle_id = 0;
 
+	mrp_trace_complete ("usage-reflow", start, NULL);
+
 	return FALSE;
 }
 
@@ -31,6 +31,7 @@
 #include <libplanner/mrp-project.h>
 #include <libplanner/mrp-resource.h>
 #include <libplanner/mrp-task.h>
+#include <libplanner/mrp-trace.h>
 #include <glib/gi18n.h>
 #include <libgnomecanvas/gnome-canvas.h>
 #include <libgnomecanvas/gnome-canvas-util.h>
@@ -43,6 +44,7 @@
 #include "planner-scale-utils.h"
 #include "planner-usage-chart.h"
 #include "planner-usage-model.h"
+#include "planner-text-cache.h"
 
 /* The padding between the gantt bar and the text. */
 #define TEXT_PADDING 10.0
@@ -110,6 +112,9 @@ struct _PlannerUsageRowPriv {
         gdouble        height;
         gdouble        text_width;
 
+        /* Size of the units label, from the text cache. */
+        gint           label_width;
+
         guint          scroll_timeout_id;
         State          state;
 };
@@ -454,9 +459,7 @@ recalc_bounds (PlannerUsageRow *row)
 	usage_row_ensure_layout (row);
 
 	if (priv->layout != NULL) {
-		pango_layout_get_pixel_size (priv->layout,
-					     &width,
-					     NULL);
+		width = priv->label_width;
 	}
 	else {
 		width = 0;
@@ -703,7 +706,15 @@ usage_row_update_resources (PlannerUsageRow *row)
 
 	units = mrp_assignment_get_units (priv->assignment);
 	units_string = g_strdup_printf ("%i%%", units);
-	pango_layout_set_text (priv->layout, units_string, -1);
+
+	planner_text_cache_get_pixel_size (
+		GTK_WIDGET (GNOME_CANVAS_ITEM (row)->canvas),
+		units_string, &priv->label_width, NULL);
+
+	if (priv->layout != NULL &&
+	    strcmp (pango_layout_get_text (priv->layout), units_string) != 0) {
+		pango_layout_set_text (priv->layout, units_string, -1);
+	}
 
 	g_free (units_string);
 }
@@ -1329,6 +1340,10 @@ usage_row_draw (GnomeCanvasItem *item,
 
         row = PLANNER_USAGE_ROW (item);
 
+	if (mrp_trace_is_enabled ()) {
+		mrp_trace_count (MRP_TRACE_COUNTER_ROWS_DRAWN, 1);
+	}
+
 	if (row->priv->assignment) {
                 usage_row_draw_assignment (row,
                                             row->priv->assignment,
@@ -59,6 +59,9 @@ struct _PlannerWindowPriv {
 
 	PlannerCmdManager   *cmd_manager;
 
+	/* Set while we block scheduling for a transaction. */
+	gboolean             transaction_blocks_scheduling;
+
 	MrpProject          *project;
 
 	GtkWidget           *statusbar;
@@ -75,8 +78,16 @@ struct _PlannerWindowPriv {
 	GList               *views;
 	GList               *plugins;
 	GTimer              *last_saved;
+
+	/* Watches the project file for changes made by other programs. */
+	GFileMonitor        *monitor;
+	guint64              file_mtime;
+	guint                reload_timeout_id;
 };
 
+/* Wait for writes to settle before reloading, in ms. */
+#define RELOAD_DELAY 500
+
 /* Drop targets. */
 enum {
 	TARGET_STRING,
@@ -155,6 +166,10 @@ static void       window_redo_state_changed_cb           (PlannerCmdManager
 							  gboolean                      state,
 							  const gchar                  *label,
 							  PlannerWindow                *window);
+static void       window_transaction_begin_cb            (PlannerCmdManager            *manager,
+							  PlannerWindow                *window);
+static void       window_transaction_end_cb              (PlannerCmdManager            *manager,
+							  PlannerWindow                *window);
 static void       window_drag_data_received_cb           (GtkWidget                    *widget,
 							  GdkDragContext               *context,
 							  int                           x,
@@ -180,6 +195,8 @@ static GtkWidget *window_create_dialog_button            (const gchar
 static void       window_recent_add_item                 (PlannerWindow                *window,
 							  const gchar                  *uri);
 static void       window_save_state                      (PlannerWindow *window);
+static void       window_watch_file                      (PlannerWindow *window);
+static void       window_unwatch_file                    (PlannerWindow *window);
 static void       window_restore_state                   (PlannerWindow *window);
 
 static void window_disconnect_proxy_cb (GtkUIManager  *manager,
@@ -200,6 +217,7 @@ static void window_connect_proxy_cb (GtkUIManager  *manager,
 #define CONF_WINDOW_POS_Y     "/ui/main_window_position_y"
 #define CONF_ACTIVE_VIEW           "/ui/active_view"
 #define CONF_LAST_DIR         "/general/last_dir"
+#define CONF_UNDO_MEMORY      "/general/undo_memory_limit"
 
 #define DEFAULT_WINDOW_WIDTH  800
 #define DEFAULT_WINDOW_HEIGHT 550
@@ -358,6 +376,7 @@ static void
 window_init (PlannerWindow *window)
 {
 	PlannerWindowPriv *priv;
+	gint               undo_memory;
 
 	priv = g_new0 (PlannerWindowPriv, 1);
 	window->priv = priv;
@@ -378,6 +397,13 @@ window_init (PlannerWindow *window)
 
 	priv->cmd_manager = planner_cmd_manager_new ();
 
+	/* The undo memory budget is in kilobytes, unset keeps the default. */
+	undo_memory = planner_conf_get_int (CONF_UNDO_MEMORY, NULL);
+	if (undo_memory > 0) {
+		planner_cmd_manager_set_byte_limit (priv->cmd_manager,
+						    (gsize) undo_memory * 1024);
+	}
+
 	g_signal_connect (priv->cmd_manager,
 			  "undo_state_changed",
 			  G_CALLBACK (window_undo_state_changed_cb),
@@ -387,6 +413,16 @@ window_init (PlannerWindow *window)
 			  "redo_state_changed",
 			  G_CALLBACK (window_redo_state_changed_cb),
 			  window);
+
+	g_signal_connect (priv->cmd_manager,
+			  "transaction_begin",
+			  G_CALLBACK (window_transaction_begin_cb),
+			  window);
+
+	g_signal_connect (priv->cmd_manager,
+			  "transaction_end",
+			  G_CALLBACK (window_transaction_end_cb),
+			  window);
 }
 
 static void
@@ -395,6 +431,8 @@ window_finalize (GObject *object)
 	PlannerWindow     *window = PLANNER_WINDOW (object);
 	PlannerWindowPriv *priv = window->priv;
 
+	window_unwatch_file (window);
+
 	if (priv->last_saved) {
 		g_timer_destroy (priv->last_saved);
 	}
@@ -1027,6 +1065,55 @@ window_print_cb (GtkAction *action,
 	g_object_unref (job);
 }
 
+/**
+ * planner_window_export_pdf:
+ * @window: a #PlannerWindow
+ * @filename: the PDF file to write
+ * @error: location to store error, or %NULL
+ *
+ * Prints all views of the window to @filename without showing any dialog.
+ * Pages are written to the file as they are laid out, so this works for
+ * large projects as well.
+ *
+ * Return value: %TRUE on success.
+ **/
+gboolean
+planner_window_export_pdf (PlannerWindow  *window,
+			   const gchar    *filename,
+			   GError        **error)
+{
+	PlannerWindowPriv       *priv;
+	GtkPrintOperation       *print;
+	GtkPageSetup            *page_setup;
+	PlannerPrintJob         *job;
+	GtkPrintOperationResult  res;
+
+	g_return_val_if_fail (PLANNER_IS_WINDOW (window), FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	priv = window->priv;
+
+	print = gtk_print_operation_new ();
+
+	page_setup = planner_print_dialog_load_page_setup ();
+	gtk_print_operation_set_default_page_setup (print, page_setup);
+	g_object_unref (page_setup);
+
+	gtk_print_operation_set_export_filename (print, filename);
+
+	job = planner_print_job_new (print, priv->views);
+
+	res = gtk_print_operation_run (print,
+				       GTK_PRINT_OPERATION_ACTION_EXPORT,
+				       GTK_WINDOW (window),
+				       error);
+
+	g_object_unref (print);
+	g_object_unref (job);
+
+	return res != GTK_PRINT_OPERATION_RESULT_ERROR;
+}
+
 static void
 window_close_cb (GtkAction *action,
 		 gpointer   data)
@@ -1281,6 +1368,48 @@ window_redo_state_changed_cb (PlannerCmdManager *manager,
 	gtk_label_set_text (GTK_LABEL (label), str);
 }
 
+/* Reschedule once when a transaction is done, instead of once for each of
+ * its commands.
+ */
+static void
+window_transaction_begin_cb (PlannerCmdManager *manager,
+			     PlannerWindow     *window)
+{
+	PlannerWindowPriv *priv;
+
+	priv = window->priv;
+
+	if (!priv->project || priv->transaction_blocks_scheduling) {
+		return;
+	}
+
+	if (mrp_project_get_block_scheduling (priv->project)) {
+		/* Someone else is blocking, leave it to them. */
+		return;
+	}
+
+	priv->transaction_blocks_scheduling = TRUE;
+	mrp_project_set_block_scheduling (priv->project, TRUE);
+}
+
+static void
+window_transaction_end_cb (PlannerCmdManager *manager,
+			   PlannerWindow     *window)
+{
+	PlannerWindowPriv *priv;
+
+	priv = window->priv;
+
+	if (!priv->transaction_blocks_scheduling) {
+		return;
+	}
+
+	priv->transaction_blocks_scheduling = FALSE;
+
+	/* Unblocking does a full recalc. */
+	mrp_project_set_block_scheduling (priv->project, FALSE);
+}
+
 static void
 window_project_needs_saving_changed_cb (MrpProject   *project,
 					gboolean      needs_saving,
@@ -1475,6 +1604,8 @@ window_do_save (PlannerWindow *window, gboolean force)
 
 			return FALSE;
 		}
+
+		window_watch_file (window);
 	}
 
 	return TRUE;
@@ -1556,6 +1687,7 @@ window_do_save_as (PlannerWindow *window)
 		if (success) {
 			/* Add the file to the recent list */
 			window_recent_add_item (window, mrp_project_get_uri (priv->project));
+			window_watch_file (window);
 		} else {
 			GtkWidget *dialog;
 
@@ -1678,6 +1810,8 @@ planner_window_open (PlannerWindow *window,
 
 	planner_window_check_version (window);
 
+	window_watch_file (window);
+
 	if (!internal) {
 		/* Add the file to the recent list */
 		window_recent_add_item (window, uri);
@@ -1932,6 +2066,190 @@ window_recent_add_item (PlannerWindow *window, const gchar *uri)
 	g_slice_free (GtkRecentData, recent_data);
 }
 
+static guint64
+window_get_file_mtime (GFile *file)
+{
+	GFileInfo *info;
+	guint64    mtime;
+
+	info = g_file_query_info (file,
+				  G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+				  G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+				  G_FILE_QUERY_INFO_NONE,
+				  NULL,
+				  NULL);
+	if (!info) {
+		return 0;
+	}
+
+	/* In microseconds, so that writes in the same second differ. */
+	mtime = g_file_info_get_attribute_uint64 (info,
+						  G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+		g_file_info_get_attribute_uint32 (info,
+						  G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+	g_object_unref (info);
+
+	return mtime;
+}
+
+/* Replaces @window with a new one showing the file as it is now, when the
+ * changes can't be applied to the open project. The project has no
+ * unsaved changes, so nothing is lost.
+ */
+static void
+window_reopen (PlannerWindow *window)
+{
+	PlannerWindowPriv *priv;
+	GtkWidget         *new_window;
+	gchar             *uri;
+
+	priv = window->priv;
+
+	uri = g_strdup (mrp_project_get_uri (priv->project));
+
+	new_window = planner_application_new_window (priv->application);
+	if (planner_window_open (PLANNER_WINDOW (new_window), uri, FALSE)) {
+		gtk_widget_show_all (new_window);
+		planner_window_set_status (PLANNER_WINDOW (new_window),
+					   _("The file was changed by another program and has been reloaded."));
+		planner_window_close (window);
+	} else {
+		g_signal_emit (new_window, signals[CLOSED], 0, NULL);
+		gtk_widget_destroy (new_window);
+	}
+
+	g_free (uri);
+}
+
+static gboolean
+window_reload_timeout_cb (PlannerWindow *window)
+{
+	PlannerWindowPriv *priv;
+	GFile             *file;
+	guint64            mtime;
+	GError            *error = NULL;
+
+	priv = window->priv;
+	priv->reload_timeout_id = 0;
+
+	file = g_file_new_for_commandline_arg (mrp_project_get_uri (priv->project));
+	mtime = window_get_file_mtime (file);
+	g_object_unref (file);
+
+	/* Our own save, or nothing changed. */
+	if (mtime == 0 || mtime == priv->file_mtime) {
+		return FALSE;
+	}
+
+	priv->file_mtime = mtime;
+
+	/* Don't throw away the user's changes, saving will ask whether to
+	 * overwrite the file.
+	 */
+	if (mrp_project_needs_saving (priv->project)) {
+		planner_window_set_status (window,
+					   _("The file was changed by another program."));
+		return FALSE;
+	}
+
+	if (!mrp_project_reload (priv->project, &error)) {
+		if (g_error_matches (error, MRP_ERROR, MRP_ERROR_RELOAD_NEEDS_LOAD)) {
+			window_reopen (window);
+		} else {
+			planner_window_set_status (window, error->message);
+		}
+		g_error_free (error);
+		return FALSE;
+	}
+
+	/* The history refers to the objects from before the reload. */
+	planner_cmd_manager_clear (priv->cmd_manager);
+
+	planner_window_set_status (window,
+				   _("The file was changed by another program and has been reloaded."));
+
+	return FALSE;
+}
+
+static void
+window_file_changed_cb (GFileMonitor      *monitor,
+			GFile             *file,
+			GFile             *other_file,
+			GFileMonitorEvent  event,
+			PlannerWindow     *window)
+{
+	PlannerWindowPriv *priv;
+
+	priv = window->priv;
+
+	if (event != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT &&
+	    event != G_FILE_MONITOR_EVENT_CREATED) {
+		return;
+	}
+
+	/* Programs that write in several steps trigger several events. */
+	if (priv->reload_timeout_id) {
+		g_source_remove (priv->reload_timeout_id);
+	}
+
+	priv->reload_timeout_id = g_timeout_add (RELOAD_DELAY,
+						 (GSourceFunc) window_reload_timeout_cb,
+						 window);
+}
+
+/* Starts watching the project file, called after each load and save so
+ * that the file we wrote ourselves is not taken for an outside change.
+ */
+static void
+window_watch_file (PlannerWindow *window)
+{
+	PlannerWindowPriv *priv;
+	const gchar       *uri;
+	GFile             *file;
+
+	priv = window->priv;
+
+	window_unwatch_file (window);
+
+	uri = mrp_project_get_uri (priv->project);
+	if (!uri || strncmp (uri, "sql://", 6) == 0) {
+		return;
+	}
+
+	file = g_file_new_for_commandline_arg (uri);
+
+	priv->file_mtime = window_get_file_mtime (file);
+	priv->monitor = g_file_monitor_file (file, G_FILE_MONITOR_NONE,
+					     NULL, NULL);
+	if (priv->monitor) {
+		g_signal_connect (priv->monitor,
+				  "changed",
+				  G_CALLBACK (window_file_changed_cb),
+				  window);
+	}
+
+	g_object_unref (file);
+}
+
+static void
+window_unwatch_file (PlannerWindow *window)
+{
+	PlannerWindowPriv *priv;
+
+	priv = window->priv;
+
+	if (priv->reload_timeout_id) {
+		g_source_remove (priv->reload_timeout_id);
+		priv->reload_timeout_id = 0;
+	}
+
+	if (priv->monitor) {
+		g_file_monitor_cancel (priv->monitor);
+		g_object_unref (priv->monitor);
+		priv->monitor = NULL;
+	}
+}
+
 PlannerCmdManager *
 planner_window_get_cmd_manager (PlannerWindow *window)
 {
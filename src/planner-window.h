@@ -68,5 +68,8 @@ void                planner_window_show_calendar_dialog    (PlannerWindow      *
 PlannerCmdManager * planner_window_get_cmd_manager         (PlannerWindow      *window);
 void                planner_window_set_status              (PlannerWindow      *window,
 							    const gchar        *message);
+gboolean            planner_window_export_pdf              (PlannerWindow      *window,
+							    const gchar        *filename,
+							    GError            **error);
 
 #endif /* __PLANNER_WINDOW_H__ */
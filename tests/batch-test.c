@@ -0,0 +1,107 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+#include <config.h>
+#include <locale.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include "libplanner/mrp-project.h"
+#include "self-check.h"
+
+static gint
+count_tasks (MrpProject *project)
+{
+	GList *tasks;
+	gint   n;
+
+	tasks = mrp_project_get_all_tasks (project);
+	n = g_list_length (tasks);
+	g_list_free (tasks);
+
+	return n;
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+	MrpApplication *app;
+	MrpProject     *project, *converted;
+	const gchar    *batch;
+	gchar          *example;
+	gchar          *dir;
+	gchar          *filename;
+	gchar          *uri;
+	gchar          *cwd;
+	gchar          *argv_batch[6];
+	gchar          *out = NULL;
+	gint            status;
+
+        g_type_init ();
+
+	/* The command line tools and the application share this. */
+	CHECK_STRING_RESULT (mrp_project_make_uri ("sql://localhost/test"),
+			     "sql://localhost/test");
+	CHECK_STRING_RESULT (mrp_project_make_uri ("/tmp/test.planner"),
+			     "file:///tmp/test.planner");
+
+	cwd = g_get_current_dir ();
+	filename = g_build_filename (cwd, "test.planner", NULL);
+	uri = g_filename_to_uri (filename, NULL, NULL);
+	CHECK_STRING_RESULT (mrp_project_make_uri ("test.planner"), uri);
+	g_free (uri);
+	g_free (filename);
+	g_free (cwd);
+
+	batch = g_getenv ("PLANNER_BATCH");
+	if (!batch) {
+		g_print ("PLANNER_BATCH is not set, skipping.\n");
+		return EXIT_SUCCESS;
+	}
+
+	app = mrp_application_new ();
+
+	example = g_build_filename (EXAMPLESDIR, "test-1.planner", NULL);
+	dir = g_strdup_printf ("%s/planner-batch-test-%d",
+			       g_get_tmp_dir (), (gint) getpid ());
+	g_mkdir (dir, 0755);
+
+	/* Convert the example into the directory, rescheduling it. */
+	argv_batch[0] = (gchar *) batch;
+	argv_batch[1] = "--reschedule";
+	argv_batch[2] = "--output-dir";
+	argv_batch[3] = dir;
+	argv_batch[4] = example;
+	argv_batch[5] = NULL;
+
+	CHECK_BOOLEAN_RESULT (g_spawn_sync (NULL, argv_batch, NULL, 0,
+					    NULL, NULL, &out, NULL,
+					    &status, NULL), TRUE);
+	CHECK_INTEGER_RESULT (status, 0);
+	CHECK_BOOLEAN_RESULT (strstr (out, "\tok\t") != NULL, TRUE);
+	g_free (out);
+
+	/* The result loads and has the same tasks as the input. */
+	filename = g_build_filename (dir, "test-1.planner", NULL);
+	CHECK_BOOLEAN_RESULT (g_file_test (filename, G_FILE_TEST_EXISTS), TRUE);
+
+	project = mrp_project_new (app);
+	CHECK_BOOLEAN_RESULT (mrp_project_load (project, example, NULL), TRUE);
+
+	uri = mrp_project_make_uri (filename);
+	converted = mrp_project_new (app);
+	CHECK_BOOLEAN_RESULT (mrp_project_load (converted, uri, NULL), TRUE);
+	CHECK_INTEGER_RESULT (count_tasks (converted), count_tasks (project));
+
+	g_object_unref (converted);
+	g_object_unref (project);
+
+	g_unlink (filename);
+	g_rmdir (dir);
+
+	g_free (uri);
+	g_free (filename);
+	g_free (dir);
+	g_free (example);
+
+	return EXIT_SUCCESS;
+}
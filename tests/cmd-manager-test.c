@@ -114,10 +114,28 @@ test_cmd (PlannerCmdManager *cmd_manager,
 	return cmd_base;
 }
 
+static void
+transaction_begin_cb (PlannerCmdManager *cmd_manager,
+		      gint              *depth)
+{
+	CHECK_INTEGER_RESULT (*depth % 2, 0);
+	(*depth)++;
+}
+
+static void
+transaction_end_cb (PlannerCmdManager *cmd_manager,
+		    gint              *depth)
+{
+	CHECK_INTEGER_RESULT (*depth % 2, 1);
+	(*depth)++;
+}
+
 gint
 main (gint argc, gchar **argv)
 {
 	ActionHistory action_history;
+	gint          transactions = 0;
+	gsize         cmd_size;
 
         g_type_init ();
 
@@ -175,6 +193,12 @@ main (gint argc, gchar **argv)
 	planner_cmd_manager_redo (cmd_manager);
 	CHECK_STRING_RESULT (g_strdup(action_history.actions), "123");
 
+	/* Count the begin and end signals, which must come in pairs. */
+	g_signal_connect (cmd_manager, "transaction_begin",
+			  G_CALLBACK (transaction_begin_cb), &transactions);
+	g_signal_connect (cmd_manager, "transaction_end",
+			  G_CALLBACK (transaction_end_cb), &transactions);
+
 	/* Test adding some transactions as well as normal commands */
 	planner_cmd_manager_begin_transaction (cmd_manager, "trans 1");
 	test_cmd(cmd_manager, &action_history, 'a');
@@ -197,6 +221,7 @@ main (gint argc, gchar **argv)
 	test_cmd(cmd_manager, &action_history, 'y');
 	planner_cmd_manager_end_transaction (cmd_manager);
 	CHECK_STRING_RESULT (g_strdup(action_history.actions), "123abcdi5xy");
+	CHECK_INTEGER_RESULT (transactions, 3 * 2);
 
 	/* Test undo & redo with a mix of transactions and normal commands */
 	planner_cmd_manager_undo (cmd_manager);
@@ -215,6 +240,45 @@ main (gint argc, gchar **argv)
 	planner_cmd_manager_redo (cmd_manager);
 	CHECK_STRING_RESULT (g_strdup(action_history.actions), "123abcdi");
 
+	/* Undoing and redoing a transaction signals it too, a normal command
+	 * doesn't.
+	 */
+	CHECK_INTEGER_RESULT (transactions, 9 * 2);
+
+	g_object_unref (cmd_manager);
+
+	/* Test that the history is trimmed to the memory budget, always
+	 * keeping the latest operation.
+	 */
+	cmd_manager = planner_cmd_manager_new ();
+	memset(action_history.actions, 0, sizeof(action_history.actions));
+	action_history.next = 0;
+
+	cmd_size = test_cmd(cmd_manager, &action_history, '1')->size;
+	CHECK_BOOLEAN_RESULT (cmd_size >= sizeof (TestCmd), TRUE);
+
+	planner_cmd_manager_set_byte_limit (cmd_manager, 3 * cmd_size);
+	test_cmd(cmd_manager, &action_history, '2');
+	test_cmd(cmd_manager, &action_history, '3');
+	test_cmd(cmd_manager, &action_history, '4');
+	test_cmd(cmd_manager, &action_history, '5');
+	CHECK_STRING_RESULT (g_strdup(action_history.actions), "12345");
+
+	CHECK_BOOLEAN_RESULT (planner_cmd_manager_undo (cmd_manager), TRUE);
+	CHECK_BOOLEAN_RESULT (planner_cmd_manager_undo (cmd_manager), TRUE);
+	CHECK_BOOLEAN_RESULT (planner_cmd_manager_undo (cmd_manager), TRUE);
+	CHECK_BOOLEAN_RESULT (planner_cmd_manager_undo (cmd_manager), FALSE);
+	CHECK_STRING_RESULT (g_strdup(action_history.actions), "12");
+
+	planner_cmd_manager_redo (cmd_manager);
+	CHECK_STRING_RESULT (g_strdup(action_history.actions), "123");
+
+	planner_cmd_manager_set_byte_limit (cmd_manager, 1);
+	test_cmd(cmd_manager, &action_history, '6');
+	CHECK_BOOLEAN_RESULT (planner_cmd_manager_undo (cmd_manager), TRUE);
+	CHECK_BOOLEAN_RESULT (planner_cmd_manager_undo (cmd_manager), FALSE);
+	CHECK_STRING_RESULT (g_strdup(action_history.actions), "123");
+
 	g_object_unref (cmd_manager);
 
 	return EXIT_SUCCESS;
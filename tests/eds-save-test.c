@@ -0,0 +1,152 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+#include <config.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include "libplanner/mrp-project.h"
+#include "eds-backend/e-cal-backend-planner-save.h"
+#include "self-check.h"
+
+/* Long compared to the main loop runs below, so that a slow machine
+ * doesn't make the timeout fire early.
+ */
+#define DELAY       400
+#define MAX_CHANGES 10
+
+static gboolean
+quit_cb (GMainLoop *loop)
+{
+	g_main_loop_quit (loop);
+
+	return FALSE;
+}
+
+static void
+run_main_loop (guint ms)
+{
+	GMainLoop *loop;
+
+	loop = g_main_loop_new (NULL, FALSE);
+	g_timeout_add (ms, (GSourceFunc) quit_cb, loop);
+	g_main_loop_run (loop);
+	g_main_loop_unref (loop);
+}
+
+static MrpTask *
+insert_task (MrpProject *project, const gchar *name)
+{
+	MrpTask *task;
+
+	task = g_object_new (MRP_TYPE_TASK, "name", name, NULL);
+	mrp_project_insert_task (project, NULL, -1, task);
+
+	return task;
+}
+
+/* Loads the saved file into a new project to see what was written. */
+static gboolean
+saved_file_has_task (MrpApplication *app,
+		     const gchar    *filename,
+		     const gchar    *name)
+{
+	MrpProject *project;
+	gboolean    found;
+
+	project = mrp_project_new (app);
+	if (!mrp_project_load (project, filename, NULL)) {
+		g_object_unref (project);
+		return FALSE;
+	}
+
+	found = mrp_project_get_task_by_name (project, name) != NULL;
+	g_object_unref (project);
+
+	return found;
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+	MrpApplication         *app;
+	MrpProject             *project;
+	ECalBackendPlannerSave *save;
+	MrpTask                *task1, *task2;
+	gchar                  *filename;
+	gint                    i;
+
+	g_type_init ();
+
+	app = mrp_application_new ();
+	project = mrp_project_new (app);
+
+	filename = g_strdup_printf ("%s/planner-eds-save-test-%d.planner",
+				    g_get_tmp_dir (), (gint) getpid ());
+
+	CHECK_BOOLEAN_RESULT (mrp_project_save_as (project, filename, TRUE, NULL), TRUE);
+
+	save = e_cal_backend_planner_save_new (project, DELAY, MAX_CHANGES);
+
+	/* What the backend does for create, modify and remove. */
+	task1 = insert_task (project, "Create");
+	e_cal_backend_planner_save_changed (save);
+
+	task2 = insert_task (project, "Remove");
+	e_cal_backend_planner_save_changed (save);
+
+	g_object_set (task1, "name", "Modify", NULL);
+	e_cal_backend_planner_save_changed (save);
+
+	mrp_project_remove_task (project, task2);
+	e_cal_backend_planner_save_changed (save);
+
+	CHECK_INTEGER_RESULT (e_cal_backend_planner_save_get_pending (save), 4);
+	CHECK_INTEGER_RESULT (e_cal_backend_planner_save_get_n_saves (save), 0);
+
+	/* Each change restarts the timeout, so changes coming in at less
+	 * than the delay apart keep the file from being written.
+	 */
+	run_main_loop (DELAY / 2);
+	e_cal_backend_planner_save_changed (save);
+	run_main_loop (DELAY / 2);
+	e_cal_backend_planner_save_changed (save);
+	run_main_loop (DELAY / 2);
+
+	CHECK_INTEGER_RESULT (e_cal_backend_planner_save_get_n_saves (save), 0);
+
+	/* Once it's quiet the whole batch is written at once. */
+	run_main_loop (DELAY * 2);
+
+	CHECK_INTEGER_RESULT (e_cal_backend_planner_save_get_n_saves (save), 1);
+	CHECK_INTEGER_RESULT (e_cal_backend_planner_save_get_pending (save), 0);
+
+	CHECK_BOOLEAN_RESULT (saved_file_has_task (app, filename, "Modify"), TRUE);
+	CHECK_BOOLEAN_RESULT (saved_file_has_task (app, filename, "Remove"), FALSE);
+
+	/* Nothing pending, nothing written. */
+	e_cal_backend_planner_save_flush (save);
+	CHECK_INTEGER_RESULT (e_cal_backend_planner_save_get_n_saves (save), 1);
+
+	/* A big batch is written when it reaches the limit, without waiting. */
+	for (i = 0; i < MAX_CHANGES; i++) {
+		insert_task (project, "Batch");
+		e_cal_backend_planner_save_changed (save);
+	}
+
+	CHECK_INTEGER_RESULT (e_cal_backend_planner_save_get_n_saves (save), 2);
+	CHECK_INTEGER_RESULT (e_cal_backend_planner_save_get_pending (save), 0);
+
+	/* Pending changes are written when the backend goes away. */
+	insert_task (project, "Last");
+	e_cal_backend_planner_save_changed (save);
+	e_cal_backend_planner_save_free (save);
+
+	CHECK_BOOLEAN_RESULT (saved_file_has_task (app, filename, "Last"), TRUE);
+
+	g_unlink (filename);
+	g_free (filename);
+
+	g_object_unref (project);
+	g_object_unref (app);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+#include <config.h>
+#include <locale.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include "libplanner/mrp-project.h"
+#include "libplanner/mrp-private.h"
+#include "self-check.h"
+
+static MrpFileWriter *
+find_writer (MrpApplication *app, const gchar *identifier, gint *count)
+{
+	GList         *l;
+	MrpFileWriter *found = NULL;
+
+	*count = 0;
+	for (l = imrp_application_get_all_file_writers (app); l; l = l->next) {
+		MrpFileWriter *writer = l->data;
+
+		if (strcmp (writer->identifier, identifier) == 0) {
+			found = writer;
+			(*count)++;
+		}
+	}
+
+	return found;
+}
+
+/* Counts the registered readers and writers whose module is open. */
+static gint
+count_loaded (MrpApplication *app)
+{
+	GList *l;
+	gint   count = 0;
+
+	for (l = imrp_application_get_all_file_writers (app); l; l = l->next) {
+		MrpFileWriter *writer = l->data;
+
+		if (writer->module && mrp_file_module_is_loaded (writer->module)) {
+			count++;
+		}
+	}
+
+	for (l = imrp_application_get_all_file_readers (app); l; l = l->next) {
+		MrpFileReader *reader = l->data;
+
+		if (reader->module && mrp_file_module_is_loaded (reader->module)) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+	MrpApplication *app;
+	MrpProject     *project;
+	MrpFileWriter  *writer;
+	MrpFileWriter  *proxy;
+	GTimer         *timer;
+	const gchar    *modules_dir;
+	gchar          *cwd;
+	gchar          *library;
+	gchar          *dir;
+	gchar          *manifest;
+	gchar          *contents;
+	gchar          *html;
+	FILE           *file;
+	gint            count;
+
+        g_type_init ();
+
+	/* Describe the XSL module with a manifest in a directory of its own,
+	 * pointing back to the library that was just built.
+	 */
+	modules_dir = g_getenv ("PLANNER_FILEMODULESDIR");
+	if (!modules_dir) {
+		g_print ("PLANNER_FILEMODULESDIR is not set, skipping.\n");
+		return EXIT_SUCCESS;
+	}
+
+	cwd = g_get_current_dir ();
+	if (g_path_is_absolute (modules_dir)) {
+		library = g_build_filename (modules_dir, "libmrp-xsl", NULL);
+	} else {
+		library = g_build_filename (cwd, modules_dir, "libmrp-xsl", NULL);
+	}
+
+	dir = g_strdup_printf ("%s/planner-file-module-test-%d",
+			       g_get_tmp_dir (), (gint) getpid ());
+	g_mkdir (dir, 0755);
+
+	manifest = g_build_filename (dir, "libmrp-xsl.manifest", NULL);
+	contents = g_strdup_printf ("[Planner File Module]\n"
+				    "Library=%s\n"
+				    "Writers=Planner HTML;Planner XML pre-0.12\n"
+				    "MimeTypes=text/html;text/xml\n",
+				    library);
+	file = g_fopen (manifest, "w");
+	fputs (contents, file);
+	fclose (file);
+
+	g_setenv ("PLANNER_FILEMODULESDIR", dir, TRUE);
+
+	timer = g_timer_new ();
+	app = mrp_application_new ();
+	g_timer_stop (timer);
+
+	g_print ("Application startup: %.2f ms\n",
+		 g_timer_elapsed (timer, NULL) * 1000);
+
+	/* The writers are there but no module is opened yet. */
+	CHECK_INTEGER_RESULT (count_loaded (app), 0);
+
+	writer = find_writer (app, "Planner HTML", &count);
+	CHECK_INTEGER_RESULT (count, 1);
+	CHECK_STRING_RESULT (g_strdup (writer->mime_type), "text/html");
+	CHECK_BOOLEAN_RESULT (mrp_file_module_is_loaded (writer->module), FALSE);
+
+	proxy = writer;
+
+	/* The first export opens it and the proxies are replaced. */
+	project = mrp_project_new (app);
+	html = g_build_filename (dir, "project.html", NULL);
+
+	CHECK_BOOLEAN_RESULT (mrp_project_export (project, html, "text/html",
+						  TRUE, NULL), TRUE);
+	CHECK_BOOLEAN_RESULT (g_file_test (html, G_FILE_TEST_EXISTS), TRUE);
+	CHECK_BOOLEAN_RESULT (mrp_file_module_is_loaded (writer->module), TRUE);
+
+	writer = find_writer (app, "Planner HTML", &count);
+	CHECK_INTEGER_RESULT (count, 1);
+	CHECK_BOOLEAN_RESULT (writer != proxy, TRUE);
+	CHECK_POINTER_RESULT (writer->module, proxy->module);
+
+	writer = find_writer (app, "Planner XML pre-0.12", &count);
+	CHECK_INTEGER_RESULT (count, 1);
+	CHECK_BOOLEAN_RESULT (mrp_file_module_is_loaded (writer->module), TRUE);
+
+	g_unlink (html);
+	g_unlink (manifest);
+	g_rmdir (dir);
+
+	g_timer_destroy (timer);
+	g_free (html);
+	g_free (contents);
+	g_free (manifest);
+	g_free (dir);
+	g_free (library);
+	g_free (cwd);
+
+	return EXIT_SUCCESS;
+}
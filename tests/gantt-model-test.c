@@ -0,0 +1,175 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+#include <config.h>
+#include <stdlib.h>
+#include "libplanner/mrp-project.h"
+#include "src/planner-gantt-model.h"
+#include "self-check.h"
+
+#define N_TASKS 200
+
+/* Checks that the model's paths and WBS codes agree with the task tree. */
+static void
+check_paths (PlannerGanttModel *model,
+	     MrpProject        *project)
+{
+	GList       *tasks, *l;
+	MrpTask     *task, *tmp;
+	MrpTask     *found;
+	GtkTreePath *path;
+	GString     *expected;
+	GString     *expected_wbs;
+	gchar       *str;
+	gchar       *wbs;
+	GtkTreeIter  iter;
+
+	tasks = mrp_project_get_all_tasks (project);
+
+	for (l = tasks; l; l = l->next) {
+		task = l->data;
+
+		expected = g_string_new (NULL);
+		expected_wbs = g_string_new (NULL);
+		for (tmp = task; mrp_task_get_parent (tmp); tmp = mrp_task_get_parent (tmp)) {
+			str = g_strdup_printf ("%d%s",
+					       mrp_task_get_position (tmp),
+					       expected->len ? ":" : "");
+			g_string_prepend (expected, str);
+			g_free (str);
+
+			str = g_strdup_printf ("%d%s",
+					       mrp_task_get_position (tmp) + 1,
+					       expected_wbs->len ? "." : "");
+			g_string_prepend (expected_wbs, str);
+			g_free (str);
+		}
+
+		path = planner_gantt_model_get_path_from_task (model, task);
+		str = gtk_tree_path_to_string (path);
+
+		CHECK_STRING_RESULT (g_strdup (str), expected->str);
+
+		CHECK_BOOLEAN_RESULT (gtk_tree_model_get_iter (GTK_TREE_MODEL (model), &iter, path), TRUE);
+		found = planner_gantt_model_get_task (model, &iter);
+		CHECK_POINTER_RESULT (found, task);
+
+		gtk_tree_model_get (GTK_TREE_MODEL (model), &iter,
+				    COL_WBS, &wbs,
+				    -1);
+		CHECK_STRING_RESULT (g_strdup (wbs), expected_wbs->str);
+
+		g_free (wbs);
+		g_free (str);
+		g_string_free (expected, TRUE);
+		g_string_free (expected_wbs, TRUE);
+		gtk_tree_path_free (path);
+	}
+
+	g_list_free (tasks);
+}
+
+static void
+row_changed_cb (GtkTreeModel *model,
+		GtkTreePath  *path,
+		GtkTreeIter  *iter,
+		gint         *count)
+{
+	(*count)++;
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+	MrpApplication    *app;
+	MrpProject        *project;
+	PlannerGanttModel *model;
+	MrpTask           *tasks[N_TASKS];
+	MrpTask           *root;
+	MrpTask           *task;
+	GtkTreeIter        iter;
+	gint               i;
+	gint               count;
+
+	g_type_init ();
+
+	app = mrp_application_new ();
+	project = mrp_project_new (app);
+
+	model = planner_gantt_model_new (project);
+	root = mrp_project_get_root_task (project);
+
+	/* Appending, like when loading a flat project. */
+	for (i = 0; i < N_TASKS; i++) {
+		tasks[i] = g_object_new (MRP_TYPE_TASK, NULL);
+		mrp_project_insert_task (project, NULL, -1, tasks[i]);
+	}
+
+	CHECK_INTEGER_RESULT (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (model), NULL), N_TASKS);
+
+	CHECK_BOOLEAN_RESULT (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (model), &iter, NULL, N_TASKS - 1), TRUE);
+	CHECK_POINTER_RESULT (planner_gantt_model_get_task (model, &iter), tasks[N_TASKS - 1]);
+
+	CHECK_BOOLEAN_RESULT (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (model), &iter, NULL, N_TASKS), FALSE);
+
+	check_paths (model, project);
+
+	/* Inserting at the front and in the middle renumbers the rest. */
+	task = g_object_new (MRP_TYPE_TASK, NULL);
+	mrp_project_insert_task (project, NULL, 0, task);
+
+	task = g_object_new (MRP_TYPE_TASK, NULL);
+	mrp_project_insert_task (project, NULL, N_TASKS / 2, task);
+
+	check_paths (model, project);
+
+	/* Subtasks. */
+	for (i = 0; i < 10; i++) {
+		task = g_object_new (MRP_TYPE_TASK, NULL);
+		mrp_project_insert_task (project, tasks[10], i % 3, task);
+	}
+
+	check_paths (model, project);
+
+	/* Removing. */
+	mrp_project_remove_task (project, tasks[0]);
+	mrp_project_remove_task (project, tasks[N_TASKS / 2]);
+	mrp_project_remove_task (project, tasks[N_TASKS - 1]);
+
+	check_paths (model, project);
+
+	/* Moving a subtree under another task and back to the top level. */
+	CHECK_BOOLEAN_RESULT (mrp_project_move_task (project, tasks[10], NULL, tasks[20], FALSE, NULL), TRUE);
+	check_paths (model, project);
+
+	CHECK_BOOLEAN_RESULT (mrp_project_move_task (project, tasks[10], tasks[5], root, TRUE, NULL), TRUE);
+	check_paths (model, project);
+
+	/* Removing a task with subtasks. */
+	mrp_project_remove_task (project, tasks[10]);
+	check_paths (model, project);
+
+	/* A frozen model signals each changed task once when thawed, and
+	 * not at all if it was removed in the meantime.
+	 */
+	count = 0;
+	g_signal_connect (model, "row-changed",
+			  G_CALLBACK (row_changed_cb),
+			  &count);
+
+	planner_gantt_model_freeze (model);
+	for (i = 0; i < 3; i++) {
+		g_object_set (tasks[1], "name", i % 2 ? "a" : "b", NULL);
+	}
+	g_object_set (tasks[2], "name", "c", NULL);
+	g_object_set (tasks[3], "name", "d", NULL);
+	mrp_project_remove_task (project, tasks[3]);
+	CHECK_INTEGER_RESULT (count, 0);
+
+	planner_gantt_model_thaw (model);
+	CHECK_INTEGER_RESULT (count, 2);
+
+	check_paths (model, project);
+
+	g_object_unref (model);
+
+	return EXIT_SUCCESS;
+}
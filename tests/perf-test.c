@@ -0,0 +1,617 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+/*
+ * Copyright (C) 2026 Planner contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Microbenchmarks for libplanner primitives.
+ *
+ *   perf-test [--baseline FILE] [--threshold PERCENT] [--allow-missing]
+ *             [--output FILE]
+ *
+ * Every benchmark is run once to warm up and to find an iteration count
+ * that takes at least MIN_SAMPLE_TIME, then N_SAMPLES times; the median
+ * time per iteration is reported. With --baseline the results are
+ * compared against a flat JSON object of "name": nanoseconds pairs and
+ * the program fails if anything got slower than the threshold allows.
+ * A benchmark without a baseline value is a failure too, unless
+ * --allow-missing is given, so that a missing baseline can't hide a
+ * regression. --output writes the results in the same format.
+ */
+
+#include <config.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <glib/gstdio.h>
+#include "libplanner/mrp-project.h"
+#include "libplanner/mrp-calendar.h"
+#include "libplanner/mrp-day.h"
+#include "src/planner-gantt-model.h"
+
+#define N_SAMPLES         9
+#define MIN_SAMPLE_TIME   0.02
+#define MAX_ITERATIONS    (1 << 28)
+#define DEFAULT_THRESHOLD 10.0
+
+#define DAY          (60*60*24)
+#define WORK_DAY     (60*60*8)
+#define N_TASKS      1000
+#define N_CHAIN      200
+#define N_RESOURCES  5
+
+typedef struct {
+	MrpApplication    *app;
+	MrpProject        *project;
+	MrpCalendar       *calendar;
+	MrpDay            *day;
+	mrptime            start;
+	MrpTask           *chain[N_CHAIN];
+	MrpTask           *cost_task;
+	MrpTask           *task;
+	PlannerGanttModel *model;
+} Fixture;
+
+typedef struct {
+	const gchar *name;
+	void       (*run) (Fixture *fixture, guint n);
+} Benchmark;
+
+/* Keeps the compiler from optimizing the benchmarked calls away. */
+static volatile gint sink;
+
+static void
+bench_time_compose (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		sink += (gint) mrp_time_compose (2002 + i % 10, 1 + i % 12, 1 + i % 28,
+						 i % 24, i % 60, 0);
+	}
+}
+
+static void
+bench_time_decompose (Fixture *fixture, guint n)
+{
+	gint  year, month, day, hour, minute, second;
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		mrp_time_decompose (fixture->start + (i % 4096) * 3607,
+				    &year, &month, &day, &hour, &minute, &second);
+		sink += day;
+	}
+}
+
+static void
+bench_time_from_string (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		sink += (gint) mrp_time_from_string ("20021112T083000Z", NULL);
+	}
+}
+
+static void
+bench_time_to_string (Fixture *fixture, guint n)
+{
+	gchar buf[MRP_TIME_STRING_LEN];
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		mrp_time_to_string_buf (fixture->start + (i % 4096) * 3607, buf);
+		sink += buf[7];
+	}
+}
+
+static void
+bench_time_align (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		sink += (gint) mrp_time_align_prev (fixture->start + (i % 4096) * 3607,
+						    MRP_TIME_UNIT_WEEK);
+	}
+}
+
+static void
+bench_calendar_get_day (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		sink += GPOINTER_TO_INT (mrp_calendar_get_day (fixture->calendar,
+							       fixture->start + (i % 365) * DAY,
+							       TRUE));
+	}
+}
+
+static void
+bench_calendar_day_get_intervals (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		sink += GPOINTER_TO_INT (mrp_calendar_day_get_intervals (fixture->calendar,
+									 fixture->day,
+									 TRUE));
+	}
+}
+
+/* Links the ends of a chain that is already connected, so the cycle check
+ * has to walk the whole chain. Scheduling is blocked while the fixture is
+ * set up, so this measures the relation bookkeeping and not the scheduler.
+ */
+static void
+bench_task_add_predecessor (Fixture *fixture, guint n)
+{
+	MrpRelation *relation;
+	guint        i;
+
+	for (i = 0; i < n; i++) {
+		relation = mrp_task_add_predecessor (fixture->chain[N_CHAIN - 1],
+						     fixture->chain[0],
+						     MRP_RELATION_FS,
+						     0,
+						     NULL);
+		g_assert (relation != NULL);
+
+		mrp_task_remove_predecessor (fixture->chain[N_CHAIN - 1],
+					     fixture->chain[0]);
+	}
+}
+
+static void
+bench_task_get_cost (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		sink += (gint) mrp_task_get_cost (fixture->cost_task);
+	}
+}
+
+static void
+bench_task_invalidate_cost (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		mrp_task_invalidate_cost (fixture->cost_task);
+	}
+}
+
+static void
+bench_object_get_property (Fixture *fixture, guint n)
+{
+	gint  work;
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		g_object_get (fixture->task, "work", &work, NULL);
+		sink += work;
+	}
+}
+
+static void
+bench_object_set_property (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		g_object_set (fixture->task, "priority", (gint) (i % 1000), NULL);
+	}
+}
+
+static void
+bench_object_get_custom_property (Fixture *fixture, guint n)
+{
+	gint  value;
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		mrp_object_get (fixture->task, "bench-int", &value, NULL);
+		sink += value;
+	}
+}
+
+static void
+bench_object_set_custom_property (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		mrp_object_set (fixture->task, "bench-int", (gint) i, NULL);
+	}
+}
+
+static void
+walk_model (GtkTreeModel *model, GtkTreeIter *parent)
+{
+	GtkTreeIter  iter;
+	gchar       *name;
+
+	if (!gtk_tree_model_iter_children (model, &iter, parent)) {
+		return;
+	}
+
+	do {
+		gtk_tree_model_get (model, &iter, COL_NAME, &name, -1);
+		sink += name[0];
+		g_free (name);
+
+		walk_model (model, &iter);
+	} while (gtk_tree_model_iter_next (model, &iter));
+}
+
+/* One iteration is a full walk over the N_TASKS rows. */
+static void
+bench_gantt_model_walk (Fixture *fixture, guint n)
+{
+	guint i;
+
+	for (i = 0; i < n; i++) {
+		walk_model (GTK_TREE_MODEL (fixture->model), NULL);
+	}
+}
+
+static const Benchmark benchmarks[] = {
+	{ "time-compose",                 bench_time_compose },
+	{ "time-decompose",               bench_time_decompose },
+	{ "time-from-string",             bench_time_from_string },
+	{ "time-to-string",               bench_time_to_string },
+	{ "time-align-week",              bench_time_align },
+	{ "calendar-get-day",             bench_calendar_get_day },
+	{ "calendar-day-get-intervals",   bench_calendar_day_get_intervals },
+	{ "task-add-predecessor",         bench_task_add_predecessor },
+	{ "task-get-cost",                bench_task_get_cost },
+	{ "task-invalidate-cost",         bench_task_invalidate_cost },
+	{ "object-get-property",          bench_object_get_property },
+	{ "object-set-property",          bench_object_set_property },
+	{ "object-get-custom-property",   bench_object_get_custom_property },
+	{ "object-set-custom-property",   bench_object_set_custom_property },
+	{ "gantt-model-walk",             bench_gantt_model_walk }
+};
+
+static void
+fixture_init (Fixture *fixture)
+{
+	MrpCalendar *base;
+	MrpResource *resource;
+	MrpTask     *parent = NULL;
+	MrpTask     *task;
+	GList       *intervals;
+	gint         i;
+
+	fixture->app = mrp_application_new ();
+	fixture->project = mrp_project_new (fixture->app);
+	fixture->start = mrp_time_from_string ("20021104", NULL);
+
+	g_object_set (fixture->project, "project_start", fixture->start, NULL);
+
+	/* A derived calendar with a few overridden days, so lookups go
+	 * through both levels.
+	 */
+	base = mrp_calendar_new ("Bench Base", fixture->project);
+	intervals = g_list_append (NULL, mrp_interval_new (8*60*60, 12*60*60));
+	intervals = g_list_append (intervals, mrp_interval_new (13*60*60, 17*60*60));
+	mrp_calendar_day_set_intervals (base, mrp_day_get_work (), intervals);
+	mrp_calendar_set_default_days (base,
+				       MRP_CALENDAR_DAY_MON, mrp_day_get_work (),
+				       MRP_CALENDAR_DAY_TUE, mrp_day_get_work (),
+				       MRP_CALENDAR_DAY_WED, mrp_day_get_work (),
+				       MRP_CALENDAR_DAY_THU, mrp_day_get_work (),
+				       MRP_CALENDAR_DAY_FRI, mrp_day_get_work (),
+				       MRP_CALENDAR_DAY_SAT, mrp_day_get_nonwork (),
+				       MRP_CALENDAR_DAY_SUN, mrp_day_get_nonwork (),
+				       -1);
+
+	fixture->calendar = mrp_calendar_derive ("Bench", base);
+	for (i = 0; i < 365; i += 17) {
+		mrp_calendar_set_days (fixture->calendar,
+				       fixture->start + i * DAY, mrp_day_get_nonwork (),
+				       (mrptime) -1);
+	}
+	fixture->day = mrp_day_get_work ();
+
+	mrp_project_set_block_scheduling (fixture->project, TRUE);
+
+	/* Custom properties live in the project, so add one for tasks. */
+	mrp_project_add_property (fixture->project,
+				  MRP_TYPE_TASK,
+				  mrp_property_new ("bench-int",
+						    MRP_PROPERTY_TYPE_INT,
+						    "Bench",
+						    "Benchmark property",
+						    FALSE),
+				  FALSE);
+
+	fixture->model = planner_gantt_model_new (fixture->project);
+
+	/* N_CHAIN flat tasks for the relations, the rest in groups of ten
+	 * under a summary task.
+	 */
+	for (i = 0; i < N_TASKS; i++) {
+		task = g_object_new (MRP_TYPE_TASK,
+				     "name", "Task",
+				     "work", WORK_DAY,
+				     NULL);
+
+		if (i < N_CHAIN) {
+			mrp_project_insert_task (fixture->project, NULL, -1, task);
+			fixture->chain[i] = task;
+		}
+		else if (i % 10 == 0) {
+			mrp_project_insert_task (fixture->project, NULL, -1, task);
+			parent = task;
+		} else {
+			mrp_project_insert_task (fixture->project, parent, -1, task);
+		}
+	}
+
+	for (i = 1; i < N_CHAIN; i++) {
+		mrp_task_add_predecessor (fixture->chain[i],
+					  fixture->chain[i - 1],
+					  MRP_RELATION_FS,
+					  0,
+					  NULL);
+	}
+
+	fixture->task = fixture->chain[N_CHAIN / 2];
+
+	fixture->cost_task = fixture->chain[1];
+	for (i = 0; i < N_RESOURCES; i++) {
+		resource = g_object_new (MRP_TYPE_RESOURCE,
+					 "name", "Resource",
+					 "cost", 10.0 * (i + 1),
+					 NULL);
+		mrp_project_add_resource (fixture->project, resource);
+		mrp_resource_assign (resource, fixture->cost_task, 100);
+	}
+}
+
+static gint
+compare_doubles (gconstpointer a, gconstpointer b)
+{
+	gdouble da = *(const gdouble *) a;
+	gdouble db = *(const gdouble *) b;
+
+	return da < db ? -1 : da > db ? 1 : 0;
+}
+
+/* Returns the median time per iteration in nanoseconds. */
+static gdouble
+measure (const Benchmark *bench, Fixture *fixture)
+{
+	GTimer  *timer;
+	gdouble  samples[N_SAMPLES];
+	gdouble  elapsed;
+	guint    n;
+	gint     i;
+
+	timer = g_timer_new ();
+
+	/* Warm up, doubling the count until a run is long enough for the
+	 * timer resolution not to matter.
+	 */
+	for (n = 1; ; n *= 2) {
+		g_timer_start (timer);
+		bench->run (fixture, n);
+		elapsed = g_timer_elapsed (timer, NULL);
+
+		if (elapsed >= MIN_SAMPLE_TIME || n >= MAX_ITERATIONS) {
+			break;
+		}
+	}
+
+	for (i = 0; i < N_SAMPLES; i++) {
+		g_timer_start (timer);
+		bench->run (fixture, n);
+		samples[i] = g_timer_elapsed (timer, NULL) * 1e9 / n;
+	}
+
+	g_timer_destroy (timer);
+
+	qsort (samples, N_SAMPLES, sizeof (gdouble), compare_doubles);
+
+	return samples[N_SAMPLES / 2];
+}
+
+/* Reads a flat JSON object of "name": number pairs. Entries that are not
+ * numbers, like null for a benchmark that has no baseline yet, are
+ * skipped.
+ */
+static GHashTable *
+baseline_read (const gchar *filename)
+{
+	GHashTable *table;
+	GError     *error = NULL;
+	gchar      *contents;
+	gchar      *p, *end;
+	gchar      *name;
+	gdouble     value;
+
+	if (!g_file_get_contents (filename, &contents, NULL, &error)) {
+		g_printerr ("Could not read baseline: %s\n", error->message);
+		g_error_free (error);
+		return NULL;
+	}
+
+	table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	p = contents;
+	while ((p = strchr (p, '"')) != NULL) {
+		end = strchr (p + 1, '"');
+		if (!end) {
+			break;
+		}
+
+		name = g_strndup (p + 1, end - p - 1);
+
+		p = end + 1;
+		while (*p == ' ' || *p == '\t' || *p == '\n' || *p == ':') {
+			p++;
+		}
+
+		value = g_ascii_strtod (p, &end);
+		if (end != p) {
+			g_hash_table_insert (table, name, g_memdup (&value, sizeof (value)));
+			p = end;
+		} else {
+			g_free (name);
+		}
+	}
+
+	g_free (contents);
+
+	return table;
+}
+
+static gboolean
+results_write (const gchar *filename, const gdouble *results)
+{
+	FILE  *file;
+	gchar  buf[G_ASCII_DTOSTR_BUF_SIZE];
+	guint  i;
+
+	file = g_fopen (filename, "w");
+	if (!file) {
+		g_printerr ("Could not write %s\n", filename);
+		return FALSE;
+	}
+
+	fputs ("{\n", file);
+	for (i = 0; i < G_N_ELEMENTS (benchmarks); i++) {
+		fprintf (file, "  \"%s\": %s%s\n",
+			 benchmarks[i].name,
+			 g_ascii_formatd (buf, sizeof (buf), "%.1f", results[i]),
+			 i < G_N_ELEMENTS (benchmarks) - 1 ? "," : "");
+	}
+	fputs ("}\n", file);
+
+	fclose (file);
+
+	return TRUE;
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+	Fixture      fixture;
+	GHashTable  *baseline = NULL;
+	const gchar *baseline_file = NULL;
+	const gchar *output_file = NULL;
+	gdouble      threshold = DEFAULT_THRESHOLD;
+	gboolean     allow_missing = FALSE;
+	gdouble      results[G_N_ELEMENTS (benchmarks)];
+	gdouble     *expected;
+	gdouble      change;
+	gint         n_regressions = 0;
+	gint         n_missing = 0;
+	gint         i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp (argv[i], "--baseline") == 0 && i + 1 < argc) {
+			baseline_file = argv[++i];
+		}
+		else if (strcmp (argv[i], "--output") == 0 && i + 1 < argc) {
+			output_file = argv[++i];
+		}
+		else if (strcmp (argv[i], "--threshold") == 0 && i + 1 < argc) {
+			threshold = g_ascii_strtod (argv[++i], NULL);
+		}
+		else if (strcmp (argv[i], "--allow-missing") == 0) {
+			allow_missing = TRUE;
+		}
+		else {
+			g_printerr ("Usage: %s [--baseline FILE] [--threshold PERCENT] "
+				    "[--allow-missing] [--output FILE]\n",
+				    argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	g_type_init ();
+
+	if (baseline_file) {
+		baseline = baseline_read (baseline_file);
+		if (!baseline) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	memset (&fixture, 0, sizeof (fixture));
+	fixture_init (&fixture);
+
+	for (i = 0; i < G_N_ELEMENTS (benchmarks); i++) {
+		results[i] = measure (&benchmarks[i], &fixture);
+
+		g_print ("%-30s %12.1f ns", benchmarks[i].name, results[i]);
+
+		expected = baseline ? g_hash_table_lookup (baseline, benchmarks[i].name) : NULL;
+		if (expected && *expected > 0) {
+			change = (results[i] - *expected) * 100 / *expected;
+			g_print ("  baseline %12.1f ns  %+6.1f%%", *expected, change);
+
+			if (change > threshold) {
+				g_print ("  REGRESSION");
+				n_regressions++;
+			}
+		}
+		else if (baseline) {
+			g_print ("  (no baseline)");
+			if (!allow_missing) {
+				g_print ("  MISSING");
+				n_missing++;
+			}
+		}
+
+		g_print ("\n");
+	}
+
+	if (output_file && !results_write (output_file, results)) {
+		return EXIT_FAILURE;
+	}
+
+	g_object_unref (fixture.model);
+	g_object_unref (fixture.project);
+	g_object_unref (fixture.app);
+
+	if (baseline) {
+		g_hash_table_destroy (baseline);
+	}
+
+	if (n_missing > 0) {
+		g_printerr ("%d benchmark(s) have no baseline value, record them on the "
+			    "reference machine or pass --allow-missing\n",
+			    n_missing);
+	}
+
+	if (n_regressions > 0) {
+		g_printerr ("%d benchmark(s) more than %.0f%% slower than the baseline\n",
+			    n_regressions, threshold);
+	}
+
+	if (n_missing > 0 || n_regressions > 0) {
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
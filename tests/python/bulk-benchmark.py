@@ -0,0 +1,96 @@
+#!/usr/bin/env python
+#
+# Compares reading and writing task fields one property at a time with
+# the column based Project.get_tasks_table() and Project.update_tasks().
+#
+# Usage: bulk-benchmark.py [number of tasks]
+
+import sys
+import time
+
+import pygtk
+pygtk.require("2.0")
+import planner
+
+FIELDS = ['id', 'name', 'start', 'finish', 'work', 'duration',
+          'percent_complete', 'priority']
+
+n_tasks = 2000
+if len(sys.argv) > 1:
+    n_tasks = int(sys.argv[1])
+
+app = planner.Application()
+project = planner.Project(app)
+root = project.get_root_task()
+
+project.set_block_scheduling(True)
+for i in range(n_tasks):
+    task = planner.Task()
+    task.set_property('name', 'Task %d' % i)
+    task.set_property('work', 8 * 60 * 60)
+    project.insert_task(root, -1, task)
+project.set_block_scheduling(False)
+
+def timed(func):
+    start = time.time()
+    func()
+    return time.time() - start
+
+# Reading.
+
+def read_properties():
+    table = dict([(f, []) for f in FIELDS])
+    for task in project.get_all_tasks():
+        table['id'].append(task.get_id())
+        for f in FIELDS[1:]:
+            table[f].append(task.get_property(f))
+    return table
+
+def read_table():
+    return project.get_tasks_table(FIELDS)
+
+t_props = timed(read_properties)
+t_table = timed(read_table)
+
+assert read_properties()['name'] == read_table()['name']
+
+# Writing, scheduling is done per change for the property version.
+
+ids = read_table()['id']
+
+def write_properties():
+    for task in project.get_all_tasks():
+        task.set_property('work', 2 * 8 * 60 * 60)
+        task.set_property('percent_complete', 50)
+
+def write_table():
+    project.update_tasks({'id': ids,
+                          'work': [3 * 8 * 60 * 60] * len(ids),
+                          'percent_complete': [75] * len(ids)})
+
+t_set_props = timed(write_properties)
+t_set_table = timed(write_table)
+
+assert read_table()['percent_complete'] == [75] * len(ids)
+
+# A bad value anywhere leaves every task alone.
+try:
+    project.update_tasks({'id': ids,
+                          'priority': [1] * len(ids),
+                          'work': [0] * (len(ids) - 1) + ['x']})
+    assert False
+except TypeError:
+    pass
+assert 1 not in read_table()['priority']
+
+try:
+    project.get_tasks_table(['name', 'name'])
+    assert False
+except ValueError:
+    pass
+
+print '%d tasks, %d fields' % (n_tasks, len(FIELDS))
+print 'read:  get_property %.3fs, get_tasks_table %.3fs (%.1fx)' % \
+      (t_props, t_table, t_props / max(t_table, 1e-6))
+print 'write: set_property %.3fs, update_tasks    %.3fs (%.1fx)' % \
+      (t_set_props, t_set_table, t_set_props / max(t_set_table, 1e-6))
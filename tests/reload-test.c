@@ -0,0 +1,150 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+#include <config.h>
+#include <locale.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include "libplanner/mrp-project.h"
+#include "self-check.h"
+
+static gint
+count_tasks (MrpProject *project)
+{
+	GList *tasks;
+	gint   n;
+
+	tasks = mrp_project_get_all_tasks (project);
+	n = g_list_length (tasks);
+	g_list_free (tasks);
+
+	return n;
+}
+
+static gchar *
+get_code (MrpTask *task)
+{
+	gchar *code;
+
+	mrp_object_get (MRP_OBJECT (task), "Code", &code, NULL);
+
+	return code;
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+	MrpApplication *app;
+	MrpProject     *project, *other;
+	MrpTask        *closure, *demolition, *vendors, *task;
+	MrpProperty    *property;
+	GList          *tasks, *l;
+	GError         *error = NULL;
+	gchar          *example;
+	gchar          *filename;
+
+        g_type_init ();
+
+	app = mrp_application_new ();
+
+	example = g_build_filename (EXAMPLESDIR, "test-2.planner", NULL);
+	filename = g_strdup_printf ("%s/planner-reload-test-%d.planner",
+				    g_get_tmp_dir (), (gint) getpid ());
+
+	project = mrp_project_new (app);
+	CHECK_BOOLEAN_RESULT (mrp_project_load (project, example, NULL), TRUE);
+
+	/* The example has no uids, so it can't be reloaded in place. */
+	CHECK_BOOLEAN_RESULT (mrp_project_reload (project, &error), FALSE);
+	CHECK_BOOLEAN_RESULT (g_error_matches (error, MRP_ERROR, MRP_ERROR_RELOAD_NEEDS_LOAD), TRUE);
+	g_clear_error (&error);
+
+	/* Give every task its own value, to see that values stay with their
+	 * task.
+	 */
+	property = mrp_property_new ("Code",
+				     MRP_PROPERTY_TYPE_STRING,
+				     "Code",
+				     "",
+				     TRUE);
+	mrp_project_add_property (project, MRP_TYPE_TASK, property, TRUE);
+
+	tasks = mrp_project_get_all_tasks (project);
+	for (l = tasks; l; l = l->next) {
+		mrp_object_set (MRP_OBJECT (l->data),
+				"Code", mrp_task_get_name (l->data),
+				NULL);
+	}
+	g_list_free (tasks);
+
+	CHECK_BOOLEAN_RESULT (mrp_project_save_as (project, filename, TRUE, NULL), TRUE);
+
+	closure = mrp_project_get_task_by_name (project, "Closure");
+	demolition = mrp_project_get_task_by_name (project, "Demolition");
+	vendors = mrp_project_get_task_by_name (project, "Pay all Vendors");
+
+	/* Saving gave every task a uid, and they can be looked up by it. */
+	CHECK_BOOLEAN_RESULT (mrp_object_get_uid (MRP_OBJECT (vendors)) != NULL, TRUE);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_uid (project,
+							   mrp_object_get_uid (MRP_OBJECT (vendors))),
+			      vendors);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_uid (project, "no-such-uid"), NULL);
+
+	/* Change the file behind the project's back. */
+	other = mrp_project_new (app);
+	CHECK_BOOLEAN_RESULT (mrp_project_load (other, filename, NULL), TRUE);
+
+	g_object_set (mrp_project_get_task_by_name (other, "Closure"),
+		      "name", "Wrap-up", NULL);
+	g_object_set (mrp_project_get_task_by_name (other, "Demolition"),
+		      "work", 8*60*60, NULL);
+	mrp_object_set (MRP_OBJECT (mrp_project_get_task_by_name (other, "Demolition")),
+			"Code", "D-1", NULL);
+
+	task = g_object_new (MRP_TYPE_TASK, "name", "Handover", NULL);
+	mrp_project_insert_task (other, NULL, -1, task);
+
+	CHECK_BOOLEAN_RESULT (mrp_project_save (other, TRUE, NULL), TRUE);
+
+	CHECK_BOOLEAN_RESULT (mrp_project_reload (project, NULL), TRUE);
+	CHECK_BOOLEAN_RESULT (mrp_project_needs_saving (project), FALSE);
+
+	/* Unchanged tasks are kept, changed ones are updated in place. */
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "Closure"), NULL);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "Wrap-up"), closure);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "Demolition"), demolition);
+	CHECK_INTEGER_RESULT (mrp_task_get_work (demolition), 8*60*60);
+	CHECK_STRING_RESULT (get_code (demolition), "D-1");
+	CHECK_STRING_RESULT (get_code (closure), "Closure");
+
+	task = mrp_project_get_task_by_name (project, "Handover");
+	CHECK_BOOLEAN_RESULT (task != NULL, TRUE);
+	CHECK_STRING_RESULT (g_strdup (mrp_object_get_uid (MRP_OBJECT (task))),
+			     mrp_object_get_uid (MRP_OBJECT (mrp_project_get_task_by_name (other, "Handover"))));
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_uid (project,
+							   mrp_object_get_uid (MRP_OBJECT (task))),
+			      task);
+	CHECK_POINTER_RESULT (mrp_task_get_parent (task), mrp_project_get_root_task (project));
+	CHECK_INTEGER_RESULT (count_tasks (project), count_tasks (other));
+
+	/* A removal renumbers the tasks after it in the file, they must
+	 * still be matched to themselves.
+	 */
+	mrp_project_remove_task (other, mrp_project_get_task_by_name (other, "Lessons Learned"));
+	CHECK_BOOLEAN_RESULT (mrp_project_save (other, TRUE, NULL), TRUE);
+
+	CHECK_BOOLEAN_RESULT (mrp_project_reload (project, NULL), TRUE);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "Lessons Learned"), NULL);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "Pay all Vendors"), vendors);
+	CHECK_STRING_RESULT (get_code (vendors), "Pay all Vendors");
+	CHECK_STRING_RESULT (get_code (mrp_project_get_task_by_name (project, "Have a Party")),
+			     "Have a Party");
+	CHECK_INTEGER_RESULT (count_tasks (project), count_tasks (other));
+
+	g_unlink (filename);
+
+	g_free (filename);
+	g_free (example);
+
+	return EXIT_SUCCESS;
+}
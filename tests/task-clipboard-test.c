@@ -0,0 +1,110 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+#include <config.h>
+#include <stdlib.h>
+#include "libplanner/mrp-project.h"
+#include "src/planner-task-clipboard.h"
+#include "self-check.h"
+
+gint
+main (gint argc, gchar **argv)
+{
+	MrpApplication       *app;
+	MrpProject           *source, *target;
+	MrpResource          *resource, *other;
+	MrpTask              *parent, *child1, *child2, *outside;
+	MrpTask              *pasted;
+	MrpRelation          *relation;
+	PlannerTaskClipboard *clipboard;
+	GPtrArray            *tasks;
+	GList                *list;
+
+	g_type_init ();
+
+	app = mrp_application_new ();
+	source = mrp_project_new (app);
+	target = mrp_project_new (app);
+
+	resource = g_object_new (MRP_TYPE_RESOURCE, "name", "Ann", NULL);
+	mrp_project_add_resource (source, resource);
+
+	other = g_object_new (MRP_TYPE_RESOURCE, "name", "Ann", NULL);
+	mrp_project_add_resource (target, other);
+
+	parent = g_object_new (MRP_TYPE_TASK, "name", "Parent", NULL);
+	child1 = g_object_new (MRP_TYPE_TASK, "name", "Child 1", NULL);
+	child2 = g_object_new (MRP_TYPE_TASK, "name", "Child 2", NULL);
+	outside = g_object_new (MRP_TYPE_TASK, "name", "Outside", NULL);
+
+	mrp_project_insert_task (source, NULL, -1, outside);
+	mrp_project_insert_task (source, NULL, -1, parent);
+	mrp_project_insert_task (source, parent, -1, child1);
+	mrp_project_insert_task (source, parent, -1, child2);
+
+	mrp_task_add_predecessor (child2, child1, MRP_RELATION_FS, 0, NULL);
+	mrp_task_add_predecessor (child1, outside, MRP_RELATION_FS, 0, NULL);
+	mrp_resource_assign (resource, child1, 50);
+
+	/* Copying a parent and its child copies the subtree once. */
+	list = g_list_append (NULL, parent);
+	list = g_list_append (list, child1);
+	clipboard = planner_task_clipboard_new (list);
+	g_list_free (list);
+
+	CHECK_INTEGER_RESULT (planner_task_clipboard_get_n_tasks (clipboard), 3);
+
+	/* Paste into another project, the relation to the task outside the
+	 * copy is dropped and the resource is mapped by name.
+	 */
+	tasks = planner_task_clipboard_create_tasks (clipboard);
+	planner_task_clipboard_insert (clipboard, target, NULL, -1, tasks);
+
+	CHECK_INTEGER_RESULT (g_list_length (mrp_project_get_all_tasks (target)), 3);
+
+	pasted = mrp_task_get_nth_child (mrp_project_get_root_task (target), 0);
+	CHECK_POINTER_RESULT (pasted, g_ptr_array_index (tasks, 0));
+	CHECK_STRING_RESULT (g_strdup (mrp_task_get_name (pasted)), "Parent");
+	CHECK_INTEGER_RESULT (mrp_task_get_n_children (pasted), 2);
+	CHECK_STRING_RESULT (g_strdup (mrp_task_get_name (mrp_task_get_nth_child (pasted, 1))), "Child 2");
+
+	list = mrp_task_get_predecessor_relations (g_ptr_array_index (tasks, 2));
+	CHECK_INTEGER_RESULT (g_list_length (list), 1);
+	relation = list->data;
+	CHECK_POINTER_RESULT (mrp_relation_get_predecessor (relation), g_ptr_array_index (tasks, 1));
+
+	CHECK_INTEGER_RESULT (g_list_length (mrp_task_get_predecessor_relations (g_ptr_array_index (tasks, 1))), 0);
+
+	list = mrp_task_get_assignments (g_ptr_array_index (tasks, 1));
+	CHECK_INTEGER_RESULT (g_list_length (list), 1);
+	CHECK_POINTER_RESULT (mrp_assignment_get_resource (list->data), other);
+	CHECK_INTEGER_RESULT (mrp_assignment_get_units (list->data), 50);
+
+	CHECK_BOOLEAN_RESULT (mrp_project_get_block_scheduling (target), FALSE);
+
+	/* Removing and inserting the same tasks again, like undo and redo. */
+	planner_task_clipboard_remove (clipboard, target, tasks);
+	CHECK_INTEGER_RESULT (g_list_length (mrp_project_get_all_tasks (target)), 0);
+
+	planner_task_clipboard_insert (clipboard, target, NULL, 0, tasks);
+	CHECK_INTEGER_RESULT (g_list_length (mrp_project_get_all_tasks (target)), 3);
+	CHECK_INTEGER_RESULT (g_list_length (mrp_task_get_predecessor_relations (g_ptr_array_index (tasks, 2))), 1);
+	CHECK_INTEGER_RESULT (g_list_length (mrp_task_get_assignments (g_ptr_array_index (tasks, 1))), 1);
+
+	/* Pasting into the same project keeps the resource. */
+	g_ptr_array_foreach (tasks, (GFunc) g_object_unref, NULL);
+	g_ptr_array_free (tasks, TRUE);
+
+	tasks = planner_task_clipboard_create_tasks (clipboard);
+	planner_task_clipboard_insert (clipboard, source, NULL, 0, tasks);
+
+	CHECK_POINTER_RESULT (mrp_task_get_nth_child (mrp_project_get_root_task (source), 0),
+			      g_ptr_array_index (tasks, 0));
+	list = mrp_task_get_assignments (g_ptr_array_index (tasks, 1));
+	CHECK_POINTER_RESULT (mrp_assignment_get_resource (list->data), resource);
+
+	g_ptr_array_foreach (tasks, (GFunc) g_object_unref, NULL);
+	g_ptr_array_free (tasks, TRUE);
+
+	planner_task_clipboard_unref (clipboard);
+
+	return EXIT_SUCCESS;
+}
@@ -8,6 +8,18 @@
 
 #define DAY (60*60*8)
 
+static void
+cost_changed_cb (MrpProject *project, gint *count)
+{
+	(*count)++;
+}
+
+static void
+notify_cb (MrpTask *task, GParamSpec *pspec, gint *count)
+{
+	(*count)++;
+}
+
 gint
 main (gint argc, gchar **argv)
 {
@@ -20,6 +32,10 @@ main (gint argc, gchar **argv)
 	gboolean	success;
 	MrpTask        *root;
 	MrpRelation    *relation;
+	guint           id;
+	MrpResource    *resource;
+	MrpAssignment  *assignment;
+	gint            count;
 
         g_type_init ();
 
@@ -76,6 +92,11 @@ main (gint argc, gchar **argv)
 	/* Task2 is now critical, task1 not. */
 	CHECK_BOOLEAN_RESULT (critical, TRUE);
 
+	/* Task1 can slip until task2 finishes. */
+	CHECK_INTEGER_RESULT (mrp_task_get_total_slack (task1), 9*DAY);
+	CHECK_INTEGER_RESULT (mrp_task_get_free_slack (task1), 9*DAY);
+	CHECK_INTEGER_RESULT (mrp_task_get_total_slack (task2), 0);
+
 	/* Check that start and finish are calculated correctly. */
 	root = mrp_project_get_root_task (project);
 
@@ -217,6 +238,163 @@ main (gint argc, gchar **argv)
 	CHECK_INTEGER_RESULT (mrp_task_get_work (task2), 0);
 	CHECK_INTEGER_RESULT (mrp_task_get_duration (task2), 0);
 
+	/* Lookup by name and id. */
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "T3"), task3);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_id (project, mrp_object_get_id (MRP_OBJECT (task2))), task2);
+
+	/* Renaming a task moves it in the index. */
+	g_object_set (task3, "name", "T5", NULL);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "T3"), NULL);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "T5"), task3);
+
+	/* With duplicates we get the first one in traversal order. */
+	g_object_set (task1, "name", "T5", NULL);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "T5"), task1);
+
+	/* Removing task4 takes its subtree out of the index. */
+	id = mrp_object_get_id (MRP_OBJECT (task2));
+	mrp_project_remove_task (project, task4);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "T2"), NULL);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_id (project, id), NULL);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "T5"), task1);
+
+	/* Assignments are found from both ends. */
+	resource = g_object_new (MRP_TYPE_RESOURCE, "name", "R1", NULL);
+	mrp_project_add_resource (project, resource);
+	mrp_resource_assign (resource, task1, 100);
+
+	assignment = mrp_task_get_assignment (task1, resource);
+	CHECK_INTEGER_RESULT (mrp_task_get_nres (task1), 1);
+	CHECK_POINTER_RESULT (mrp_resource_get_assignment (resource, task1), assignment);
+	CHECK_POINTER_RESULT (mrp_assignment_get_resource (assignment), resource);
+
+	/* The cost rolls up to the project. */
+	g_object_set (resource, "cost", 36.0, NULL);
+	CHECK_INTEGER_RESULT ((gint) mrp_task_get_cost (task1), mrp_task_get_duration (task1) / 100);
+	CHECK_INTEGER_RESULT ((gint) mrp_project_get_cost (project), (gint) mrp_task_get_cost (task1));
+
+	mrp_object_removed (MRP_OBJECT (assignment));
+	CHECK_INTEGER_RESULT (mrp_task_get_nres (task1), 0);
+	CHECK_POINTER_RESULT (mrp_task_get_assignment (task1, resource), NULL);
+	CHECK_POINTER_RESULT (mrp_resource_get_assignment (resource, task1), NULL);
+	CHECK_INTEGER_RESULT ((gint) mrp_project_get_cost (project), 0);
+
+	/* Free slack only runs up to the successors, total slack up to the
+	 * project finish. A -> B is followed by nothing until C finishes, so
+	 * A can't slip without pushing B but both can slip together.
+	 */
+	project = mrp_project_new (app);
+	g_object_set (project, "project_start", project_start, NULL);
+
+	task1 = g_object_new (MRP_TYPE_TASK, "name", "A", "work", DAY, NULL);
+	task2 = g_object_new (MRP_TYPE_TASK, "name", "B", "work", DAY, NULL);
+	task3 = g_object_new (MRP_TYPE_TASK, "name", "C", "work", 10*DAY, NULL);
+
+	mrp_project_insert_task (project, NULL, -1, task1);
+	mrp_project_insert_task (project, NULL, -1, task2);
+	mrp_project_insert_task (project, NULL, -1, task3);
+
+	mrp_task_add_predecessor (task2, task1, MRP_RELATION_FS, 0, NULL);
+
+	CHECK_INTEGER_RESULT (mrp_task_get_total_slack (task1), 8*DAY);
+	CHECK_INTEGER_RESULT (mrp_task_get_free_slack (task1), 0);
+	CHECK_INTEGER_RESULT (mrp_task_get_total_slack (task2), 8*DAY);
+	CHECK_INTEGER_RESULT (mrp_task_get_free_slack (task2), 8*DAY);
+
+	/* Moving a task ahead of another with the same name changes which
+	 * one is found first.
+	 */
+	g_object_set (task3, "name", "A", NULL);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "A"), task1);
+
+	success = mrp_project_move_task (project, task3, task1,
+					 mrp_project_get_root_task (project),
+					 TRUE, NULL);
+	CHECK_BOOLEAN_RESULT (success, TRUE);
+	CHECK_POINTER_RESULT (mrp_project_get_task_by_name (project, "A"), task3);
+
+	/* Summary tasks sum up the costs of their children, and the project
+	 * tells when its total changes. One hour of a resource costing 36 an
+	 * hour is 36, a day is 8 hours.
+	 */
+	project = mrp_project_new (app);
+	g_object_set (project, "project_start", project_start, NULL);
+
+	task4 = g_object_new (MRP_TYPE_TASK, "name", "S", NULL);
+	task1 = g_object_new (MRP_TYPE_TASK, "name", "S1", "work", DAY, NULL);
+	task2 = g_object_new (MRP_TYPE_TASK, "name", "S2", "work", 2*DAY, NULL);
+
+	mrp_project_insert_task (project, NULL, -1, task4);
+	mrp_project_insert_task (project, task4, -1, task1);
+	mrp_project_insert_task (project, task4, -1, task2);
+
+	resource = g_object_new (MRP_TYPE_RESOURCE, "name", "R1", "cost", 36.0, NULL);
+	mrp_project_add_resource (project, resource);
+
+	count = 0;
+	g_signal_connect (project, "cost_changed",
+			  G_CALLBACK (cost_changed_cb),
+			  &count);
+
+	mrp_resource_assign (resource, task1, 100);
+	CHECK_BOOLEAN_RESULT (count > 0, TRUE);
+	CHECK_INTEGER_RESULT ((gint) mrp_task_get_cost (task4), 8*36);
+
+	count = 0;
+	mrp_resource_assign (resource, task2, 100);
+	CHECK_BOOLEAN_RESULT (count > 0, TRUE);
+	CHECK_INTEGER_RESULT ((gint) mrp_task_get_cost (task2), 16*36);
+	CHECK_INTEGER_RESULT ((gint) mrp_task_get_cost (task4), 24*36);
+	CHECK_INTEGER_RESULT ((gint) mrp_project_get_cost (project), 24*36);
+
+	/* Changing the rate back and forth must not leave anything behind. */
+	for (id = 0; id < 1000; id++) {
+		g_object_set (resource, "cost", 0.1, NULL);
+		g_object_set (resource, "cost", 36.0, NULL);
+	}
+	CHECK_BOOLEAN_RESULT (mrp_task_get_cost (task4) ==
+			      mrp_task_get_cost (task1) + mrp_task_get_cost (task2), TRUE);
+	CHECK_INTEGER_RESULT ((gint) mrp_project_get_cost (project), 24*36);
+
+	/* Nothing is signalled when the total stays the same. */
+	count = 0;
+	g_object_set (resource, "cost", 36.0, NULL);
+	CHECK_INTEGER_RESULT (count, 0);
+
+	count = 0;
+	assignment = mrp_task_get_assignment (task1, resource);
+	mrp_object_removed (MRP_OBJECT (assignment));
+	CHECK_BOOLEAN_RESULT (count > 0, TRUE);
+	CHECK_INTEGER_RESULT ((gint) mrp_task_get_cost (task4), 16*36);
+	CHECK_INTEGER_RESULT ((gint) mrp_project_get_cost (project), 16*36);
+
+	/* The typed setters notify, but only on a real change. */
+	count = 0;
+	g_signal_connect (task1, "notify::priority",
+			  G_CALLBACK (notify_cb),
+			  &count);
+
+	mrp_task_set_priority (task1, 5);
+	mrp_task_set_priority (task1, 5);
+	CHECK_INTEGER_RESULT (mrp_task_get_priority (task1), 5);
+	CHECK_INTEGER_RESULT (count, 1);
+
+	mrp_task_set_note (task1, "Note");
+	CHECK_STRING_RESULT (g_strdup (mrp_task_get_note (task1)), "Note");
+
+	/* Setting work reschedules the task. */
+	mrp_task_set_work (task2, 3*DAY);
+	CHECK_INTEGER_RESULT (mrp_task_get_work (task2), 3*DAY);
+	CHECK_INTEGER_RESULT (mrp_task_get_duration (task2), 3*DAY);
+
+	/* Summary tasks get their work from the children. */
+	mrp_task_set_work (task4, DAY);
+	CHECK_INTEGER_RESULT (mrp_task_get_work (task4), 4*DAY);
+
+	mrp_task_set_task_type (task1, MRP_TASK_TYPE_MILESTONE);
+	CHECK_INTEGER_RESULT (mrp_task_get_work (task1), 0);
+	CHECK_INTEGER_RESULT (mrp_task_get_duration (task1), 0);
+
 	/* More tests needed... */
 
 
@@ -0,0 +1,121 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*- */
+#include <config.h>
+#include <stdlib.h>
+#include "libplanner/mrp-project.h"
+#include "src/planner-text-cache.h"
+#include "self-check.h"
+
+/* Stands in for a gantt row, which connects to the resource before the
+ * label is ever looked up and reads it back from its notify handler.
+ */
+static void
+resource_name_changed (MrpResource *resource,
+		       GParamSpec  *pspec,
+		       gchar      **label)
+{
+	g_free (*label);
+	*label = g_strdup (planner_text_cache_get_resource_label (resource));
+}
+
+static void
+check_pixel_size (gint *argc, gchar ***argv)
+{
+	GtkWidget   *widget;
+	PangoLayout *layout;
+	gint         width, height;
+	gint         cached_width, cached_height;
+	gint         short_width;
+
+	/* Measuring needs a screen. */
+	if (!gtk_init_check (argc, argv)) {
+		g_print ("No display, skipping the pixel size checks\n");
+		return;
+	}
+
+	widget = gtk_label_new (NULL);
+	g_object_ref_sink (widget);
+
+	layout = gtk_widget_create_pango_layout (widget, "Anna, Bertil");
+	pango_layout_get_pixel_size (layout, &width, &height);
+	g_object_unref (layout);
+
+	/* The first call measures, the second one comes from the cache, both
+	 * must match what Pango says.
+	 */
+	planner_text_cache_get_pixel_size (widget, "Anna, Bertil",
+					   &cached_width, &cached_height);
+	CHECK_INTEGER_RESULT (cached_width, width);
+	CHECK_INTEGER_RESULT (cached_height, height);
+
+	cached_width = cached_height = 0;
+	planner_text_cache_get_pixel_size (widget, "Anna, Bertil",
+					   &cached_width, &cached_height);
+	CHECK_INTEGER_RESULT (cached_width, width);
+	CHECK_INTEGER_RESULT (cached_height, height);
+
+	/* Either size may be skipped. */
+	planner_text_cache_get_pixel_size (widget, "Anna", &short_width, NULL);
+	CHECK_BOOLEAN_RESULT (short_width > 0 && short_width < width, TRUE);
+
+	planner_text_cache_get_pixel_size (widget, NULL, &width, NULL);
+	CHECK_INTEGER_RESULT (width, 0);
+
+	g_object_unref (widget);
+}
+
+gint
+main (gint argc, gchar **argv)
+{
+	MrpApplication *app;
+	MrpProject     *project;
+	MrpResource    *resource;
+	MrpTask        *task;
+	gchar          *label = NULL;
+
+	g_type_init ();
+
+	app = mrp_application_new ();
+	project = mrp_project_new (app);
+
+	task = g_object_new (MRP_TYPE_TASK, "name", "T1", NULL);
+	mrp_project_insert_task (project, NULL, -1, task);
+
+	resource = g_object_new (MRP_TYPE_RESOURCE, "name", "Anna", NULL);
+	mrp_project_add_resource (project, resource);
+	mrp_resource_assign (resource, task, 100);
+
+	/* Like the gantt row, watch the resource before connecting. */
+	planner_text_cache_watch_resource (resource);
+
+	g_signal_connect (resource, "notify::name",
+			  G_CALLBACK (resource_name_changed), &label);
+	g_signal_connect (resource, "notify::short-name",
+			  G_CALLBACK (resource_name_changed), &label);
+
+	CHECK_STRING_RESULT (g_strdup (planner_text_cache_get_resource_label (resource)), "Anna");
+
+	/* Renaming an assigned resource shows up in handlers that were
+	 * connected before the label was cached.
+	 */
+	g_object_set (resource, "name", "Bertil", NULL);
+	CHECK_STRING_RESULT (g_strdup (label), "Bertil");
+	CHECK_STRING_RESULT (g_strdup (planner_text_cache_get_resource_label (resource)), "Bertil");
+
+	/* The short name wins over the name, and the name is used again
+	 * when it is cleared.
+	 */
+	g_object_set (resource, "short_name", "B", NULL);
+	CHECK_STRING_RESULT (g_strdup (label), "B");
+
+	g_object_set (resource, "short_name", "", NULL);
+	CHECK_STRING_RESULT (g_strdup (label), "Bertil");
+
+	g_free (label);
+
+	check_pixel_size (&argc, &argv);
+
+	g_object_unref (project);
+	g_object_unref (app);
+
+	return EXIT_SUCCESS;
+}
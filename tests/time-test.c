@@ -12,10 +12,73 @@ STRING (mrptime time)
  	return mrp_time_to_string (time);
 }
 
+/* The MrpTime functions go through GDate, use them as a reference for the
+ * arithmetic mrptime versions.
+ */
+static mrptime
+reference_align (MrpTime *t2, mrptime t, MrpTimeUnit unit, gboolean next)
+{
+	mrp_time2_set_epoch (t2, t);
+
+	if (next) {
+		mrp_time2_align_next (t2, unit);
+	} else {
+		mrp_time2_align_prev (t2, unit);
+	}
+
+	return mrp_time2_get_epoch (t2);
+}
+
+static void
+check_alignment (void)
+{
+	MrpTime     *t2;
+	mrptime      t;
+	glong        day, n_days;
+	MrpTimeUnit  unit;
+	GDate        date;
+	gint         year, month, mday;
+
+	t2 = mrp_time2_new ();
+	g_date_clear (&date, 1);
+
+	/* One full 400 year cycle, or as much of it as fits. */
+	n_days = 146097;
+	if (sizeof (mrptime) < 8) {
+		n_days = MRP_TIME_MAX / (60*60*24) - 400;
+	}
+
+	for (day = 0; day < n_days; day++) {
+		t = day * 60*60*24 + (day * 7919) % (60*60*24);
+
+		CHECK_INTEGER_RESULT (mrp_time_align_day (t),
+				      reference_align (t2, t, MRP_TIME_UNIT_DAY, FALSE));
+
+		mrp_time2_set_epoch (t2, t);
+		mrp_time2_get_date (t2, &year, &month, &mday);
+		g_date_set_dmy (&date, mday, month, year);
+		CHECK_INTEGER_RESULT (mrp_time_day_of_week (t),
+				      g_date_get_weekday (&date) % 7);
+
+		for (unit = MRP_TIME_UNIT_YEAR; unit <= MRP_TIME_UNIT_HOUR; unit++) {
+			CHECK_INTEGER_RESULT (mrp_time_align_prev (t, unit),
+					      reference_align (t2, t, unit, FALSE));
+			CHECK_INTEGER_RESULT (mrp_time_align_next (t, unit),
+					      reference_align (t2, t, unit, TRUE));
+		}
+	}
+
+	mrp_time2_free (t2);
+}
+
 gint
 main (gint argc, gchar **argv)
 {
-	mrptime t;
+	mrptime        t;
+	gint           year, month, day, hour, minute, second;
+	struct tm      tm;
+	MrpTimeFormat *format;
+	gchar          buf[32];
 
 	setlocale (LC_ALL, "");
 
@@ -27,6 +90,41 @@ main (gint argc, gchar **argv)
 	CHECK_STRING_RESULT (STRING (mrp_time_from_string ("19991231", NULL)), "19991231T000000Z");
 	CHECK_STRING_RESULT (STRING (mrp_time_from_string ("invalid", NULL)), "19700101T000000Z");
 
+	CHECK_STRING_RESULT (STRING (mrp_time_from_string ("20020329T101112", NULL)), "20020329T101112Z");
+	CHECK_STRING_RESULT (STRING (mrp_time_from_string ("20020329T101112Z", NULL)), "20020329T101112Z");
+	CHECK_INTEGER_RESULT (mrp_time_from_string ("20021329", NULL), 0);
+	CHECK_INTEGER_RESULT (mrp_time_from_string ("20020329T1011", NULL), 0);
+	CHECK_INTEGER_RESULT (mrp_time_from_string ("20020329T101112Zx", NULL), 0);
+
+	/* struct tm fields are UTC and may overflow, like timegm(). */
+	memset (&tm, 0, sizeof (tm));
+	tm.tm_year = 2002 - 1900;
+	tm.tm_mon = 13;
+	tm.tm_mday = 0;
+	tm.tm_hour = 25;
+	CHECK_INTEGER_RESULT (mrp_time_from_tm (&tm), mrp_time_compose (2003, 2, 1, 1, 0, 0));
+
+	/* Compiled formats truncate like snprintf(). */
+	format = mrp_time_format_new ("%Y-%m-%d %H:%M:%S");
+	CHECK_INTEGER_RESULT (mrp_time_format_render (format, mrp_time_compose (2002, 3, 1, 9, 5, 0), buf, sizeof (buf)), 19);
+	CHECK_STRING_RESULT (g_strdup (buf), "2002-03-01 09:05:00");
+	CHECK_INTEGER_RESULT (mrp_time_format_render (format, 0, buf, 5), 19);
+	CHECK_STRING_RESULT (g_strdup (buf), "1970");
+	mrp_time_format_free (format);
+
+	/* Known weekdays. */
+	CHECK_INTEGER_RESULT (mrp_time_day_of_week (0), 4);
+	CHECK_INTEGER_RESULT (mrp_time_day_of_week (mrp_time_compose (2002, 3, 31, 23, 59, 59)), 0);
+
+	mrp_time_decompose (mrp_time_compose (2000, 2, 29, 13, 14, 15),
+			    &year, &month, &day, &hour, &minute, &second);
+	CHECK_INTEGER_RESULT (year, 2000);
+	CHECK_INTEGER_RESULT (month, 2);
+	CHECK_INTEGER_RESULT (day, 29);
+	CHECK_INTEGER_RESULT (hour * 3600 + minute * 60 + second, 13 * 3600 + 14 * 60 + 15);
+
+	check_alignment ();
+
 	return EXIT_SUCCESS;
 }
 